@@ -1,3 +1,5 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_COMPILER
+
 #if _WIN32
 #   pragma warning(disable: 4996)
 #endif
@@ -7,6 +9,7 @@
 #include <baranium/compiler/language/function_token.h>
 #include <baranium/compiler/language/if_else_token.h>
 #include <baranium/compiler/binaries/compiler.h>
+#include <baranium/compiler/binaries/aot.h>
 #include <baranium/compiler/language/token.h>
 #include <baranium/compiler/preprocessor.h>
 #include <baranium/compiler/token_parser.h>
@@ -169,6 +172,7 @@ int main(const int argc, const char** argv)
     argument_parser_add(&parser, ARGUMENT_TYPE_FLAG, "-d", "--debug");
     argument_parser_add(&parser, ARGUMENT_TYPE_FLAG, "-v", "--version");
     argument_parser_add(&parser, ARGUMENT_TYPE_FLAG, "-e", "--export");
+    argument_parser_add(&parser, ARGUMENT_TYPE_FLAG, "-n", "--native");
     argument_parser_add(&parser, ARGUMENT_TYPE_VALUE, "-l", "--link");
     argument_parser_add(&parser, ARGUMENT_TYPE_VALUE, "-o", "--output");
     argument_parser_add(&parser, ARGUMENT_TYPE_VALUE, "-i", "--include");
@@ -314,6 +318,15 @@ int main(const int argc, const char** argv)
     baranium_compiler_context_compile(context, output, is_library);
     baranium_compiler_context_dispose(context);
 
+    // native code is generated from the written library, so it always matches the bytecode
+    if (argument_parser_has(&parser, "-n"))
+    {
+        if (is_library)
+            baranium_aot_compile_library(output, stringf("%s.c", output));
+        else
+            LOGWARNING("Native code can only be generated for libraries, compile with -e");
+    }
+
     argument_parser_dispose(&parser);
     fclose(logOutput);
 
@@ -327,6 +340,7 @@ void print_usage(void)
     printf("\t-o <path>\tSpecify output file\n");
     printf("\t-h\t\tShow this help message\n");
     printf("\t-e\tCompile as a library\n");
+    printf("\t-n\tAlso write the functions of a library as C code to `<output>.c`, build it into the dynamic library of the library\n");
     printf("\t-l <name>\tLink against a library named `name`\n");
     printf("\t-i <path>\tSpecify a custom user include directory\n");
     printf("\t-I <file>\tSpecify file containing all custom user include directories\n");
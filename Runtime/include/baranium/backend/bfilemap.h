@@ -0,0 +1,59 @@
+/**
+ * @note THIS IS NOT INTENDED FOR USE BY THE USER OF THE RUNTIME!
+ *       This header is intended to be used internally by the runtime
+ *       and therefore, functions defined in this header cannot be used
+ *       by the user.
+ */
+#ifndef __BARANIUM__BACKEND__BFILEMAP_H_
+#define __BARANIUM__BACKEND__BFILEMAP_H_ 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+// read only image of a whole file, mapped where the platform supports it and read into memory otherwise
+typedef struct bfilemap
+{
+    const uint8_t* data;
+    size_t size;
+    uint8_t mapped;     // 1 if data is a mapping of the file, 0 if it was read into an allocation
+} bfilemap;
+
+// map the whole file, returns 0 if the file could neither be mapped nor read
+uint8_t bfilemap_open(bfilemap* map, FILE* file);
+
+// unmap or free the image, pointers into it are invalid afterwards
+void bfilemap_close(bfilemap* map);
+
+// copy size bytes at offset out of the image and advance offset, returns 0 if they are past the end
+static inline uint8_t bfilemap_read(const bfilemap* map, size_t* offset, void* out, size_t size)
+{
+    if (size > map->size || *offset > map->size - size)
+        return 0;
+
+    memcpy(out, map->data + *offset, size);
+    *offset += size;
+    return 1;
+}
+
+// get a pointer to size bytes at offset inside the image and advance offset, NULL if they are past the end
+static inline const uint8_t* bfilemap_view(const bfilemap* map, size_t* offset, size_t size)
+{
+    if (size > map->size || *offset > map->size - size)
+        return NULL;
+
+    const uint8_t* view = map->data + *offset;
+    *offset += size;
+    return view;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
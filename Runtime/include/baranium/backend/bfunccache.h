@@ -0,0 +1,96 @@
+/**
+ * @note THIS IS NOT INTENDED FOR USE BY THE USER OF THE RUNTIME!
+ *       This header is intended to be used internally by the runtime
+ *       and therefore, functions defined in this header cannot be used
+ *       by the user.
+ */
+#ifndef __BARANIUM__BACKEND__BFUNCCACHE_H_
+#define __BARANIUM__BACKEND__BFUNCCACHE_H_ 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <baranium/callback.h>
+#include <baranium/function.h>
+
+// initial number of buckets of the cache, always a power of two
+#define BARANIUM_FUNCTION_CACHE_INITIAL_CAPACITY 0x20
+
+// marks an empty bucket of the hash index
+#define BARANIUM_FUNCTION_CACHE_NO_SLOT ((size_t)-1)
+
+// bytes the decoded code of cached functions may take up before the least recently used ones are dropped, 0 for no limit
+#ifndef BARANIUM_CODE_BUDGET
+#   define BARANIUM_CODE_BUDGET 0
+#endif
+
+// call target of an id, a slot keeps its id and index once it is created and is unresolved while function and callback are NULL
+typedef struct
+{
+    index_t id;
+    baranium_function* function;            // owned by the cache, NULL if the target is a callback
+    baranium_callback_list_entry* callback; // owned by the callback list, NULL if the target is a function
+    size_t size;                            // bytes taken up by the decoded code of the function
+    uint64_t used;                          // clock of the cache when the target was last called
+} baranium_function_cache_entry;
+
+typedef struct baranium_function_cache
+{
+    size_t* buckets;                        // slot indices, hashed by the ids of the slots
+    size_t capacity;
+    baranium_function_cache_entry* slots;   // dense table of every id that was called or linked, code calls functions by index into it
+    size_t slot_count;
+    size_t slot_capacity;
+    size_t count;                           // number of resolved slots
+    size_t budget;                          // see BARANIUM_CODE_BUDGET
+    size_t code_size;                       // bytes taken up by the decoded code of every cached function
+    uint64_t clock;                         // counts calls, orders the slots from least to most recently used
+    uint64_t hits;                          // calls of targets that were already cached
+    uint64_t misses;                        // functions that had to be loaded
+    uint64_t evictions;                     // functions that were dropped to stay within the budget
+} baranium_function_cache;
+
+// create and initialize a function cache
+baranium_function_cache* baranium_function_cache_init(void);
+
+// dispose a function cache and every function loaded into it
+void baranium_function_cache_dispose(baranium_function_cache* obj);
+
+// drop every cached target, the slots stay linked
+void baranium_function_cache_clear(baranium_function_cache* obj);
+
+// get the call target of an id, resolves and loads it on the first call
+baranium_function_cache_entry* baranium_function_cache_get(baranium_function_cache* obj, index_t id);
+
+// get the slot index of an id, the slot is created unresolved if needed, BARANIUM_FUNCTION_CACHE_NO_SLOT if out of memory
+size_t baranium_function_cache_link(baranium_function_cache* obj, index_t id);
+
+// resolve and load the target of a slot, NULL if the id has neither a callback nor a function
+baranium_function_cache_entry* baranium_function_cache_resolve(baranium_function_cache* obj, size_t slot);
+
+// get the call target of a linked slot, resolves and loads it on the first call
+static inline baranium_function_cache_entry* baranium_function_cache_get_slot(baranium_function_cache* obj, size_t slot)
+{
+    baranium_function_cache_entry* entry = &obj->slots[slot];
+    if (entry->function != NULL || entry->callback != NULL)
+    {
+        entry->used = ++obj->clock;
+        obj->hits++;
+        return entry;
+    }
+
+    return baranium_function_cache_resolve(obj, slot);
+}
+
+// limit the memory of decoded code, functions that aren't running are dropped least recently used first until it fits
+void baranium_function_cache_set_budget(baranium_function_cache* obj, size_t budget);
+
+// drop the cached target of an id, has to be called whenever the target of the id may change
+void baranium_function_cache_remove(baranium_function_cache* obj, index_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -16,7 +16,11 @@ extern "C" {
 #include <baranium/script.h>
 #include <stdbool.h>
 
-#define BARANIUM_FUNCTION_MANAGER_BUFFER_SIZE 0x20
+// number of entries carved out of a single slab
+#define BARANIUM_FUNCTION_MANAGER_SLAB_SIZE 0x40
+
+// initial number of buckets of the hash index, always a power of two
+#define BARANIUM_FUNCTION_MANAGER_INITIAL_CAPACITY 0x20
 
 typedef struct
 {
@@ -25,11 +29,34 @@ typedef struct
     baranium_library* library;
 } baranium_function_manager_entry;
 
+// bucket of the hash index, the bucket is empty if id is BARANIUM_INVALID_INDEX
+typedef struct
+{
+    index_t id;
+    baranium_function_manager_entry* entry;
+} baranium_function_manager_bucket;
+
+// storage of a single entry, unused storage is chained into the free list
+typedef union baranium_function_manager_storage
+{
+    baranium_function_manager_entry entry;
+    union baranium_function_manager_storage* next_free;
+} baranium_function_manager_storage;
+
+// block of entries, slabs are never moved or freed before the manager is disposed
+typedef struct baranium_function_manager_slab
+{
+    struct baranium_function_manager_slab* next;
+    baranium_function_manager_storage storage[BARANIUM_FUNCTION_MANAGER_SLAB_SIZE];
+} baranium_function_manager_slab;
+
 typedef struct baranium_function_manager
 {
-    baranium_function_manager_entry* buffer;
-    size_t buffer_size;
+    baranium_function_manager_bucket* buckets;
+    size_t capacity;
     size_t count;
+    baranium_function_manager_slab* slabs;
+    baranium_function_manager_storage* free_list;
 } baranium_function_manager;
 
 // create and initialize a function manager
@@ -47,12 +74,9 @@ void baranium_function_manager_add(baranium_function_manager* obj, index_t id, b
 // get a function if existent
 baranium_function* baranium_function_manager_get(baranium_function_manager* obj, index_t id);
 
-// get a function entry if existent
+// get a function entry if existent, the entry stays in place until it gets removed
 baranium_function_manager_entry* baranium_function_manager_get_entry(baranium_function_manager* obj, index_t id);
 
-// get a function entry index if existent
-int baranium_function_manager_get_entry_index(baranium_function_manager* obj, index_t id);
-
 // delete and free memory used by a function entry
 void baranium_function_manager_remove(baranium_function_manager* obj, index_t id);
 
@@ -0,0 +1,78 @@
+/**
+ * @note THIS IS NOT INTENDED FOR USE BY THE USER OF THE RUNTIME!
+ *       This header is intended to be used internally by the runtime
+ *       and therefore, functions defined in this header cannot be used
+ *       by the user.
+ */
+#ifndef __BARANIUM__BACKEND__BIDHASH_H_
+#define __BARANIUM__BACKEND__BIDHASH_H_ 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <baranium/defines.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// open addressing with linear probing over bucket arrays keyed by ids, the capacity is always a power of two,
+// every table of the runtime that is indexed by id and the name table of indexed binaries probe the same way,
+// so changing the probe sequence breaks reading binaries that were written before
+
+// gets the id held by a bucket of a table, BARANIUM_INVALID_INDEX if the bucket is empty
+typedef index_t(*bidhash_id_of)(const void* table, size_t bucket);
+
+// moves the content of a bucket of a table into another bucket and leaves the first one empty
+typedef void(*bidhash_move)(void* table, size_t from, size_t to);
+
+// bucket the probe sequence of an id starts at,
+// ids already are hashes of names, mixing them again keeps sequential ids from clustering
+static inline size_t bidhash_home(index_t id, size_t capacity)
+{
+    uint64_t hash = (uint64_t)id * 0x9E3779B97F4A7C15ull;
+    return (size_t)(hash ^ (hash >> 32)) & (capacity - 1);
+}
+
+// bucket that follows another one in a probe sequence
+static inline size_t bidhash_next(size_t bucket, size_t capacity)
+{
+    return (bucket + 1) & (capacity - 1);
+}
+
+// finds the bucket of an id, or the empty bucket the id would go into, see `bidhash_grown_capacity`
+static inline size_t bidhash_find(const void* table, size_t capacity, index_t id, bidhash_id_of id_of)
+{
+    size_t bucket = bidhash_home(id, capacity);
+    for (index_t held = id_of(table, bucket); held != BARANIUM_INVALID_INDEX && held != id; held = id_of(table, bucket))
+        bucket = bidhash_next(bucket, capacity);
+
+    return bucket;
+}
+
+// capacity a table of `count` ids needs to take another one, the load factor stays at or below 3/4
+// so probe sequences stay short and always end at an empty bucket, the current capacity if it's enough
+static inline size_t bidhash_grown_capacity(size_t count, size_t capacity)
+{
+    return (count + 1) * 4 > capacity * 3 ? capacity * 2 : capacity;
+}
+
+// the bucket `hole` was just emptied, shifts the following buckets of its probe sequence back so lookups never stop at it
+static inline void bidhash_close_hole(void* table, size_t capacity, size_t hole, bidhash_id_of id_of, bidhash_move move)
+{
+    size_t mask = capacity - 1;
+    for (size_t bucket = bidhash_next(hole, capacity); id_of(table, bucket) != BARANIUM_INVALID_INDEX; bucket = bidhash_next(bucket, capacity))
+    {
+        size_t home = bidhash_home(id_of(table, bucket), capacity);
+        if (((bucket - home) & mask) < ((bucket - hole) & mask))
+            continue;
+
+        move(table, bucket, hole);
+        hole = bucket;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
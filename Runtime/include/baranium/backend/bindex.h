@@ -0,0 +1,51 @@
+/**
+ * @note THIS IS NOT INTENDED FOR USE BY THE USER OF THE RUNTIME!
+ *       This header is intended to be used internally by the runtime
+ *       and therefore, functions defined in this header cannot be used
+ *       by the user.
+ */
+#ifndef __BARANIUM__BACKEND__BINDEX_H_
+#define __BARANIUM__BACKEND__BINDEX_H_ 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <baranium/backend/bfilemap.h>
+#include <baranium/backend/bidhash.h>
+#include <baranium/defines.h>
+#include <baranium/script.h>
+
+// alignment of the tables and section data of indexed binaries
+#define BINDEX_ALIGNMENT 8
+
+// check that every table of an index lies inside the image and is aligned, returns 0 if the binary is broken
+uint8_t bindex_validate(const bfilemap* image, const baranium_binary_index* index, uint64_t section_count);
+
+// get the directory of a validated index
+static inline const baranium_binary_section_entry* bindex_directory(const bfilemap* image, const baranium_binary_index* index)
+{
+    return (const baranium_binary_section_entry*)(image->data + index->directory_offset);
+}
+
+// read a section of a binary, from the directory of a validated index or from the section stream at offset if index is NULL,
+// data of fields and variables points into the image, returns 0 if the section lies outside of the image
+uint8_t bindex_read_section(const bfilemap* image, const baranium_binary_index* index, uint64_t i, size_t* offset, baranium_script_section* section);
+
+// look up the id of a name in the name table of a validated index, BARANIUM_INVALID_INDEX if the binary has no such name
+index_t bindex_find_name(const bfilemap* image, const baranium_binary_index* index, const char* name);
+
+// look up the name of an id in the name table of a validated index, NULL if the binary has no such id
+const char* bindex_name_of(const bfilemap* image, const baranium_binary_index* index, index_t id);
+
+// sort sections by id, binaries older than BARANIUM_VERSION_INDEXED_FORMAT store them in source order
+void bindex_sort_sections(baranium_script_section* sections, uint64_t count);
+
+// binary search sections sorted by id, any type matches BARANIUM_SCRIPT_SECTION_TYPE_INVALID, NULL if not present
+baranium_script_section* bindex_find_section(baranium_script_section* sections, uint64_t count, index_t id, baranium_script_section_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
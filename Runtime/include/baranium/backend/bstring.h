@@ -0,0 +1,80 @@
+/**
+ * @note THIS IS NOT INTENDED FOR USE BY THE USER OF THE RUNTIME!
+ *       This header is intended to be used internally by the runtime
+ *       and therefore, functions defined in this header cannot be used
+ *       by the user.
+ */
+#ifndef __BARANIUM__BACKEND__BSTRING_H_
+#define __BARANIUM__BACKEND__BSTRING_H_ 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <baranium/defines.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+// reference count of strings that are never freed
+#define BSTRING_IMMORTAL UINT32_MAX
+
+// header in front of the characters of a runtime string, a string is passed around as a pointer to its characters
+typedef struct bstring_header
+{
+    uint32_t refcount;  // number of owners, BSTRING_IMMORTAL for preallocated strings
+    uint32_t length;    // number of characters without the terminating zero
+} bstring_header;
+
+#define BSTRING_HEADER(str) ((bstring_header*)((char*)(str) - sizeof(bstring_header)))
+
+// create a string with a reference count of one, `data` may be NULL for a zero filled string of the given length
+// empty and single character strings are preallocated and never allocate
+BARANIUMAPI char* bstring_create(const char* data, size_t length);
+
+// create a string with a reference count of one and room for `length` characters, the caller fills them in before sharing it
+BARANIUMAPI char* bstring_alloc(size_t length);
+
+// append characters to a string, consumes the reference to `str` and returns the resulting string
+// the characters are appended in place if `str` has no other owners, on failure NULL is returned and `str` is left untouched
+BARANIUMAPI char* bstring_append(char* str, const char* data, size_t length);
+
+// create a string out of two character ranges
+BARANIUMAPI char* bstring_join(const char* lhs, size_t lhsLength, const char* rhs, size_t rhsLength);
+
+// free a string, only called once the last reference is released
+BARANIUMAPI void bstring_free(char* str);
+
+// take another reference to a string
+static inline char* bstring_retain(char* str)
+{
+    if (str != NULL && BSTRING_HEADER(str)->refcount != BSTRING_IMMORTAL)
+        BSTRING_HEADER(str)->refcount++;
+
+    return str;
+}
+
+// drop a reference to a string, the string is freed together with its last reference
+static inline void bstring_release(char* str)
+{
+    if (str == NULL || BSTRING_HEADER(str)->refcount == BSTRING_IMMORTAL)
+        return;
+
+    if (--BSTRING_HEADER(str)->refcount == 0)
+        bstring_free(str);
+}
+
+// number of characters of a string without the terminating zero
+static inline size_t bstring_length(const char* str)
+{
+    if (str == NULL)
+        return 0;
+
+    return BSTRING_HEADER(str)->length;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -14,20 +14,49 @@ extern "C" {
 #include "../variable.h"
 #include "../field.h"
 
+// number of variables/fields carved out of a single slab
+#define BVARMGR_SLAB_SIZE 0x40
+
+// initial number of buckets of the hash index, always a power of two
+#define BVARMGR_INITIAL_CAPACITY 0x20
+
+// marks an empty bucket of the hash index
+#define BVARMGR_NO_SLOT ((size_t)-1)
+
+// slot of a variable/field, a slot keeps its id and index once it is created and is empty while variable and field are NULL
 typedef struct bvarmgr_n
 {
-    struct bvarmgr_n* prev;
+    index_t id;
     baranium_variable* variable;
     baranium_field* field;
     uint8_t isVariable;
-    struct bvarmgr_n* next;
 } bvarmgr_n;
 
+// storage of a single variable/field, unused storage is chained into the free list
+typedef union bvarmgr_storage
+{
+    baranium_variable variable;
+    baranium_field field;
+    union bvarmgr_storage* next_free;
+} bvarmgr_storage;
+
+// block of storage, slabs are never moved or freed before the manager is disposed
+typedef struct bvarmgr_slab
+{
+    struct bvarmgr_slab* next;
+    bvarmgr_storage storage[BVARMGR_SLAB_SIZE];
+} bvarmgr_slab;
+
 typedef struct bvarmgr
 {
-    bvarmgr_n* start;
-    bvarmgr_n* end;
-    size_t count;
+    size_t* buckets;            // slot indices, hashed by the ids of the slots
+    size_t capacity;
+    bvarmgr_n* slots;           // dense table of every id that was allocated or linked, code refers to globals by index into it
+    size_t slot_count;
+    size_t slot_capacity;
+    size_t count;               // number of slots that hold a variable/field
+    bvarmgr_slab* slabs;
+    bvarmgr_storage* free_list;
 } bvarmgr;
 
 // create and initialize a variable manager
@@ -42,9 +71,23 @@ void bvarmgr_clear(bvarmgr* obj);
 // allocate/create a variable
 void bvarmgr_alloc(bvarmgr* obj, baranium_variable_type_t type, index_t id, size_t size, uint8_t isField);
 
-// get a created entry if existent
+// get a created entry if existent, the entry is only valid until a new id gets allocated/linked
+// but the variable/field it points to stays in place until it gets deallocated
 bvarmgr_n* bvarmgr_get(bvarmgr* obj, index_t id);
 
+// get the slot index of an id, the slot is created empty if the id was never allocated, BVARMGR_NO_SLOT if out of memory
+size_t bvarmgr_link(bvarmgr* obj, index_t id);
+
+// get the entry of a linked slot if it holds a variable/field
+static inline bvarmgr_n* bvarmgr_get_slot(bvarmgr* obj, size_t slot)
+{
+    bvarmgr_n* entry = &obj->slots[slot];
+    if (entry->variable == NULL && entry->field == NULL)
+        return NULL;
+
+    return entry;
+}
+
 // delete and free memory used by a variable
 void bvarmgr_dealloc(bvarmgr* obj, index_t id);
 
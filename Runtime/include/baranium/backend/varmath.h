@@ -53,13 +53,21 @@ BARANIUMAPI baranium_compiled_variable* baranium_compiled_variable_pop_from_stac
 BARANIUMAPI void baranium_compiled_variable_pop_from_stack_into_variable(struct bcpu* cpu, baranium_compiled_variable* output);
 
 /**
- * @brief Push a compiled variable to the cpu stack
+ * @brief Push a compiled variable to the cpu stack, strings are copied into a new runtime string
  * 
  * @param cpu CPU
  * @param var Compiled variable
  */
 BARANIUMAPI void baranium_compiled_variable_push_to_stack(struct bcpu* cpu, baranium_compiled_variable* var);
 
+/**
+ * @brief Push a compiled variable to the cpu stack, strings have to be runtime strings and are shared instead of copied
+ * 
+ * @param cpu CPU
+ * @param var Compiled variable
+ */
+BARANIUMAPI void baranium_compiled_variable_push_reference_to_stack(struct bcpu* cpu, baranium_compiled_variable* var);
+
 /**
  * @brief Disposes the created compiled variable object
  * 
@@ -16,29 +16,40 @@ extern "C" {
 #include <baranium/cpu/bbus.h>
 #include <stdint.h>
 
+// number of calling functions the cpu makes room for on the first call
+#define BCPU_INITIAL_FRAME_CAPACITY 0x20
+
 typedef struct{
     uint8_t CMP: 1;             // comparisons enable
     uint8_t FORCED_KILL : 1;    // cpu termination has been forced and an error code pushed to the stack
     uint8_t RESERVED: 6;        // reserved
 } bcpu_flags;
 
-struct bcpu;
-typedef uint64_t(*bcpu_fetch_t)(struct bcpu* obj, int bits);
+// state of a function that called into another function and continues once the callee returns
+typedef struct bcpu_frame
+{
+    baranium_function* function;    // the calling function
+    uint64_t ip;                    // instruction to continue at in the calling function
+    size_t frame;                   // index of the first local slot of the calling function
+} bcpu_frame;
 
 typedef struct bcpu
 {
-    uint64_t ip;            // Instruction Pointer (Program Counter)
+    uint64_t ip;            // Instruction Pointer (Program Counter), index into the decoded code
     bstack* stack;          // Stack for the cpu to store data temporarily
-    bstack* ip_stack;       // Instruction pointer stack for the cpu to store data temporarily
+    bstack* locals;         // Slots of the locals of all functions that are currently executed
+    size_t frame;           // Index of the first local slot of the function that is currently executed
+    bcpu_frame* frames;     // Calling functions, calls inside of scripts don't recurse through C
+    size_t frame_count;     // Number of calling functions
+    size_t frame_capacity;  // Number of calling functions that fit without growing
+    size_t frame_base;      // Number of calling functions when the runtime was called into, RET ends the run below that
     bcpu_flags flags;       // Flags
     uint8_t opcode;         // operation code/instruction
     uint64_t ticks;         // total number of ticks the cpu has executed
     uint8_t kill_triggered;  // Only set if execution has ended or has been triggered and the application should quit
     uint8_t cv;             // compare value
-    bbus* bus;              // the bus to read data from
+    bbus* bus;              // the bus holding the function that is currently executed
 
-    uint64_t fetched;
-    bcpu_fetch_t fetch;
     baranium_runtime* runtime;
 } bcpu;
 
@@ -48,13 +59,21 @@ bcpu* bcpu_init(baranium_runtime* runtime);
 // dispose and clean any used memory by the cpu
 void bcpu_dispose(bcpu* obj);
 
-// this is the method which executes the instructions from the IP value forward
-// some instructions can take multiple calls to this function to execute properly
-void bcpu_tick(bcpu* obj);
+// runs the function attached to the bus until it returns or the cpu gets killed
+void bcpu_run(bcpu* obj);
 
 // resets the cpu
 void bcpu_reset(bcpu* obj);
 
+// saves the state of the current function before calling another function, returns 0 if out of memory
+uint8_t bcpu_push_frame(bcpu* obj);
+
+// drops the locals of the current function and continues with the calling function
+void bcpu_pop_frame(bcpu* obj);
+
+// starts executing a function from the beginning
+void bcpu_enter_function(bcpu* obj, baranium_function* function);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,8 @@ extern "C" {
 #endif
 
 #include <baranium/backend/dynlibloader.h>
+#include <baranium/backend/bstring.h>
+#include <baranium/backend/varmath.h>
 #include <baranium/variable.h>
 #include <baranium/defines.h>
 
@@ -40,7 +42,7 @@ extern "C" {
         size_t dataSize = baranium_variable_get_size_of_type(datatypes[count-1-param_index]); \
         name = (baranium_compiled_variable){.type=datatypes[count-1-param_index], .value=dataptr[count-1-param_index], .size=dataSize}; \
         if (dataSize == (size_t)-1) \
-            name.size = strlen((const char*)dataptr[count-1-param_index].ptr); \
+            name.size = bstring_length((const char*)dataptr[count-1-param_index].ptr); \
         baranium_compiled_variable_convert_to_type(&name, target_type); \
         dataptr[count-1-param_index] = name.value; \
         datatypes[count-1-param_index] = name.type; \
@@ -54,7 +56,7 @@ extern "C" {
         size_t dataSize = baranium_variable_get_size_of_type(datatypes[count-1-param_index]); \
         variable_##name = (baranium_compiled_variable){.type=datatypes[count-1-param_index], .value=dataptr[count-1-param_index], .size=dataSize}; \
         if (dataSize == (size_t)-1) \
-            variable_##name.size = strlen((const char*)dataptr[count-1-param_index].ptr); \
+            variable_##name.size = bstring_length((const char*)dataptr[count-1-param_index].ptr); \
         baranium_compiled_variable_convert_to_type(&variable_##name, target_type); \
         dataptr[count-1-param_index] = variable_##name.value; \
         datatypes[count-1-param_index] = variable_##name.type; \
@@ -68,6 +70,17 @@ extern "C" {
 
 #define BARANIUM_CALLBACK_RETURN_VARIABLE(name) baranium_compiled_variable_push_to_stack(baranium_get_runtime()->cpu, &name)
 
+// stack callbacks read their arguments right from the operand stack, each argument already has the type given in the signature
+#define BARANIUM_STACK_CALLBACK_ADD(name, numParams, signature) baranium_callback_add_stack(baranium_get_id_of_name(#name), baranium_stack_callback_##name, numParams, signature)
+
+#define BARANIUM_STACK_CALLBACK_DEFINE(name) void baranium_stack_callback_##name (const baranium_callback_stack_view_t* args, baranium_compiled_variable* result)
+
+// the declared parameter types of a stack callback, `BARANIUM_VARIABLE_TYPE_INVALID` accepts any type
+#define BARANIUM_CALLBACK_SIGNATURE(...) ((const baranium_variable_type_t[]){__VA_ARGS__})
+
+// value of the argument at `param_index`, counted from the first parameter
+#define BARANIUM_STACK_CALLBACK_ARG(param_index) (args->arguments[param_index].value)
+
 typedef struct baranium_callback_data_list_t
 {
     baranium_value_t* data;
@@ -77,12 +90,43 @@ typedef struct baranium_callback_data_list_t
 
 typedef void(*baranium_callback_t)(baranium_callback_data_list_t* callbackdata);
 
+/**
+ * @brief A single argument of a stack callback, it is owned by the operand stack
+ */
+typedef struct baranium_callback_argument_t
+{
+    baranium_value_t value;     // inline value, strings point to the characters of a runtime string
+    uint32_t size;              // size of the value in bytes, the length for strings
+    baranium_variable_type_t type;
+    uint8_t reserved[3];
+} baranium_callback_argument_t;
+
+/**
+ * @brief Read-only view of the arguments of a stack callback
+ * 
+ * @note The arguments are only valid until the callback returns or calls back into the runtime
+ */
+typedef struct baranium_callback_stack_view_t
+{
+    const baranium_callback_argument_t* arguments;
+    int count;
+} baranium_callback_stack_view_t;
+
+/**
+ * @brief Callback that gets its arguments as a view of the operand stack
+ * 
+ * @note `result` starts out as void, strings returned through it are copied once the callback returns
+ */
+typedef void(*baranium_stack_callback_t)(const baranium_callback_stack_view_t* args, baranium_compiled_variable* result);
+
 typedef struct baranium_callback_list_entry
 {
     struct baranium_callback_list_entry* prev;
     index_t id;
     int parameter_count;
     baranium_callback_t callback;
+    baranium_stack_callback_t stack_callback;       // set instead of `callback` for stack callbacks
+    const baranium_variable_type_t* signature;      // parameter types of a stack callback, may be NULL
     struct baranium_callback_list_entry* next;
 } baranium_callback_list_entry;
 
@@ -91,6 +135,8 @@ typedef struct baranium_callback_list
     baranium_callback_list_entry* start;
     baranium_callback_list_entry* end;
     size_t count;
+    baranium_callback_list_entry** buckets;     // hash index over the ids of the entries, empty buckets are NULL
+    size_t capacity;                            // number of buckets, always a power of two
 } baranium_callback_list;
 
 typedef void(*internal_operation_t)(index_t id);
@@ -113,7 +159,7 @@ BARANIUMAPI baranium_callback_list* baranium_callback_list_init(void);
 BARANIUMAPI void baranium_callback_list_dispose(baranium_callback_list* list);
 
 /**
- * @brief Add a callback to a C function
+ * @brief Add a callback to a C function, replaces the callback already added with the same ID
  * 
  * @param id Callback ID
  * @param cb Callback pointer
@@ -121,6 +167,16 @@ BARANIUMAPI void baranium_callback_list_dispose(baranium_callback_list* list);
  */
 BARANIUMAPI void baranium_callback_add(index_t id, baranium_callback_t cb, int numParams);
 
+/**
+ * @brief Add a callback to a C function that reads its arguments from the operand stack, replaces the callback already added with the same ID
+ * 
+ * @param id Callback ID
+ * @param cb Callback pointer
+ * @param numParams Number of parameters
+ * @param signature Types the arguments get converted to before the call, NULL to pass them as they are
+ */
+BARANIUMAPI void baranium_callback_add_stack(index_t id, baranium_stack_callback_t cb, int numParams, const baranium_variable_type_t* signature);
+
 /**
  * @brief Find a callback entry
  * 
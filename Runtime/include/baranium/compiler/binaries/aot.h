@@ -0,0 +1,28 @@
+#ifndef __BARANIUM__COMPILER__BINARIES__AOT_H_
+#define __BARANIUM__COMPILER__BINARIES__AOT_H_ 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <baranium/defines.h>
+#include <stdint.h>
+
+/**
+ * @brief Generate C code with the native bodies of every function of a compiled library
+ *
+ * @note The generated file has to be built into the dynamic library that is loaded alongside
+ *       the library (`<library>.so`/`<library>.dll`) with the runtime headers on the include path,
+ *       functions keep their ids and the library keeps working without the native code
+ *
+ * @param libraryPath Path of the compiled library
+ * @param outputPath Path of the C file that will be written
+ * @returns 1 on success, 0 otherwise
+ */
+BARANIUMAPI uint8_t baranium_aot_compile_library(const char* libraryPath, const char* outputPath);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
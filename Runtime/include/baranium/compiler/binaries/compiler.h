@@ -23,6 +23,9 @@ extern "C" {
 
 #define BARANIUM_CODE_BUFFER_SIZE   0x400
 
+// maximum number of frame slots holding intermediate results of register instructions per function
+#define BARANIUM_COMPILER_MAX_TEMPORARIES 0x10
+
 /**
 * @brief A class that compiles tokens into executable binary code
 */
@@ -30,6 +33,10 @@ typedef struct
 {
     size_t loop_begin_addr; // used for `continue`
     size_t loop_end_addr; // used for `break`
+    size_t local_count; // number of frame slots used by the locals of the function that is compiled
+    index_t temporaries[BARANIUM_COMPILER_MAX_TEMPORARIES]; // frame slots reserved for intermediate results of register instructions
+    size_t temporary_slot_count; // number of reserved temporary slots
+    size_t temporary_count; // number of temporary slots that are currently in use
 
     uint8_t* code;
     size_t code_length;
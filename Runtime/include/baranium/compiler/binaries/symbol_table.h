@@ -26,6 +26,8 @@ typedef struct
 {
     const char* name;
     index_t id;
+    baranium_variable_type_t type;
+    index_t local; // slot in the frame of the function for locals, `BARANIUM_INVALID_INDEX` otherwise
 } baranium_symbol_table_entry;
 
 /**
@@ -79,6 +81,26 @@ index_t baranium_symbol_table_lookup(baranium_symbol_table* table, const char* n
  */
 const char* baranium_symbol_table_lookup_name(baranium_symbol_table* table, index_t id);
 
+/**
+ * @brief Look for the type of a specific entry
+ * 
+ * @param table Variable table
+ * @param name Name of the entry
+ * @returns The type of the entry, `BARANIUM_VARIABLE_TYPE_INVALID` if it is unknown
+ */
+baranium_variable_type_t baranium_symbol_table_lookup_type(baranium_symbol_table* table, const char* name);
+
+/**
+ * @brief Look for the frame slot of a local variable
+ * 
+ * @note Newer entries shadow older ones with the same id
+ * 
+ * @param table Variable table
+ * @param id ID of the entry
+ * @returns The entry of the local, `NULL` if the entry isn't a local
+ */
+baranium_symbol_table_entry* baranium_symbol_table_lookup_local(baranium_symbol_table* table, index_t id);
+
 /**
  * @brief Add a variable entry
  * 
@@ -96,6 +118,25 @@ void baranium_symbol_table_add(baranium_symbol_table* table, baranium_variable_t
  */
 void baranium_symbol_table_add_from_name_and_id(baranium_symbol_table* table, const char* name, index_t id);
 
+/**
+ * @brief Add a variable entry with a known type
+ * 
+ * @param table Variable table
+ * @param name The variable name for which the entry will be created
+ * @param id The variable id for which the entry will be created
+ * @param type The variable type for which the entry will be created
+ */
+void baranium_symbol_table_add_from_name_id_and_type(baranium_symbol_table* table, const char* name, index_t id, baranium_variable_type_t type);
+
+/**
+ * @brief Add a local variable entry
+ * 
+ * @param table Variable table
+ * @param var The variable for which the entry will be created
+ * @param slot The slot of the variable in the frame of its function
+ */
+void baranium_symbol_table_add_local(baranium_symbol_table* table, baranium_variable_token* var, index_t slot);
+
 /**
  * @brief Remove a variable entry
  * 
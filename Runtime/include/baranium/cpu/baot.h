@@ -0,0 +1,151 @@
+/**
+ * @note THIS IS NOT INTENDED FOR USE BY THE USER OF THE RUNTIME!
+ *       This header is intended to be used internally by the runtime
+ *       and therefore, functions defined in this header cannot be used
+ *       by the user.
+ */
+#ifndef __BARANIUM__CPU__BAOT_H_
+#define __BARANIUM__CPU__BAOT_H_ 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// this header is included by the C code `barc` generates for libraries, the generated code is built into the dynamic
+// library of the library and only reaches the runtime through the arguments of its functions, it never links against it
+
+#include <baranium/cpu/bcpu_opcodes.h>
+#include <baranium/cpu/bcode.h>
+#include <baranium/variable.h>
+#include <baranium/bcpu.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// bumped whenever the layout of the cpu, the stack or the decoded instructions changes, older tables are ignored
+#define BARANIUM_AOT_VERSION 1
+
+// name of the table the generated code exports from the dynamic library
+#define BARANIUM_AOT_TABLE_SYMBOL "__baranium_aot__"
+
+#if BARANIUM_PLATFORM == BARANIUM_PLATFORM_WINDOWS
+#   define BARANIUM_AOT_EXPORT __declspec(dllexport)
+#elif defined(__GNUC__) || defined(__clang__)
+#   define BARANIUM_AOT_EXPORT __attribute__((visibility("default")))
+#else
+#   define BARANIUM_AOT_EXPORT
+#endif
+
+// native body of a single library function
+typedef struct baranium_aot_function
+{
+    index_t id;                 // id of the function, the same as in the export table of the library
+    uint64_t count;             // number of decoded instructions the body was generated from
+    uint64_t checksum;          // checksum of the bytecode the body was generated from, see bcode_checksum
+    bcode_native_entry entry;   // the body
+} baranium_aot_function;
+
+// every function of a library that was compiled to C
+typedef struct baranium_aot_table
+{
+    uint32_t version;                       // BARANIUM_AOT_VERSION of the generated code
+    uint64_t count;                         // number of functions
+    const baranium_aot_function* functions; // the functions
+} baranium_aot_table;
+
+// the macros below are the building blocks of the generated code, every instruction `i` of the decoded code
+// has the label `i<i>` and the variables `cpu`, `code` and `handlers` are the arguments of the native entry
+
+// runs an instruction through its handler, the native code is left once the cpu got killed
+#define BARANIUM_AOT_CALL(index, opcode)                                        \
+    cpu->ip = (index) + 1;                                                      \
+    handlers[opcode].handle(cpu, &code[index]);                                 \
+    cpu->ticks++;                                                               \
+    if (cpu->kill_triggered)                                                    \
+        return 1
+
+// after CALL, TAILCALL and RET, the native code only continues if the cpu stayed in this function
+#define BARANIUM_AOT_STAY(index)                                                \
+    if (cpu->ip != (index) + 1 || cpu->bus->data_holder->code->instructions != code) \
+        return 1
+
+// after a handler that may have jumped, the native code continues wherever the instruction pointer points to
+#define BARANIUM_AOT_FOLLOW(index)                                              \
+    if (cpu->ip != (index) + 1)                                                 \
+        goto dispatch
+
+#define BARANIUM_AOT_JUMP(target)                                               \
+    cpu->ticks++;                                                               \
+    goto i##target
+
+#define BARANIUM_AOT_JUMP_IF(condition, target)                                 \
+    cpu->ticks++;                                                               \
+    if (cpu->flags.CMP && (condition))                                          \
+        goto i##target
+
+// the fast paths below only cover the common case and leave everything else, including errors, to the handler
+
+#define BARANIUM_AOT_TOP(offset) ((baranium_value_t){.num64 = cpu->stack->slots[cpu->stack->count - (offset)].data})
+
+#define BARANIUM_AOT_ARITHMETIC(index, opcode, field, operator, checkZero)      \
+    if (cpu->stack->count < 2 || ((checkZero) && BARANIUM_AOT_TOP(1).field == 0)) \
+    {                                                                           \
+        BARANIUM_AOT_CALL(index, opcode);                                       \
+    }                                                                           \
+    else                                                                        \
+    {                                                                           \
+        baranium_value_t result = {0};                                          \
+        result.field = BARANIUM_AOT_TOP(2).field operator BARANIUM_AOT_TOP(1).field; \
+        cpu->stack->slots[cpu->stack->count - 2].data = result.num64;           \
+        cpu->stack->count--;                                                    \
+        cpu->ticks++;                                                           \
+    }
+
+#define BARANIUM_AOT_COMPARE(index, opcode, field, operator)                    \
+    if (!cpu->flags.CMP || cpu->stack->count < 2)                               \
+    {                                                                           \
+        BARANIUM_AOT_CALL(index, opcode);                                       \
+    }                                                                           \
+    else                                                                        \
+    {                                                                           \
+        cpu->cv = BARANIUM_AOT_TOP(2).field operator BARANIUM_AOT_TOP(1).field; \
+        cpu->stack->count -= 2;                                                 \
+        cpu->ticks++;                                                           \
+    }
+
+#define BARANIUM_AOT_COMPARE_JUMP(index, opcode, operator, target)              \
+    if (cpu->stack->count >= 2 &&                                               \
+        cpu->stack->slots[cpu->stack->count - 2].type == BARANIUM_VARIABLE_TYPE_INT32 && \
+        cpu->stack->slots[cpu->stack->count - 1].type == BARANIUM_VARIABLE_TYPE_INT32)   \
+    {                                                                           \
+        uint8_t taken = BARANIUM_AOT_TOP(2).snum32 operator BARANIUM_AOT_TOP(1).snum32; \
+        cpu->stack->count -= 2;                                                 \
+        cpu->ticks++;                                                           \
+        if (taken)                                                              \
+            goto i##target;                                                     \
+    }                                                                           \
+    else                                                                        \
+    {                                                                           \
+        BARANIUM_AOT_CALL(index, opcode);                                       \
+        BARANIUM_AOT_FOLLOW(index);                                             \
+    }
+
+#define BARANIUM_AOT_LOADLOCAL(index, opcode)                                   \
+    if (code[index].operand < cpu->locals->count - cpu->frame &&                \
+        cpu->stack->count < cpu->stack->capacity &&                             \
+        cpu->locals->slots[cpu->frame + code[index].operand].type != BARANIUM_VARIABLE_TYPE_STRING && \
+        cpu->locals->slots[cpu->frame + code[index].operand].type != BARANIUM_VARIABLE_TYPE_VOID &&   \
+        cpu->locals->slots[cpu->frame + code[index].operand].type != BARANIUM_VARIABLE_TYPE_INVALID)  \
+    {                                                                           \
+        cpu->stack->slots[cpu->stack->count++] = cpu->locals->slots[cpu->frame + code[index].operand]; \
+        cpu->ticks++;                                                           \
+    }                                                                           \
+    else                                                                        \
+    {                                                                           \
+        BARANIUM_AOT_CALL(index, opcode);                                       \
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ * @note THIS IS NOT INTENDED FOR USE BY THE USER OF THE RUNTIME!
+ *       This header is intended to be used internally by the runtime
+ *       and therefore, functions defined in this header cannot be used
+ *       by the user.
+ */
+#ifndef __BARANIUM__CPU__BCODE_H_
+#define __BARANIUM__CPU__BCODE_H_ 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <baranium/cpu/bcpu_opcodes.h>
+#include <baranium/defines.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// a single decoded instruction, immediates are already in native byte order
+typedef struct bcpu_instruction
+{
+    uint8_t opcode;     // operation code/instruction
+    uint8_t type;       // variable type immediate
+    uint8_t method;     // compare method immediate
+    uint8_t feedback;   // how often a generic instruction saw the same operand type in a row, see bcpu_quicken
+    uint32_t target;    // resolved jump target (instruction index), offset of inline data in the raw code or destination slot
+    uint64_t operand;   // first 64 bit immediate, the slot of the callee or global once the code is linked
+    uint64_t operand2;  // second 64 bit immediate, or the runtime string of a string literal
+} bcpu_instruction;
+
+struct bjit_code;
+struct bcpu;
+
+// native body of a function from a library that was compiled ahead of time, runs the code from the instruction pointer
+// of the cpu until the cpu leaves the function or gets killed, returns 0 if it handed an instruction back to the interpreter
+typedef uint8_t(*bcode_native_entry)(struct bcpu* cpu, const bcpu_instruction* code, const bcpu_opcode* handlers);
+
+// the decoded body of a function
+typedef struct bcode
+{
+    bcpu_instruction* instructions; // decoded instructions, always terminated by a RET
+    size_t count;                   // number of instructions including the terminating RET
+    uint32_t hotness;               // entries and backward jumps counted by the interpreter, decides when the code gets compiled
+    uint8_t jit_failed;             // set if the code cannot be compiled and stays interpreted
+    uint8_t jit_stale;              // set if an instruction got quickened or deoptimized after the code was compiled
+    uint8_t malformed;              // set by the decoder if an instruction was truncated or a jump doesn't land on an instruction
+    uint8_t verified;               // set by `bverify_code`, the interpreter skips the checks the verifier made redundant
+    size_t max_stack;               // most values verified code pushes between two calls, reserved on the stack when it is entered
+    struct bjit_code* jit;          // native code, NULL while the code is interpreted
+    bcode_native_entry aot;         // native body from the dynamic library of the library, takes precedence over `jit`
+} bcode;
+
+// decode raw bytecode into instruction records and verify them, jumps to invalid addresses will land on the terminating RET
+// register instructions are only accepted if `registers` is set, see BARANIUM_BINARY_FLAG_REGISTER_CODE
+bcode* bcode_decode(const uint8_t* data, size_t size, uint8_t registers);
+
+// rewrite the ids of callees and globals into slots of the function cache and variable manager of the runtime
+// returns 0 if the slots could not be created, the code cannot be run then
+uint8_t bcode_link(bcode* code);
+
+// report the linked callees and globals of a function that don't resolve yet, returns how many there are
+size_t bcode_report_unresolved(bcode* code, index_t functionID);
+
+// checksum of raw bytecode, ties the native bodies of a library to the bytecode they were generated from
+uint64_t bcode_checksum(const uint8_t* data, size_t size);
+
+// dispose decoded code
+void bcode_dispose(bcode* code);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -15,8 +15,24 @@ extern "C" {
 
 #define MAX_OPCODE_AMOUNT 0x100
 
+// every decoded function is terminated with this opcode
+#define BCPU_OPCODE_RET 0x0F
+
+// opcodes 0x90 - 0xAF are specialized variants of generic instructions, only the interpreter writes them into decoded code
+#define BCPU_OPCODE_QUICKENED_FIRST 0x90
+#define BCPU_OPCODE_QUICKENED_LAST  0xAF
+
+// opcodes 0xB0 - 0xCF are three-address instructions that work on the frame slots of a function instead of the stack,
+// only code of binaries with BARANIUM_BINARY_FLAG_REGISTER_CODE set may contain them
+#define BCPU_OPCODE_REGISTER_FIRST 0xB0
+#define BCPU_OPCODE_REGISTER_LAST  0xCF
+
+// never assigned, the decoder replaces opcodes that bytecode must not contain with it
+#define BCPU_OPCODE_INVALID 0xFE
+
 struct bcpu;
-typedef void(*OPCODE_HANDLE)(struct bcpu* cpu);
+struct bcpu_instruction;
+typedef void(*OPCODE_HANDLE)(struct bcpu* cpu, const struct bcpu_instruction* instruction);
 
 typedef struct
 {
@@ -26,8 +42,17 @@ typedef struct
 
 void bcpu_opcodes_init(void);
 
+// handle of every opcode that is not assigned to an instruction
+void INVALID_OPCODE(struct bcpu* cpu, const struct bcpu_instruction* instruction);
+
+// runs the decoded code of the current function in a single dispatch loop, use `bcpu_run` instead of this
+void bcpu_opcodes_execute(struct bcpu* cpu);
+
 extern bcpu_opcode opcodes[];
 
+// handlers for code that passed `bverify_code`, the same as `opcodes` except for the instructions of BCPU_VERIFIED_INSTRUCTION_LIST
+extern bcpu_opcode verified_opcodes[];
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,60 @@
+/**
+ * @note THIS IS NOT INTENDED FOR USE BY THE USER OF THE RUNTIME!
+ *       This header is intended to be used internally by the runtime
+ *       and therefore, functions defined in this header cannot be used
+ *       by the user.
+ */
+#ifndef __BARANIUM__CPU__BJIT_H_
+#define __BARANIUM__CPU__BJIT_H_ 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <baranium/cpu/bcode.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// native code is only generated for x86-64 linux and only if the runtime is built with BARANIUM_JIT
+#if defined(BARANIUM_JIT) && defined(__linux__) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#   define BJIT_AVAILABLE 1
+#else
+#   define BJIT_AVAILABLE 0
+#endif
+
+// number of entries and backward jumps after which a function gets compiled to native code
+#define BJIT_HOT_THRESHOLD 0x200
+
+// functions with more instructions than this stay interpreted
+#define BJIT_MAX_INSTRUCTIONS 0x100000
+
+struct bcpu;
+
+// native code of a function, every instruction of the decoded code has its own entry point
+typedef struct bjit_code
+{
+    uint8_t* memory;    // executable mapping holding the native code
+    size_t size;        // size of the mapping
+    void** table;       // native address of each instruction, indexed like the decoded code
+    size_t active;      // runs of the native code that haven't returned yet, callbacks can run a function again
+} bjit_code;
+
+// compile decoded code to native code, returns 0 if the code has to stay interpreted
+uint8_t bjit_compile(bcode* code);
+
+// run compiled code from the instruction pointer of the cpu until the cpu leaves the function or gets killed
+// returns 0 if the native code handed an instruction back to the interpreter
+uint8_t bjit_run(struct bcpu* cpu, bcode* code);
+
+// drop the native code of a function that got stale, once no run of it is left on the stack,
+// the function is compiled again the next time it is hot, see `jit_stale`
+void bjit_drop_stale(bcode* code);
+
+// release the native code of a function
+void bjit_dispose(bjit_code* jit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
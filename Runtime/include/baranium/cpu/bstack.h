@@ -13,13 +13,25 @@ extern "C" {
 
 #define INITIAL_STACK_SIZE 0x100
 
+// type tag of slots that hold a plain word (return addresses, error codes, ...) instead of a value
+#define BSTACK_SLOT_TYPE_RAW 0xFE
+
 #include <stdint.h>
 #include <stdlib.h>
 
+// a single value on the stack, strings are stored as a pointer to a runtime string the slot holds a reference to
+typedef struct bstack_slot
+{
+    uint64_t data;      // inline value or pointer to the string data
+    uint32_t size;      // size of the value in bytes
+    uint8_t type;       // variable type of the value
+    uint8_t reserved[3];
+} bstack_slot;
+
 typedef struct bstack
 {
-    uint64_t* stackptr;
-    size_t buffer_size;
+    bstack_slot* slots;
+    size_t capacity;
     size_t count;
 } bstack;
 
@@ -32,12 +44,24 @@ void bstack_dispose(bstack* obj);
 // clear a stack
 void bstack_clear(bstack* obj);
 
+// make sure there is space for at least `count` more slots, returns 0 if the stack could not grow
+uint8_t bstack_reserve(bstack* obj, size_t count);
+
+// drop all slots above `count` at once, releasing their strings
+void bstack_truncate(bstack* obj, size_t count);
+
 // push a value to the stack
 void bstack_push(bstack* obj, uint64_t data);
 
 // pop a value from the stack
 uint64_t bstack_pop(bstack* obj);
 
+// push a slot to the stack, the stack takes over the reference to string data
+void bstack_push_slot(bstack* obj, bstack_slot slot);
+
+// pop a slot from the stack, the caller takes ownership of string data
+bstack_slot bstack_pop_slot(bstack* obj);
+
 #ifdef __cplusplus
 }
 #endif
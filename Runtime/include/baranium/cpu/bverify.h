@@ -0,0 +1,30 @@
+/**
+ * @note THIS IS NOT INTENDED FOR USE BY THE USER OF THE RUNTIME!
+ *       This header is intended to be used internally by the runtime
+ *       and therefore, functions defined in this header cannot be used
+ *       by the user.
+ */
+#ifndef __BARANIUM__CPU__BVERIFY_H_
+#define __BARANIUM__CPU__BVERIFY_H_ 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <baranium/cpu/bcode.h>
+#include <stdint.h>
+
+// check decoded code once before it runs, sets `verified` and `max_stack` of the code if
+// - the decoder didn't find a truncated instruction or a jump that doesn't land on an instruction
+// - every opcode is an instruction and ENTER only makes the frame at the start of the function
+// - every local and register slot lies inside of that frame
+// - the operands of every typed instruction are pushed by the function itself after the last call
+// - the stack depth is the same on every path that leads to an instruction
+// returns 0 if the code isn't verified, it still runs then but with every check in place
+uint8_t bverify_code(bcode* code);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
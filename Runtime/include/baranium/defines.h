@@ -94,6 +94,7 @@ struct baranium_library;
 struct baranium_string_list;
 struct baranium_callback_list;
 struct baranium_function_manager;
+struct baranium_function_cache;
 
 typedef struct
 {
@@ -101,8 +102,8 @@ typedef struct
     baranium_handle* end;
     uint64_t open_handles;
     struct baranium_function_manager* function_manager;
+    struct baranium_function_cache* function_cache;
     struct baranium_callback_list* callbacks;
-    struct bstack* function_stack;
     struct bvarmgr* varmgr;
     struct bcpu* cpu;
 
@@ -17,6 +17,7 @@ extern "C" {
 
 struct baranium_script;
 struct baranium_library;
+struct bcode;
 
 typedef struct baranium_function
 {
@@ -24,7 +25,8 @@ typedef struct baranium_function
     size_t data_size;
     uint8_t parameter_count;
     baranium_variable return_data;
-    void* data;
+    void* data;         // code of the function, points into the image of its script or library
+    struct bcode* code; // decoded instructions, only used internally by the runtime
     struct baranium_script* script;
     struct baranium_library* library;
 } baranium_function;
@@ -42,10 +42,13 @@ typedef struct baranium_library
     const char* path;
     const char* name;
     baranium_dynlib_handle dynlib;
+    const struct baranium_aot_table* aot_table;
 
     baranium_library_header libheader;
     baranium_library_export* exports;
-    baranium_library_section* sections;
+    baranium_library_section* sections;      // sorted by id
+    bfilemap image;         // the whole file, sections and function code point into it
+    baranium_binary_index index;
 } baranium_library;
 
 /**
@@ -6,6 +6,7 @@ extern "C" {
 #endif
 
 #include <baranium/defines.h>
+#include <stdint.h>
 #include <stdio.h>
 
 typedef unsigned char loglevel_t;
@@ -15,12 +16,37 @@ typedef unsigned char loglevel_t;
 #define LOGLEVEL_ERROR      (loglevel_t)2
 #define LOGLEVEL_WARNING    (loglevel_t)3
 
+typedef uint32_t logsubsystem_t;
+
+#define LOGSUBSYSTEM_GENERAL    (logsubsystem_t)0x01
+#define LOGSUBSYSTEM_CPU        (logsubsystem_t)0x02
+#define LOGSUBSYSTEM_VARMGR     (logsubsystem_t)0x04
+#define LOGSUBSYSTEM_LOADER     (logsubsystem_t)0x08
+#define LOGSUBSYSTEM_COMPILER   (logsubsystem_t)0x10
+#define LOGSUBSYSTEM_ALL        (logsubsystem_t)0xFFFFFFFF
+
+// the subsystem debug messages of a source file belong to, define it before any include to change it
+#ifndef LOG_SUBSYSTEM
+#   define LOG_SUBSYSTEM LOGSUBSYSTEM_GENERAL
+#endif
+
 #define LOG(level, ...) log_msg(level, logstringf(__VA_ARGS__), __FILE_NAME__, __LINE__)
 #define LOGINFO(...) log_msg(LOGLEVEL_INFO, logstringf(__VA_ARGS__), __FILE_NAME__, __LINE__)
-#define LOGDEBUG(...) log_msg(LOGLEVEL_DEBUG, logstringf(__VA_ARGS__), __FILE_NAME__, __LINE__)
+#if defined(BARANIUM_NO_DEBUG_LOGGING)
+#   define LOGDEBUG(...) ((void)0)
+#else
+#   define LOGDEBUG(...) do { if (logging_debug_mask & (LOG_SUBSYSTEM)) log_msg(LOGLEVEL_DEBUG, logstringf(__VA_ARGS__), __FILE_NAME__, __LINE__); } while (0)
+#endif
 #define LOGERROR(...) log_msg(LOGLEVEL_ERROR, logstringf(__VA_ARGS__), __FILE_NAME__, __LINE__)
 #define LOGWARNING(...) log_msg(LOGLEVEL_WARNING, logstringf(__VA_ARGS__), __FILE_NAME__, __LINE__)
 
+/**
+ * @brief Subsystems which currently print debug messages, 0 if debug messages are disabled
+ *
+ * @note Read only, use `log_enable_debug_msgs` and `log_set_debug_mask` to change it
+ */
+BARANIUMAPI extern logsubsystem_t logging_debug_mask;
+
 /**
  * @brief Like printf but for building a string together
  * 
@@ -52,6 +78,15 @@ BARANIUMAPI const char* logstringf(const char* fmt, ...);
  */
 BARANIUMAPI uint8_t log_enable_debug_msgs(uint8_t val);
 
+/**
+ * @brief Select which subsystems print debug messages
+ * 
+ * @note By default all subsystems print debug messages once they are enabled
+ * 
+ * @param mask Combination of `LOGSUBSYSTEM_*` values
+ */
+BARANIUMAPI void log_set_debug_mask(logsubsystem_t mask);
+
 /**
  * @brief En-/Disable messages showing up in stdout
  * 
@@ -9,6 +9,15 @@ extern "C" {
 
 #define BARANIUM_RUNTIME_LIBRARY_BUFFER_SIZE 0x20
 
+typedef struct baranium_code_cache_stats
+{
+    uint64_t hits;          // calls of functions and callbacks that were already loaded
+    uint64_t misses;        // functions that had to be loaded
+    uint64_t evictions;     // functions that were dropped to stay within the budget
+    size_t size;            // bytes taken up by the decoded code that is loaded right now
+    size_t budget;          // 0 if there is no limit
+} baranium_code_cache_stats;
+
 /**
  * @brief Initialize a runtime instance
  * 
@@ -42,6 +51,21 @@ BARANIUMAPI baranium_runtime* baranium_get_runtime(void);
  */
 BARANIUMAPI void baranium_runtime_load_dependency(const char* dependency);
 
+/**
+ * @brief Limit the memory the decoded function code of the current runtime may take up
+ * 
+ * @note With a budget, functions are loaded on their first call instead of when their script is opened,
+ *       the least recently used ones are dropped once it is exceeded and loaded again on their next call
+ * 
+ * @param budget Number of bytes, 0 for no limit
+ */
+BARANIUMAPI void baranium_runtime_set_code_budget(size_t budget);
+
+/**
+ * @brief Get the hit, miss and eviction statistics of the code cache of the current runtime
+ */
+BARANIUMAPI baranium_code_cache_stats baranium_runtime_get_code_cache_stats(void);
+
 /**
  * @brief Safely dispose a runtime instance
  * 
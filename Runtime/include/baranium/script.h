@@ -5,6 +5,7 @@
 extern "C" {
 #endif
 
+#include <baranium/backend/bfilemap.h>
 #include <baranium/variable.h>
 #include <baranium/function.h>
 #include <baranium/defines.h>
@@ -32,7 +33,7 @@ typedef struct baranium_script_section
     index_t id;
     uint64_t data_size;
     uint64_t data_location; // mostly used by function sections because code size can sometimes be quite big and code should probably be dynamically loaded and unloaded when not needed
-    uint8_t* data;
+    uint8_t* data;          // points into the image of the script, NULL for function sections
 } baranium_script_section;
 
 typedef struct baranium_script_header
@@ -42,6 +43,36 @@ typedef struct baranium_script_header
     uint64_t section_count;
 } baranium_script_header;
 
+// features of an indexed binary that have to be known before its code can be read
+#define BARANIUM_BINARY_FLAG_REGISTER_CODE  (uint64_t)0x01  // functions may contain register instructions
+
+// follows the header of scripts and libraries since BARANIUM_VERSION_INDEXED_FORMAT,
+// offsets are counted from the start of the binary and tables are 8 byte aligned
+typedef struct baranium_binary_index
+{
+    uint64_t directory_offset;      // section_count directory entries, sorted by id
+    uint64_t name_table_offset;     // name_bucket_count buckets of the name hash table
+    uint64_t name_bucket_count;     // always a power of two, 0 if the binary has no names
+    uint64_t dependency_offset;     // dependency count, followed by the length and characters of each dependency
+    uint64_t flags;                 // BARANIUM_BINARY_FLAG_*, binaries without an index have none of them
+} baranium_binary_index;
+
+typedef struct baranium_binary_section_entry
+{
+    index_t id;
+    uint64_t data_offset;           // 8 byte aligned
+    uint64_t data_size;
+    uint8_t type;
+    uint8_t reserved[7];
+} baranium_binary_section_entry;
+
+// names are hashed by their id, which already is the hash of the name
+typedef struct baranium_binary_name_bucket
+{
+    index_t id;                     // BARANIUM_INVALID_INDEX if the bucket is empty
+    uint64_t name_offset;           // offset of the zero terminated name
+} baranium_binary_name_bucket;
+
 typedef struct baranium_script_name_table_entry
 {
     uint8_t length;
@@ -59,11 +90,13 @@ typedef struct
 typedef struct baranium_script
 {
     baranium_script_header header;
-    baranium_script_section* sections;
+    baranium_script_section* sections;      // sorted by id
     size_t section_buffer_size;
     size_t section_count;
     baranium_script_name_table nametable;
     baranium_handle* handle;
+    bfilemap image;         // the whole file, sections and function code point into it
+    baranium_binary_index index;
 } baranium_script;
 
 /**
@@ -16,6 +16,7 @@ extern "C" {
 #define BARANIUM_VERSION_FIRST_RELEASE BARANIUM_VERSION_CREATE(2025,1,6)
 #define BARANIUM_VERSION_SECOND_RELEASE BARANIUM_VERSION_CREATE(2025,4,2)
 #define BARANIUM_VERSION_THIRD_RELEASE BARANIUM_VERSION_CREATE(2025,4,25)
+#define BARANIUM_VERSION_INDEXED_FORMAT BARANIUM_VERSION_CREATE(2026,10,17)
 #define BARANIUM_VERSION_CURRENT BARANIUM_VERSION_CREATE(BARANIUM_VERSION_YEAR, BARANIUM_VERSION_MONTH, BARANIUM_VERSION_DATE)
 
 #ifdef __cplusplus
@@ -0,0 +1,97 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_LOADER
+
+#include <baranium/backend/bfilemap.h>
+#include <baranium/logging.h>
+#include <baranium/defines.h>
+#include <stdlib.h>
+
+#if BARANIUM_PLATFORM == BARANIUM_PLATFORM_LINUX || BARANIUM_PLATFORM == BARANIUM_PLATFORM_APPLE
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#   define BFILEMAP_MMAP 1
+#else
+#   define BFILEMAP_MMAP 0
+#endif
+
+// fallback for platforms without mmap and files that can't be mapped, the whole file is read with a single call
+static uint8_t bfilemap_read_file(bfilemap* map, FILE* file)
+{
+    if (fseek(file, 0, SEEK_END) != 0)
+        return 0;
+
+    long size = ftell(file);
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0)
+        return 0;
+
+    uint8_t* data = NULL;
+    if (size > 0)
+    {
+        data = malloc((size_t)size);
+        if (data == NULL)
+        {
+            LOGERROR("Could not allocate %ld bytes to read a file", size);
+            return 0;
+        }
+
+        if (fread(data, 1, (size_t)size, file) != (size_t)size)
+        {
+            free(data);
+            return 0;
+        }
+    }
+
+    map->data = data;
+    map->size = (size_t)size;
+    map->mapped = 0;
+    return 1;
+}
+
+uint8_t bfilemap_open(bfilemap* map, FILE* file)
+{
+    if (map == NULL)
+        return 0;
+
+    map->data = NULL;
+    map->size = 0;
+    map->mapped = 0;
+
+    if (file == NULL)
+        return 0;
+
+#if BFILEMAP_MMAP
+    // private read only mappings of the same file share their pages through the page cache
+    int fd = fileno(file);
+    struct stat info;
+    if (fd >= 0 && fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+        void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            map->data = data;
+            map->size = (size_t)info.st_size;
+            map->mapped = 1;
+            return 1;
+        }
+    }
+#endif
+
+    return bfilemap_read_file(map, file);
+}
+
+void bfilemap_close(bfilemap* map)
+{
+    if (map == NULL || map->data == NULL)
+        return;
+
+#if BFILEMAP_MMAP
+    if (map->mapped)
+        munmap((void*)map->data, map->size);
+    else
+#endif
+        free((void*)map->data);
+
+    map->data = NULL;
+    map->size = 0;
+    map->mapped = 0;
+}
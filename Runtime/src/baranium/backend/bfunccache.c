@@ -0,0 +1,278 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_LOADER
+
+#include <baranium/backend/bfunccache.h>
+#include <baranium/backend/bidhash.h>
+#include <baranium/backend/bfuncmgr.h>
+#include <baranium/cpu/bcode.h>
+#include <baranium/runtime.h>
+#include <baranium/bcpu.h>
+#include <baranium/logging.h>
+#include <memory.h>
+#include <stdlib.h>
+
+static index_t baranium_function_cache_bucket_id(const void* table, size_t bucket)
+{
+    const baranium_function_cache* obj = table;
+    size_t slot = obj->buckets[bucket];
+    return slot == BARANIUM_FUNCTION_CACHE_NO_SLOT ? BARANIUM_INVALID_INDEX : obj->slots[slot].id;
+}
+
+// finds the bucket of an id, or the empty bucket the id would go into
+static size_t* baranium_function_cache_find(baranium_function_cache* obj, index_t id)
+{
+    return &obj->buckets[bidhash_find(obj, obj->capacity, id, baranium_function_cache_bucket_id)];
+}
+
+// rehashes every slot into a bucket array of the given capacity, the slots themselves stay in place
+static uint8_t baranium_function_cache_resize(baranium_function_cache* obj, size_t capacity)
+{
+    size_t* buckets = malloc(sizeof(size_t) * capacity);
+    if (buckets == NULL)
+        return 0;
+
+    for (size_t i = 0; i < capacity; i++)
+        buckets[i] = BARANIUM_FUNCTION_CACHE_NO_SLOT;
+
+    free(obj->buckets);
+    obj->buckets = buckets;
+    obj->capacity = capacity;
+
+    for (size_t i = 0; i < obj->slot_count; i++)
+        *baranium_function_cache_find(obj, obj->slots[i].id) = i;
+
+    return 1;
+}
+
+// bytes taken up by a loaded function and its decoded code
+static size_t baranium_function_cache_size_of(const baranium_function* function)
+{
+    size_t size = sizeof(baranium_function);
+    if (function->code != NULL)
+        size += sizeof(bcode) + sizeof(bcpu_instruction) * function->code->count;
+
+    return size;
+}
+
+// drops the cached function of a slot, the slot stays linked and the next call loads it again
+static void baranium_function_cache_drop(baranium_function_cache* obj, baranium_function_cache_entry* entry)
+{
+    baranium_function_dispose(entry->function);
+    obj->code_size -= entry->size;
+    entry->function = NULL;
+    entry->callback = NULL;
+    entry->size = 0;
+    obj->count--;
+}
+
+// marks a function the cpu is running or returns into as just used, so that it isn't dropped under the cpu
+static void baranium_function_cache_mark_running(baranium_function_cache* obj, baranium_function* function)
+{
+    if (function == NULL)
+        return;
+
+    size_t slot = *baranium_function_cache_find(obj, function->id);
+    if (slot != BARANIUM_FUNCTION_CACHE_NO_SLOT && obj->slots[slot].function == function)
+        obj->slots[slot].used = ++obj->clock;
+}
+
+// drops the least recently used functions until the decoded code fits into the budget again,
+// the function that was used last and every function of the cpu's call stack are kept
+static void baranium_function_cache_trim(baranium_function_cache* obj)
+{
+    if (obj->budget == 0 || obj->code_size <= obj->budget)
+        return;
+
+    uint64_t oldest = obj->clock;
+    baranium_runtime* runtime = baranium_get_runtime();
+    bcpu* cpu = runtime ? runtime->cpu : NULL;
+    if (cpu != NULL)
+    {
+        baranium_function_cache_mark_running(obj, cpu->bus ? cpu->bus->data_holder : NULL);
+        for (size_t i = 0; i < cpu->frame_count; i++)
+            baranium_function_cache_mark_running(obj, cpu->frames[i].function);
+    }
+
+    while (obj->code_size > obj->budget)
+    {
+        baranium_function_cache_entry* victim = NULL;
+        for (size_t i = 0; i < obj->slot_count; i++)
+        {
+            baranium_function_cache_entry* entry = &obj->slots[i];
+            if (entry->function != NULL && entry->used < oldest && (victim == NULL || entry->used < victim->used))
+                victim = entry;
+        }
+
+        if (victim == NULL)
+            break;
+
+        LOGDEBUG("Evicted function with id %ld from the function cache", victim->id);
+        baranium_function_cache_drop(obj, victim);
+        obj->evictions++;
+    }
+}
+
+baranium_function_cache* baranium_function_cache_init(void)
+{
+    baranium_function_cache* obj = malloc(sizeof(baranium_function_cache));
+    if (obj == NULL) return NULL;
+
+    memset(obj, 0, sizeof(baranium_function_cache));
+    obj->budget = BARANIUM_CODE_BUDGET;
+    if (!baranium_function_cache_resize(obj, BARANIUM_FUNCTION_CACHE_INITIAL_CAPACITY))
+    {
+        free(obj);
+        return NULL;
+    }
+
+    LOGDEBUG("Created function cache");
+
+    return obj;
+}
+
+void baranium_function_cache_dispose(baranium_function_cache* obj)
+{
+    if (!obj) return;
+
+    LOGDEBUG("Disposing function cache with %ld entries", obj->count);
+    LOGDEBUG("Function cache hits: %llu, misses: %llu, evictions: %llu", obj->hits, obj->misses, obj->evictions);
+
+    baranium_function_cache_clear(obj);
+    free(obj->buckets);
+    free(obj->slots);
+    free(obj);
+}
+
+void baranium_function_cache_clear(baranium_function_cache* obj)
+{
+    if (obj == NULL) return;
+
+    if (obj->count == 0) return;
+
+    LOGDEBUG("Cleared function cache with %ld entries", obj->count);
+
+    for (size_t i = 0; i < obj->slot_count; i++)
+    {
+        baranium_function_dispose(obj->slots[i].function);
+        obj->slots[i].function = NULL;
+        obj->slots[i].callback = NULL;
+        obj->slots[i].size = 0;
+    }
+
+    obj->count = 0;
+    obj->code_size = 0;
+}
+
+baranium_function_cache_entry* baranium_function_cache_get(baranium_function_cache* obj, index_t id)
+{
+    size_t slot = baranium_function_cache_link(obj, id);
+    if (slot == BARANIUM_FUNCTION_CACHE_NO_SLOT)
+        return NULL;
+
+    return baranium_function_cache_get_slot(obj, slot);
+}
+
+size_t baranium_function_cache_link(baranium_function_cache* obj, index_t id)
+{
+    if (obj == NULL || id == BARANIUM_INVALID_INDEX)
+        return BARANIUM_FUNCTION_CACHE_NO_SLOT;
+
+    size_t* bucket = baranium_function_cache_find(obj, id);
+    if (*bucket != BARANIUM_FUNCTION_CACHE_NO_SLOT)
+        return *bucket;
+
+    if (obj->slot_count == obj->slot_capacity)
+    {
+        size_t capacity = obj->slot_capacity ? obj->slot_capacity * 2 : BARANIUM_FUNCTION_CACHE_INITIAL_CAPACITY;
+        baranium_function_cache_entry* slots = realloc(obj->slots, sizeof(baranium_function_cache_entry) * capacity);
+        if (slots == NULL)
+            return BARANIUM_FUNCTION_CACHE_NO_SLOT;
+
+        obj->slots = slots;
+        obj->slot_capacity = capacity;
+    }
+
+    size_t capacity = bidhash_grown_capacity(obj->slot_count, obj->capacity);
+    if (capacity != obj->capacity)
+    {
+        if (!baranium_function_cache_resize(obj, capacity))
+            return BARANIUM_FUNCTION_CACHE_NO_SLOT;
+        bucket = baranium_function_cache_find(obj, id);
+    }
+
+    size_t slot = obj->slot_count++;
+    obj->slots[slot] = (baranium_function_cache_entry){.id = id};
+    *bucket = slot;
+
+    return slot;
+}
+
+baranium_function_cache_entry* baranium_function_cache_resolve(baranium_function_cache* obj, size_t slot)
+{
+    if (obj == NULL || slot >= obj->slot_count)
+        return NULL;
+
+    index_t id = obj->slots[slot].id;
+
+    // callbacks take precedence over script and library functions
+    baranium_runtime* runtime = baranium_get_runtime();
+    baranium_callback_list_entry* callback = baranium_callback_find_by_id(id);
+    baranium_function* function = NULL;
+    if (callback == NULL && runtime != NULL)
+        function = baranium_function_manager_get(runtime->function_manager, id);
+
+    if (callback == NULL && function == NULL)
+        return NULL;
+
+    // loading the function links its code, which can move the slots
+    baranium_function_cache_entry* entry = &obj->slots[slot];
+    if (entry->function != NULL || entry->callback != NULL)
+    {
+        baranium_function_dispose(function);
+        return entry;
+    }
+
+    entry->function = function;
+    entry->callback = callback;
+    entry->used = ++obj->clock;
+    obj->count++;
+
+    LOGDEBUG("Cached %s with id %ld", callback ? "callback" : "function", id);
+
+    if (function != NULL)
+    {
+        entry->size = baranium_function_cache_size_of(function);
+        obj->code_size += entry->size;
+        obj->misses++;
+        baranium_function_cache_trim(obj);
+    }
+
+    return entry;
+}
+
+void baranium_function_cache_remove(baranium_function_cache* obj, index_t id)
+{
+    if (obj == NULL || obj->count == 0 || id == BARANIUM_INVALID_INDEX)
+        return;
+
+    size_t slot = *baranium_function_cache_find(obj, id);
+    if (slot == BARANIUM_FUNCTION_CACHE_NO_SLOT)
+        return;
+
+    // the slot stays linked, the next call resolves it again
+    baranium_function_cache_entry* entry = &obj->slots[slot];
+    if (entry->function == NULL && entry->callback == NULL)
+        return;
+
+    baranium_function_cache_drop(obj, entry);
+
+    LOGDEBUG("Dropped cached function with id %ld", id);
+}
+
+void baranium_function_cache_set_budget(baranium_function_cache* obj, size_t budget)
+{
+    if (obj == NULL)
+        return;
+
+    obj->budget = budget;
+    baranium_function_cache_trim(obj);
+}
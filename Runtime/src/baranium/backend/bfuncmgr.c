@@ -1,16 +1,96 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_LOADER
+
 #include <baranium/backend/bfuncmgr.h>
+#include <baranium/backend/bidhash.h>
 #include <baranium/library.h>
 #include <baranium/logging.h>
 #include <memory.h>
 #include <stdlib.h>
 
+static index_t baranium_function_manager_bucket_id(const void* table, size_t bucket)
+{
+    return ((const baranium_function_manager_bucket*)table)[bucket].id;
+}
+
+static void baranium_function_manager_move_bucket(void* table, size_t from, size_t to)
+{
+    baranium_function_manager_bucket* buckets = table;
+    buckets[to] = buckets[from];
+    buckets[from] = (baranium_function_manager_bucket){.id = BARANIUM_INVALID_INDEX};
+}
+
+// finds the bucket of an id, or the empty bucket the id would go into
+static baranium_function_manager_bucket* baranium_function_manager_find(baranium_function_manager* obj, index_t id)
+{
+    return &obj->buckets[bidhash_find(obj->buckets, obj->capacity, id, baranium_function_manager_bucket_id)];
+}
+
+// rehashes every entry into a bucket array of the given capacity, the entries themselves stay in place
+static uint8_t baranium_function_manager_resize(baranium_function_manager* obj, size_t capacity)
+{
+    baranium_function_manager_bucket* buckets = malloc(sizeof(baranium_function_manager_bucket) * capacity);
+    if (buckets == NULL)
+        return 0;
+
+    for (size_t i = 0; i < capacity; i++)
+        buckets[i] = (baranium_function_manager_bucket){.id = BARANIUM_INVALID_INDEX};
+
+    baranium_function_manager_bucket* oldBuckets = obj->buckets;
+    size_t oldCapacity = obj->capacity;
+    obj->buckets = buckets;
+    obj->capacity = capacity;
+
+    for (size_t i = 0; i < oldCapacity; i++)
+        if (oldBuckets[i].id != BARANIUM_INVALID_INDEX)
+            *baranium_function_manager_find(obj, oldBuckets[i].id) = oldBuckets[i];
+
+    free(oldBuckets);
+    return 1;
+}
+
+// takes storage from the free list, a new slab is only allocated once every slab is in use
+static baranium_function_manager_entry* baranium_function_manager_take_entry(baranium_function_manager* obj)
+{
+    if (obj->free_list == NULL)
+    {
+        baranium_function_manager_slab* slab = malloc(sizeof(baranium_function_manager_slab));
+        if (slab == NULL)
+            return NULL;
+
+        slab->next = obj->slabs;
+        obj->slabs = slab;
+        for (size_t i = 0; i < BARANIUM_FUNCTION_MANAGER_SLAB_SIZE; i++)
+        {
+            slab->storage[i].next_free = obj->free_list;
+            obj->free_list = &slab->storage[i];
+        }
+    }
+
+    baranium_function_manager_storage* storage = obj->free_list;
+    obj->free_list = storage->next_free;
+    memset(storage, 0, sizeof(baranium_function_manager_storage));
+    return &storage->entry;
+}
+
+// hands the storage of an entry back to the free list
+static void baranium_function_manager_free_entry(baranium_function_manager* obj, baranium_function_manager_entry* entry)
+{
+    baranium_function_manager_storage* storage = (baranium_function_manager_storage*)entry;
+    storage->next_free = obj->free_list;
+    obj->free_list = storage;
+}
+
 baranium_function_manager* baranium_function_manager_init(void)
 {
     baranium_function_manager* obj = malloc(sizeof(baranium_function_manager));
     if (obj == NULL) return NULL;
 
     memset(obj, 0, sizeof(baranium_function_manager));
-    baranium_function_manager_clear(obj);
+    if (!baranium_function_manager_resize(obj, BARANIUM_FUNCTION_MANAGER_INITIAL_CAPACITY))
+    {
+        free(obj);
+        return NULL;
+    }
 
     LOGDEBUG("Created function manager");
 
@@ -24,6 +104,15 @@ void baranium_function_manager_dispose(baranium_function_manager* obj)
     LOGDEBUG("Disposing function manager with %ld entries", obj->count);
 
     baranium_function_manager_clear(obj);
+
+    for (baranium_function_manager_slab* slab = obj->slabs; slab != NULL;)
+    {
+        baranium_function_manager_slab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+
+    free(obj->buckets);
     free(obj);
 }
 
@@ -31,35 +120,57 @@ void baranium_function_manager_clear(baranium_function_manager* obj)
 {
     if (obj == NULL) return;
 
-    if (obj->buffer == NULL) return;
+    if (obj->count == 0) return;
 
     LOGDEBUG("Cleared function manager with %ld entries", obj->count);
 
-    free(obj->buffer);
-    memset(obj, 0, sizeof(baranium_function_manager));
-}
+    for (size_t i = 0; i < obj->capacity; i++)
+    {
+        if (obj->buckets[i].id == BARANIUM_INVALID_INDEX)
+            continue;
+
+        baranium_function_manager_free_entry(obj, obj->buckets[i].entry);
+        obj->buckets[i] = (baranium_function_manager_bucket){.id = BARANIUM_INVALID_INDEX};
+    }
 
-int baranium_function_manager_add_entry(baranium_function_manager* obj, index_t id, baranium_script* script, baranium_library* library);
+    obj->count = 0;
+}
 
 void baranium_function_manager_add(baranium_function_manager* obj, index_t id, baranium_script* script, baranium_library* library)
 {
     if (obj == NULL)
         return;
 
-    if (id == BARANIUM_INVALID_INDEX)
+    if (id == BARANIUM_INVALID_INDEX || (script == NULL && library == NULL))
         return;
 
-    baranium_function_manager_entry* func = baranium_function_manager_get_entry(obj, id);
-    if (func != NULL)
+    // the first script or library that defines a function keeps it
+    baranium_function_manager_bucket* bucket = baranium_function_manager_find(obj, id);
+    if (bucket->id != BARANIUM_INVALID_INDEX)
         return;
 
-    int status = baranium_function_manager_add_entry(obj, id, script, library);
-    if (status)
+    size_t capacity = bidhash_grown_capacity(obj->count, obj->capacity);
+    if (capacity != obj->capacity)
+    {
+        if (!baranium_function_manager_resize(obj, capacity))
+        {
+            LOGERROR("Could not allocate entry for function with id %ld, out of memory", id);
+            return;
+        }
+        bucket = baranium_function_manager_find(obj, id);
+    }
+
+    baranium_function_manager_entry* entry = baranium_function_manager_take_entry(obj);
+    if (entry == NULL)
     {
-        LOGERROR("Could not allocate entry for function with id %ld, status code 0x%2.2x", id, status);
+        LOGERROR("Could not allocate entry for function with id %ld, out of memory", id);
         return;
     }
 
+    *entry = (baranium_function_manager_entry){.id = id, .script = script, .library = library};
+    *bucket = (baranium_function_manager_bucket){.id = id, .entry = entry};
+    obj->count++;
+
     LOGDEBUG("Allocated entry for function with id %ld", id);
 }
 
@@ -82,86 +193,33 @@ baranium_function* baranium_function_manager_get(baranium_function_manager* obj,
 
 baranium_function_manager_entry* baranium_function_manager_get_entry(baranium_function_manager* obj, index_t id)
 {
-    if (!obj)
+    if (!obj || obj->count == 0 || id == BARANIUM_INVALID_INDEX)
         return NULL;
 
-    if (obj->buffer == NULL)
+    baranium_function_manager_bucket* bucket = baranium_function_manager_find(obj, id);
+    if (bucket->id == BARANIUM_INVALID_INDEX)
         return NULL;
 
-    for (uint64_t i = 0; i < obj->count; i++)
-    {
-        if (obj->buffer[i].id == id)
-            return &obj->buffer[i];
-    }
-
-    return NULL;
-}
-
-int baranium_function_manager_get_entry_index(baranium_function_manager* obj, index_t id)
-{
-    if (!obj)
-        return -1;
-
-    if (obj->buffer == NULL)
-        return -1;
-
-    for (uint64_t i = 0; i < obj->count; i++)
-    {
-        if (obj->buffer[i].id == id)
-            return i;
-    }
-
-    return -1;
+    return bucket->entry;
 }
 
 void baranium_function_manager_remove(baranium_function_manager* obj, index_t id)
 {
-    if (obj == NULL)
+    if (obj == NULL || obj->count == 0 || id == BARANIUM_INVALID_INDEX)
         return;
 
-    if (obj->buffer == NULL)
-        return;
-
-    int index = baranium_function_manager_get_entry_index(obj, id);
-    if (index == -1)
+    baranium_function_manager_bucket* bucket = baranium_function_manager_find(obj, id);
+    if (bucket->id == BARANIUM_INVALID_INDEX)
     {
         LOGERROR("Could not find function with id %ld", id);
         return;
     }
 
-    if ((size_t)index == obj->count-1)
-    {
-        memset(&obj->buffer[index], 0, sizeof(baranium_function_manager_entry));
-        obj->count--;
-        return;
-    }
-
-    LOGDEBUG("Disposed function with id %ld", id);
-    memset(&obj->buffer[index], 0, sizeof(baranium_function_manager_entry));
-    memmove(&obj->buffer[index], &obj->buffer[index+1], sizeof(baranium_function_manager_entry)*(obj->count - index - 1));
-
+    baranium_function_manager_free_entry(obj, bucket->entry);
+    *bucket = (baranium_function_manager_bucket){.id = BARANIUM_INVALID_INDEX};
     obj->count--;
-}
-
-int baranium_function_manager_add_entry(baranium_function_manager* obj, index_t id, baranium_script* script, baranium_library* library)
-{
-    if (obj == NULL || id == BARANIUM_INVALID_INDEX || (script == NULL && library == NULL))
-        return 1;
 
-    baranium_function_manager_entry entry = {
-        .id = id,
-        .script = script,
-        .library = library,
-    };
+    bidhash_close_hole(obj->buckets, obj->capacity, bucket - obj->buckets, baranium_function_manager_bucket_id, baranium_function_manager_move_bucket);
 
-    if (obj->buffer_size <= obj->count+1)
-    {
-        obj->buffer_size += BARANIUM_FUNCTION_MANAGER_BUFFER_SIZE;
-        obj->buffer = realloc(obj->buffer, sizeof(baranium_function_manager_entry)*obj->buffer_size);
-    }
-
-    memcpy(&obj->buffer[obj->count], &entry, sizeof(baranium_function_manager_entry));
-    obj->count++;
-
-    return 0;
+    LOGDEBUG("Disposed function with id %ld", id);
 }
@@ -0,0 +1,166 @@
+#include <baranium/backend/bindex.h>
+#include <baranium/runtime.h>
+#include <string.h>
+#include <stdlib.h>
+
+// checks that count elements of the given size at offset lie inside the image and are aligned
+static uint8_t bindex_table_fits(const bfilemap* image, uint64_t offset, uint64_t count, uint64_t size)
+{
+    if (offset % BINDEX_ALIGNMENT != 0 || offset > image->size)
+        return 0;
+
+    return count <= (image->size - offset) / size;
+}
+
+uint8_t bindex_validate(const bfilemap* image, const baranium_binary_index* index, uint64_t section_count)
+{
+    if (image == NULL || index == NULL)
+        return 0;
+
+    if (!bindex_table_fits(image, index->directory_offset, section_count, sizeof(baranium_binary_section_entry)))
+        return 0;
+
+    if (index->name_bucket_count & (index->name_bucket_count - 1))
+        return 0;
+
+    if (!bindex_table_fits(image, index->name_table_offset, index->name_bucket_count, sizeof(baranium_binary_name_bucket)))
+        return 0;
+
+    return index->dependency_offset <= image->size;
+}
+
+uint8_t bindex_read_section(const bfilemap* image, const baranium_binary_index* index, uint64_t i, size_t* offset, baranium_script_section* section)
+{
+    *section = (baranium_script_section){.type=0,.id=0,.data_size=0,.data_location=0,.data=NULL};
+
+    size_t dataOffset = 0;
+    if (index != NULL)
+    {
+        const baranium_binary_section_entry* entry = &bindex_directory(image, index)[i];
+        section->type = entry->type;
+        section->id = entry->id;
+        section->data_size = entry->data_size;
+        dataOffset = entry->data_offset;
+    }
+    else
+    {
+        if (!bfilemap_read(image, offset, &section->type, sizeof(uint8_t)) ||
+            !bfilemap_read(image, offset, &section->id, sizeof(index_t)) ||
+            !bfilemap_read(image, offset, &section->data_size, sizeof(uint64_t)))
+            return 0;
+
+        dataOffset = *offset;
+    }
+
+    const uint8_t* data = bfilemap_view(image, &dataOffset, section->data_size);
+    if (data == NULL)
+        return 0;
+
+    if (index == NULL)
+        *offset = dataOffset;
+
+    if (section->data_size == 0)
+        return 1;
+
+    section->data_location = data - image->data;
+    if (section->type != BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS)
+        section->data = (uint8_t*)data;
+
+    return 1;
+}
+
+// gets the name of a bucket, NULL if it doesn't end inside the image
+static const char* bindex_bucket_name(const bfilemap* image, const baranium_binary_name_bucket* bucket)
+{
+    if (bucket->name_offset >= image->size)
+        return NULL;
+
+    const char* name = (const char*)image->data + bucket->name_offset;
+    if (memchr(name, 0, image->size - bucket->name_offset) == NULL)
+        return NULL;
+
+    return name;
+}
+
+// finds the bucket of an id, NULL if the id isn't in the table
+static const baranium_binary_name_bucket* bindex_find_bucket(const bfilemap* image, const baranium_binary_index* index, index_t id, const char* name)
+{
+    if (index->name_bucket_count == 0 || id == BARANIUM_INVALID_INDEX)
+        return NULL;
+
+    const baranium_binary_name_bucket* buckets = (const baranium_binary_name_bucket*)(image->data + index->name_table_offset);
+    // the name table is probed like the tables of the runtime, but it comes from the binary and may be full
+    uint64_t slot = bidhash_home(id, index->name_bucket_count);
+    for (uint64_t i = 0; i < index->name_bucket_count; i++, slot = bidhash_next(slot, index->name_bucket_count))
+    {
+        const baranium_binary_name_bucket* bucket = &buckets[slot];
+        if (bucket->id == BARANIUM_INVALID_INDEX)
+            return NULL;
+        if (bucket->id != id)
+            continue;
+
+        // different names can share an id, only the name itself tells them apart
+        const char* bucketName = bindex_bucket_name(image, bucket);
+        if (bucketName != NULL && (name == NULL || strcmp(bucketName, name) == 0))
+            return bucket;
+    }
+
+    return NULL;
+}
+
+index_t bindex_find_name(const bfilemap* image, const baranium_binary_index* index, const char* name)
+{
+    if (image == NULL || index == NULL || name == NULL)
+        return BARANIUM_INVALID_INDEX;
+
+    const baranium_binary_name_bucket* bucket = bindex_find_bucket(image, index, baranium_get_id_of_name(name), name);
+    return bucket ? bucket->id : BARANIUM_INVALID_INDEX;
+}
+
+const char* bindex_name_of(const bfilemap* image, const baranium_binary_index* index, index_t id)
+{
+    if (image == NULL || index == NULL)
+        return NULL;
+
+    const baranium_binary_name_bucket* bucket = bindex_find_bucket(image, index, id, NULL);
+    return bucket ? bindex_bucket_name(image, bucket) : NULL;
+}
+
+static int bindex_compare_sections(const void* a, const void* b)
+{
+    index_t lhs = ((const baranium_script_section*)a)->id;
+    index_t rhs = ((const baranium_script_section*)b)->id;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+void bindex_sort_sections(baranium_script_section* sections, uint64_t count)
+{
+    if (sections == NULL || count < 2)
+        return;
+
+    qsort(sections, count, sizeof(baranium_script_section), bindex_compare_sections);
+}
+
+baranium_script_section* bindex_find_section(baranium_script_section* sections, uint64_t count, index_t id, baranium_script_section_type_t type)
+{
+    if (sections == NULL)
+        return NULL;
+
+    // find the first section with the id, sections of different types may share it
+    uint64_t low = 0;
+    uint64_t high = count;
+    while (low < high)
+    {
+        uint64_t middle = low + (high - low) / 2;
+        if (sections[middle].id < id)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    for (; low < count && sections[low].id == id; low++)
+        if (type == BARANIUM_SCRIPT_SECTION_TYPE_INVALID || sections[low].type == type)
+            return &sections[low];
+
+    return NULL;
+}
@@ -0,0 +1,123 @@
+#include <baranium/backend/bstring.h>
+#include <memory.h>
+#include <stdlib.h>
+
+// preallocated string, laid out exactly like a heap string
+typedef struct bstring_small
+{
+    bstring_header header;
+    char data[2];
+} bstring_small;
+
+// the empty string and every single character string, so short strings never hit the allocator
+static bstring_small bstring_small_strings[0x101];
+static uint8_t bstring_small_strings_initialized = 0;
+
+static char* bstring_get_small(const char* data, size_t length)
+{
+    if (!bstring_small_strings_initialized)
+    {
+        for (size_t i = 0; i < 0x101; i++)
+        {
+            bstring_small_strings[i].header = (bstring_header){.refcount = BSTRING_IMMORTAL, .length = i != 0};
+            bstring_small_strings[i].data[0] = (char)(i - 1);
+            bstring_small_strings[i].data[1] = 0;
+        }
+        bstring_small_strings[0].data[0] = 0;
+        bstring_small_strings_initialized = 1;
+    }
+
+    if (length == 0)
+        return bstring_small_strings[0].data;
+
+    return bstring_small_strings[1 + (data ? (uint8_t)data[0] : 0)].data;
+}
+
+char* bstring_alloc(size_t length)
+{
+    if (length >= UINT32_MAX)
+        return NULL;
+
+    bstring_header* header = malloc(sizeof(bstring_header) + length + 1);
+    if (header == NULL)
+        return NULL;
+
+    header->refcount = 1;
+    header->length = length;
+
+    char* str = (char*)(header + 1);
+    str[length] = 0;
+    return str;
+}
+
+char* bstring_create(const char* data, size_t length)
+{
+    if (length <= 1)
+        return bstring_get_small(data, length);
+
+    char* str = bstring_alloc(length);
+    if (str == NULL)
+        return NULL;
+
+    if (data != NULL)
+        memcpy(str, data, length);
+    else
+        memset(str, 0, length);
+
+    return str;
+}
+
+char* bstring_append(char* str, const char* data, size_t length)
+{
+    if (str == NULL)
+        return bstring_create(data, length);
+
+    if (length == 0)
+        return str;
+
+    bstring_header* header = BSTRING_HEADER(str);
+    size_t oldLength = header->length;
+    if (header->refcount != 1)
+    {
+        char* result = bstring_join(str, oldLength, data, length);
+        if (result != NULL)
+            bstring_release(str);
+        return result;
+    }
+
+    if (oldLength + length >= UINT32_MAX)
+        return NULL;
+
+    // nobody else can see the string, so it can grow in place
+    header = realloc(header, sizeof(bstring_header) + oldLength + length + 1);
+    if (header == NULL)
+        return NULL;
+
+    str = (char*)(header + 1);
+    memcpy(str + oldLength, data, length);
+    header->length = oldLength + length;
+    str[header->length] = 0;
+    return str;
+}
+
+char* bstring_join(const char* lhs, size_t lhsLength, const char* rhs, size_t rhsLength)
+{
+    if (lhsLength + rhsLength <= 1)
+        return bstring_get_small(lhsLength ? lhs : rhs, lhsLength + rhsLength);
+
+    char* str = bstring_alloc(lhsLength + rhsLength);
+    if (str == NULL)
+        return NULL;
+
+    memcpy(str, lhs, lhsLength);
+    memcpy(str + lhsLength, rhs, rhsLength);
+    return str;
+}
+
+void bstring_free(char* str)
+{
+    if (str == NULL || BSTRING_HEADER(str)->refcount == BSTRING_IMMORTAL)
+        return;
+
+    free(BSTRING_HEADER(str));
+}
@@ -1,23 +1,84 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_VARMGR
+
 #include <baranium/backend/bvarmgr.h>
+#include <baranium/backend/bidhash.h>
+#include <baranium/backend/bstring.h>
 #include <baranium/logging.h>
 #include <memory.h>
 #include <stdlib.h>
 
-void bvarmgr_n_free(bvarmgr_n* obj)
+// releases the string of a variable/field, the storage itself goes back to the free list and the slot stays linked
+static void bvarmgr_n_free(bvarmgr* obj, bvarmgr_n* entry)
 {
-    if (!obj)
-        return;
+    baranium_variable_type_t type = entry->isVariable ? entry->variable->type : entry->field->type;
+    baranium_value_t* value = entry->isVariable ? &entry->variable->value : &entry->field->value;
+    if (type == BARANIUM_VARIABLE_TYPE_STRING)
+        bstring_release(value->ptr);
 
-    if (obj->isVariable && obj->variable)
-    {
-        baranium_variable_dispose(obj->variable);
-    }
-    else
+    bvarmgr_storage* storage = entry->isVariable ? (bvarmgr_storage*)entry->variable : (bvarmgr_storage*)entry->field;
+    storage->next_free = obj->free_list;
+    obj->free_list = storage;
+
+    entry->variable = NULL;
+    entry->field = NULL;
+    entry->isVariable = 0;
+}
+
+// takes storage from the free list, a new slab is only allocated once every slab is in use
+static bvarmgr_storage* bvarmgr_take_storage(bvarmgr* obj)
+{
+    if (obj->free_list == NULL)
     {
-        if (obj->field)
-            baranium_field_dispose(obj->field);
+        bvarmgr_slab* slab = malloc(sizeof(bvarmgr_slab));
+        if (slab == NULL)
+            return NULL;
+
+        slab->next = obj->slabs;
+        obj->slabs = slab;
+        for (size_t i = 0; i < BVARMGR_SLAB_SIZE; i++)
+        {
+            slab->storage[i].next_free = obj->free_list;
+            obj->free_list = &slab->storage[i];
+        }
     }
-    free(obj);
+
+    bvarmgr_storage* storage = obj->free_list;
+    obj->free_list = storage->next_free;
+    memset(storage, 0, sizeof(bvarmgr_storage));
+    return storage;
+}
+
+static index_t bvarmgr_bucket_id(const void* table, size_t bucket)
+{
+    const bvarmgr* obj = table;
+    size_t slot = obj->buckets[bucket];
+    return slot == BVARMGR_NO_SLOT ? BARANIUM_INVALID_INDEX : obj->slots[slot].id;
+}
+
+// finds the bucket of an id, or the empty bucket the id would go into
+static size_t* bvarmgr_find(bvarmgr* obj, index_t id)
+{
+    return &obj->buckets[bidhash_find(obj, obj->capacity, id, bvarmgr_bucket_id)];
+}
+
+// rehashes every slot into a bucket array of the given capacity, the slots themselves stay in place
+static uint8_t bvarmgr_resize(bvarmgr* obj, size_t capacity)
+{
+    size_t* buckets = malloc(sizeof(size_t) * capacity);
+    if (buckets == NULL)
+        return 0;
+
+    for (size_t i = 0; i < capacity; i++)
+        buckets[i] = BVARMGR_NO_SLOT;
+
+    free(obj->buckets);
+    obj->buckets = buckets;
+    obj->capacity = capacity;
+
+    for (size_t i = 0; i < obj->slot_count; i++)
+        *bvarmgr_find(obj, obj->slots[i].id) = i;
+
+    return 1;
 }
 
 bvarmgr* bvarmgr_init(void)
@@ -26,11 +87,11 @@ bvarmgr* bvarmgr_init(void)
     if (obj == NULL) return NULL;
 
     memset(obj, 0, sizeof(bvarmgr));
-    bvarmgr_clear(obj);
-
-    obj->start = NULL;
-    obj->end = NULL;
-    obj->count = 0;
+    if (!bvarmgr_resize(obj, BVARMGR_INITIAL_CAPACITY))
+    {
+        free(obj);
+        return NULL;
+    }
 
     LOGDEBUG("Created variable manager");
 
@@ -44,6 +105,16 @@ void bvarmgr_dispose(bvarmgr* obj)
     LOGDEBUG("Disposing variable manager with %ld entries", obj->count);
 
     bvarmgr_clear(obj);
+
+    for (bvarmgr_slab* slab = obj->slabs; slab != NULL;)
+    {
+        bvarmgr_slab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+
+    free(obj->buckets);
+    free(obj->slots);
     free(obj);
 }
 
@@ -51,24 +122,18 @@ void bvarmgr_clear(bvarmgr* obj)
 {
     if (obj == NULL) return;
 
-    if (obj->start == NULL) return;
+    if (obj->count == 0) return;
 
     LOGDEBUG("Cleared variable manager with %ld entries", obj->count);
 
-    bvarmgr_n* next = NULL;
-    for (bvarmgr_n* ptr = obj->start; ptr != NULL;)
-    {
-        next = ptr->next;
-        bvarmgr_n_free(ptr);
-        ptr = next;
-    }
+    // the slots stay linked, code may still refer to them
+    for (size_t i = 0; i < obj->slot_count; i++)
+        if (obj->slots[i].variable != NULL || obj->slots[i].field != NULL)
+            bvarmgr_n_free(obj, &obj->slots[i]);
 
-    obj->start = obj->end = NULL;
     obj->count = 0;
 }
 
-int bvarmgr_add(bvarmgr* obj, baranium_variable* var, baranium_field* field);
-
 void bvarmgr_alloc(bvarmgr* obj, baranium_variable_type_t type, index_t id, size_t size, uint8_t isField)
 {
     if (obj == NULL)
@@ -77,196 +142,125 @@ void bvarmgr_alloc(bvarmgr* obj, baranium_variable_type_t type, index_t id, size
     if (type == BARANIUM_VARIABLE_TYPE_INVALID || type == BARANIUM_VARIABLE_TYPE_VOID)
         return;
 
-    baranium_value_t value = {0};
-    if (type == BARANIUM_VARIABLE_TYPE_STRING)
+    if (id == BARANIUM_INVALID_INDEX)
     {
-        value.ptr = malloc(size);
-        if (value.ptr == NULL)
-            return;
-        memset(value.ptr, 0, size);
+        LOGERROR("Could not allocate %s with invalid id", isField ? "field" : "variable");
+        return;
     }
 
-    baranium_variable* variable = NULL;
-    baranium_field* field = NULL;
-    if (!isField)
+    size_t slot = bvarmgr_link(obj, id);
+    if (slot == BVARMGR_NO_SLOT)
     {
-        variable = malloc(sizeof(baranium_variable));
-        if (variable == NULL)
-            return;
-
-        memset(variable, 0, sizeof(baranium_variable));
-        variable->id= id;
-        variable->type = type;
-        variable->size = size;
-        variable->value = value;
+        LOGERROR("Could not allocate %s with id %ld and size %ld, out of memory", isField ? "field" : "variable", id, size);
+        return;
     }
-    else
+
+    baranium_value_t value = {0};
+    if (type == BARANIUM_VARIABLE_TYPE_STRING)
     {
-        field = malloc(sizeof(baranium_field));
-        if (field == NULL)
+        value.ptr = bstring_create(NULL, size);
+        if (value.ptr == NULL)
             return;
+    }
 
-        memset(field, 0, sizeof(baranium_field));
-        field->id = id;
-        field->type = type;
-        field->size = size;
-        field->value = value;
+    // allocating an existing id again starts it over with the new type and size
+    bvarmgr_n* entry = &obj->slots[slot];
+    if (entry->variable != NULL || entry->field != NULL)
+    {
+        LOGDEBUG("Reallocating %s with id %ld", isField ? "field" : "variable", id);
+        bvarmgr_n_free(obj, entry);
+        obj->count--;
     }
 
-    int status = bvarmgr_add(obj, variable, field);
-    if (status)
+    bvarmgr_storage* storage = bvarmgr_take_storage(obj);
+    if (storage == NULL)
     {
         if (type == BARANIUM_VARIABLE_TYPE_STRING)
-            free(value.ptr);
-        LOGERROR("Could not allocate %s with id %ld and size %ld, status code 0x%2.2x", isField ? "field" : "variable", id, size, status);
+            bstring_release(value.ptr);
+        LOGERROR("Could not allocate %s with id %ld and size %ld, out of memory", isField ? "field" : "variable", id, size);
         return;
     }
 
+    entry->isVariable = !isField;
+    if (!isField)
+    {
+        entry->variable = &storage->variable;
+        entry->variable->id = id;
+        entry->variable->type = type;
+        entry->variable->size = size;
+        entry->variable->value = value;
+    }
+    else
+    {
+        entry->field = &storage->field;
+        entry->field->id = id;
+        entry->field->type = type;
+        entry->field->size = size;
+        entry->field->value = value;
+    }
+    obj->count++;
+
     LOGDEBUG("Allocated %s with id %ld and size %ld", isField ? "field" : "variable", id, size);
 }
 
 bvarmgr_n* bvarmgr_get(bvarmgr* obj, index_t id)
 {
-    if (!obj)
+    if (!obj || obj->count == 0 || id == BARANIUM_INVALID_INDEX)
         return NULL;
 
-    if (!obj->start)
-        return NULL;
-
-    bvarmgr_n* entry = obj->start;
-    for (; entry != NULL; entry = entry->next)
-    {
-        if (entry->variable != NULL)
-            if (entry->variable->id == id)
-                break;
-
-        if (entry->field != NULL)
-            if (entry->field->id == id)
-                break;
-    }
-
-    if (!entry)
+    size_t slot = *bvarmgr_find(obj, id);
+    if (slot == BVARMGR_NO_SLOT)
         return NULL;
 
-    return entry;
-}
-
-uint8_t bvarmgr_entry_matches(bvarmgr_n* a, index_t id)
-{
-    if (a->variable != NULL)
-        return a->variable->id == id;
-
-    if (a->field != NULL)
-        return a->field->id == id;
-
-    return -1;
+    return bvarmgr_get_slot(obj, slot);
 }
 
-void bvarmgr_dealloc(bvarmgr* obj, index_t id)
+size_t bvarmgr_link(bvarmgr* obj, index_t id)
 {
-    if (obj == NULL)
-        return;
+    if (!obj || id == BARANIUM_INVALID_INDEX)
+        return BVARMGR_NO_SLOT;
 
-    if (obj->start == NULL)
-        return;
+    size_t* bucket = bvarmgr_find(obj, id);
+    if (*bucket != BVARMGR_NO_SLOT)
+        return *bucket;
 
-    bvarmgr_n* foundEntry = NULL;
-    for (bvarmgr_n* entry = obj->start; entry != NULL; entry = entry->next)
+    if (obj->slot_count == obj->slot_capacity)
     {
-        if (!bvarmgr_entry_matches(entry, id))
-            continue;
+        size_t capacity = obj->slot_capacity ? obj->slot_capacity * 2 : BVARMGR_INITIAL_CAPACITY;
+        bvarmgr_n* slots = realloc(obj->slots, sizeof(bvarmgr_n) * capacity);
+        if (slots == NULL)
+            return BVARMGR_NO_SLOT;
 
-        foundEntry = entry;
-        break;
+        obj->slots = slots;
+        obj->slot_capacity = capacity;
     }
 
-    if (!foundEntry)
+    size_t capacity = bidhash_grown_capacity(obj->slot_count, obj->capacity);
+    if (capacity != obj->capacity)
     {
-        LOGERROR("Could not find variable with id %ld", id);
-        return;
+        if (!bvarmgr_resize(obj, capacity))
+            return BVARMGR_NO_SLOT;
+        bucket = bvarmgr_find(obj, id);
     }
 
-    bvarmgr_n* prev = foundEntry->prev;
-    bvarmgr_n* next = foundEntry->next;
+    size_t slot = obj->slot_count++;
+    obj->slots[slot] = (bvarmgr_n){.id = id};
+    *bucket = slot;
 
-    if (foundEntry == obj->start && foundEntry == obj->end)
-    {
-        obj->start = obj->end = NULL;
-        goto destroy;
-    }
-    else if (foundEntry == obj->start)
-    {
-        next->prev = NULL;
-        obj->start = next;
-        foundEntry->next = NULL;
-        goto destroy;
-    }
-    else if (foundEntry == obj->end)
-    {
-        prev->next = NULL;
-        obj->end = prev;
-        foundEntry->prev = NULL;
-        goto destroy;
-    }
-
-    if (next)
-        next->prev = prev;
-
-    if (prev)
-        prev->next = next;
-
-    foundEntry->next = NULL;
-    foundEntry->prev = NULL;
-
-destroy:
-    obj->count--;
-    LOGDEBUG("Disposed variable with id %ld", id);
-    bvarmgr_n_free(foundEntry);
+    return slot;
 }
 
-int bvarmgr_add(bvarmgr* obj, baranium_variable* var, baranium_field* field)
+void bvarmgr_dealloc(bvarmgr* obj, index_t id)
 {
-    if (obj == NULL || (var == NULL && field == NULL))
-        return 1;
-
-    if (obj->start == NULL)
-    {
-        obj->start = malloc(sizeof(bvarmgr_n));
-        if (!obj->start)
-        {
-            baranium_variable_dispose(var);
-            baranium_field_dispose(field);
-            return 2;
-        }
-        memset(obj->start, 0, sizeof(bvarmgr_n));
-        obj->start->prev = NULL;
-        obj->start->next = NULL;
-        obj->start->variable = var;
-        obj->start->field = field;
-        obj->start->isVariable = field == NULL;
-        obj->end = obj->start;
-        obj->count = 1;
-        return 0;
-    }
-
-    bvarmgr_n* newEntry = malloc(sizeof(bvarmgr_n));
-    if (!newEntry)
+    bvarmgr_n* entry = bvarmgr_get(obj, id);
+    if (!entry)
     {
-        baranium_variable_dispose(var);
-        baranium_field_dispose(field);
-        return 2;
+        LOGERROR("Could not find variable with id %ld", id);
+        return;
     }
-    memset(newEntry, 0, sizeof(bvarmgr_n));
-    newEntry->prev = obj->end;
-    newEntry->variable = var;
-    newEntry->field = field;
-    newEntry->isVariable = field == NULL;
-    newEntry->next = NULL;
-
-    obj->end->next = newEntry;
 
-    obj->end = newEntry;
-    obj->count++;
+    bvarmgr_n_free(obj, entry);
+    obj->count--;
 
-    return 0;
+    LOGDEBUG("Disposed variable with id %ld", id);
 }
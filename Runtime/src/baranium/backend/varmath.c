@@ -1,4 +1,5 @@
 #include <baranium/backend/varmath.h>
+#include <baranium/backend/bstring.h>
 #include <baranium/backend/errors.h>
 #include <baranium/cpu/bstack.h>
 #include <baranium/variable.h>
@@ -33,41 +34,30 @@ baranium_compiled_variable* baranium_compiled_variable_pop_from_stack(bcpu* cpu)
     return result;
 }
 
-void baranium_compiled_variable_pop_from_stack_into_variable(bcpu* cpu, baranium_compiled_variable* output)
+// pops a value that was pushed as plain words (data words, size, type) by binaries of older compilers
+static void baranium_compiled_variable_pop_legacy(bcpu* cpu, baranium_compiled_variable* output, uint64_t type)
 {
-    if (cpu == NULL)
-        return;
-
-    if (!output)
-        return;
-
-    baranium_variable_type_t oldType = output->type;
-    output->type = (baranium_variable_type_t)bstack_pop(cpu->stack);
+    output->type = (baranium_variable_type_t)type;
     size_t size = output->size = (size_t)bstack_pop(cpu->stack);
+    output->value.num64 = 0;
+
+    // strings are collected in a scratch buffer first, runtime strings are never written to once created
+    uint8_t* buffer = NULL;
+    void* basevalue = &output->value.num64;
     if (output->type == BARANIUM_VARIABLE_TYPE_STRING)
     {
-        if (output->type != oldType)
-            output->value.ptr = malloc(output->size+1);
-        else
-            output->value.ptr = realloc(output->value.ptr, output->size+1);
-
-        if (output->value.ptr == NULL)
+        buffer = malloc(size + sizeof(uint64_t));
+        if (buffer == NULL)
         {
             bstack_push(cpu->stack, BARANIUM_ERROR_OUT_OF_MEMORY);
             cpu->flags.FORCED_KILL = 1;
             cpu->kill_triggered = 1;
             return;
         }
-
-        ((uint8_t*)output->value.ptr)[output->size] = 0;
+        basevalue = buffer;
     }
 
     uint64_t data = 0;
-
-    void* basevalue = &output->value.num64;
-    if (output->type == BARANIUM_VARIABLE_TYPE_STRING)
-        basevalue = output->value.ptr;
-
     if (size <= 8)
     {
         data = bstack_pop(cpu->stack);
@@ -91,47 +81,76 @@ void baranium_compiled_variable_pop_from_stack_into_variable(bcpu* cpu, baranium
             memcpy(valPtr, &data, 8);
             leftOverSize-=8;
         }
-        leftOverSize=0;
+    }
+
+    if (buffer == NULL)
+        return;
+
+    output->value.ptr = bstring_create((const char*)buffer, size);
+    free(buffer);
+    if (output->value.ptr == NULL)
+    {
+        bstack_push(cpu->stack, BARANIUM_ERROR_OUT_OF_MEMORY);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
     }
 }
 
-void baranium_compiled_variable_push_to_stack(bcpu* cpu, baranium_compiled_variable* var)
+void baranium_compiled_variable_pop_from_stack_into_variable(bcpu* cpu, baranium_compiled_variable* output)
 {
-    baranium_variable_type_t type = var->type;
-    uint64_t size = var->size;
-    void* value = &var->value.num64;
-    if (type == BARANIUM_VARIABLE_TYPE_STRING)
-        value = var->value.ptr;
+    if (cpu == NULL)
+        return;
 
-    uint64_t data = 0;
-    if (size <= 8)
+    if (!output)
+        return;
+
+    // the previous value of the output is overwritten, string data of the popped value is now owned by the output
+    bstack_slot slot = bstack_pop_slot(cpu->stack);
+    if (slot.type == BSTACK_SLOT_TYPE_RAW)
     {
-        memcpy(&data, value, size);
-        bstack_push(cpu->stack, data);
+        baranium_compiled_variable_pop_legacy(cpu, output, slot.data);
+        return;
     }
-    else
-    {
 
-        size_t leftOverSize = size;
-        size_t index = 0;
-        void* valPtr;
-        for (index = 0; index * 8 < size; index++)
+    output->type = slot.type;
+    output->size = slot.size;
+    output->value.num64 = slot.data;
+}
+
+void baranium_compiled_variable_push_to_stack(bcpu* cpu, baranium_compiled_variable* var)
+{
+    bstack_slot slot = {.data = 0, .size = var->size, .type = var->type};
+
+    if (var->type == BARANIUM_VARIABLE_TYPE_STRING)
+    {
+        // the string may come from outside of the runtime, so the stack gets its own runtime string
+        char* str = bstring_create(var->value.ptr, var->value.ptr != NULL ? var->size : 0);
+        if (str == NULL)
         {
-            if (leftOverSize < 8)
-                break;
-            valPtr = (void*)((uint64_t)value + index*8);
-            memcpy(&data, valPtr, 8);
-            leftOverSize -= 8;
-            bstack_push(cpu->stack, data);
+            bstack_push(cpu->stack, BARANIUM_ERROR_OUT_OF_MEMORY);
+            cpu->flags.FORCED_KILL = 1;
+            cpu->kill_triggered = 1;
+            return;
         }
-        valPtr = (void*)((uint64_t)value + index*8);
-        data = 0;
-        memcpy(&data, valPtr, leftOverSize);
-        bstack_push(cpu->stack, data);
+
+        slot.data = (uint64_t)str;
+        slot.size = bstring_length(str);
     }
+    else
+        memcpy(&slot.data, &var->value.num64, var->size < sizeof(uint64_t) ? var->size : sizeof(uint64_t));
 
-    bstack_push(cpu->stack, (uint64_t)size);
-    bstack_push(cpu->stack, (uint64_t)type);
+    bstack_push_slot(cpu->stack, slot);
+}
+
+void baranium_compiled_variable_push_reference_to_stack(bcpu* cpu, baranium_compiled_variable* var)
+{
+    if (var->type != BARANIUM_VARIABLE_TYPE_STRING)
+    {
+        baranium_compiled_variable_push_to_stack(cpu, var);
+        return;
+    }
+
+    bstack_push_slot(cpu->stack, (bstack_slot){.data = (uint64_t)bstring_retain(var->value.ptr), .size = bstring_length(var->value.ptr), .type = var->type});
 }
 
 void baranium_compiled_variable_dispose(baranium_compiled_variable* varptr)
@@ -491,7 +510,7 @@ int baranium_compiled_variable_as_float(baranium_compiled_variable* var)
     int result = 1;
 
     if (var->type == BARANIUM_VARIABLE_TYPE_INT32)
-        val = (float)var->value.num32;
+        val = (float)var->value.snum32;
     else if (var->type == BARANIUM_VARIABLE_TYPE_UINT32)
         val = (float)var->value.num32;
     else if (var->type == BARANIUM_VARIABLE_TYPE_STRING && string_is_number(var->value.str))
@@ -524,7 +543,7 @@ int baranium_compiled_variable_as_double(baranium_compiled_variable* var)
     int result = 1;
 
     if (var->type == BARANIUM_VARIABLE_TYPE_INT32)
-        val = (double)var->value.num32;
+        val = (double)var->value.snum32;
     else if (var->type == BARANIUM_VARIABLE_TYPE_UINT32)
         val = (double)var->value.num32;
     else if (var->type == BARANIUM_VARIABLE_TYPE_STRING && string_is_number(var->value.str))
@@ -824,7 +843,7 @@ int baranium_compiled_variable_as_int64(baranium_compiled_variable* var)
     else if (var->type == BARANIUM_VARIABLE_TYPE_FLOAT)
         val = (int64_t)var->value.numfloat;
     else if (var->type == BARANIUM_VARIABLE_TYPE_INT32)
-        val = (int64_t)var->value.num32;
+        val = (int64_t)var->value.snum32;
     else if (var->type == BARANIUM_VARIABLE_TYPE_UINT32)
         val = (int64_t)var->value.num32;
     else if (var->type == BARANIUM_VARIABLE_TYPE_STRING && string_is_number(var->value.str))
@@ -861,7 +880,7 @@ int baranium_compiled_variable_as_uint64(baranium_compiled_variable* var)
     else if (var->type == BARANIUM_VARIABLE_TYPE_FLOAT)
         val = (uint64_t)var->value.numfloat;
     else if (var->type == BARANIUM_VARIABLE_TYPE_INT32)
-        val = (uint64_t)var->value.num32;
+        val = (uint64_t)var->value.snum32;
     else if (var->type == BARANIUM_VARIABLE_TYPE_UINT32)
         val = (uint64_t)var->value.num32;
     else if (var->type == BARANIUM_VARIABLE_TYPE_STRING && string_is_number(var->value.str))
@@ -924,23 +943,20 @@ void baranium_compiled_variable_convert_to_type(baranium_compiled_variable* var,
         status = baranium_compiled_variable_as_uint64(var);
     else if (targetType == BARANIUM_VARIABLE_TYPE_STRING)
     {
-        char* stringifiedVersion = baranium_variable_stringify(var->type, var->value);
-        size_t stringSize = strlen(stringifiedVersion);
+        const char* stringifiedVersion = baranium_variable_stringify(var->type, var->value);
         if (!stringifiedVersion)
             return;
-        if (var->type == BARANIUM_VARIABLE_TYPE_STRING)
-            var->value.ptr = realloc(var->value.ptr, stringSize+1);
-        else
-            var->value.ptr = malloc(stringSize+1);
-        memcpy(var->value.ptr, stringifiedVersion, stringSize);
-        ((uint8_t*)var->value.ptr)[stringSize] = 0;
-        var->size = strlen(var->value.ptr);
+        char* str = bstring_create(stringifiedVersion, strlen(stringifiedVersion));
+        if (str == NULL)
+            return;
+        var->value.ptr = str;
+        var->size = bstring_length(str);
         var->type = targetType;
         return;
     }
 
-    if (oldType == BARANIUM_VARIABLE_TYPE_STRING && oldValue.ptr != NULL)
-        free(oldValue.ptr);
+    if (oldType == BARANIUM_VARIABLE_TYPE_STRING)
+        bstring_release(oldValue.ptr);
 
     if (status)
         var->type = targetType;
@@ -969,29 +985,37 @@ void baranium_compiled_variable_combine(baranium_compiled_variable* lhs, baraniu
 
     if (operation == BARANIUM_VARIABLE_OPERATION_ADD && resultType == BARANIUM_VARIABLE_TYPE_STRING) // very special case
     {
-        baranium_compiled_variable* string = lhs;
-        baranium_compiled_variable* non_string = rhs;
-        if (rhs->type == BARANIUM_VARIABLE_TYPE_STRING)
+        if (lhs->type == BARANIUM_VARIABLE_TYPE_STRING)
         {
-            string = rhs;
-            non_string = lhs;
+            const char* string1 = baranium_variable_stringify(rhs->type, rhs->value);
+            size_t length = rhs->type == BARANIUM_VARIABLE_TYPE_STRING ? bstring_length(string1) : strlen(string1);
+            char* result = bstring_append(lhs->value.ptr, string1, length);
+            if (result == NULL)
+            {
+                LOGERROR("Could not combine strings, out of memory");
+                return;
+            }
+            lhs->value.ptr = result;
+            lhs->size = bstring_length(result);
+            return;
         }
 
-        char* string1 = baranium_variable_stringify(non_string->type, non_string->value);
-        size_t size = strlen(string->value.str) + strlen(string1) + 1;
-        string->value.ptr = realloc(string->value.ptr, size);
-        memcpy(string->value.str + strlen(string->value.str), string1, strlen(string1));
-        string->value.str[size-1] = 0;
-        string->type = BARANIUM_VARIABLE_TYPE_STRING;
-        string->size = size;
-
-        // lhs is always the resulting output
-        if (string == rhs)
+        // only the right side is a string, so the left side has to be put in front of it
+        const char* string1 = baranium_variable_stringify(lhs->type, lhs->value);
+        char* result = bstring_join(string1, strlen(string1), rhs->value.ptr, bstring_length(rhs->value.ptr));
+        if (result == NULL)
         {
-            baranium_compiled_variable tmp = *rhs;
-            *rhs = *lhs;
-            *lhs = tmp;
+            LOGERROR("Could not combine strings, out of memory");
+            return;
         }
+        bstring_release(rhs->value.ptr);
+        rhs->value.ptr = result;
+        rhs->size = bstring_length(result);
+
+        // lhs is always the resulting output
+        baranium_compiled_variable tmp = *rhs;
+        *rhs = *lhs;
+        *lhs = tmp;
         return;
     }
 
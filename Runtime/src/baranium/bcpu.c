@@ -1,12 +1,12 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_CPU
+
 #include <baranium/cpu/bcpu_opcodes.h>
+#include <baranium/cpu/bcode.h>
 #include <baranium/logging.h>
 #include <baranium/bcpu.h>
 #include <stdlib.h>
 #include <memory.h>
 
-// function references (all declared at the end of this file)
-uint64_t _bcpu_fetch(bcpu* obj, int bits);
-
 // initializes the cpu with the requered function pointers and also sets the bus of the cpu
 bcpu* bcpu_init(baranium_runtime* runtime)
 {
@@ -15,8 +15,6 @@ bcpu* bcpu_init(baranium_runtime* runtime)
         return NULL;
 
     memset(obj, 0, sizeof(bcpu));
-    obj->fetched = 0;
-    obj->fetch = _bcpu_fetch;
     obj->ticks = 0;
     obj->kill_triggered = 0;
     obj->runtime = runtime;
@@ -31,30 +29,26 @@ void bcpu_dispose(bcpu* obj)
         return;
 
     bstack_dispose(obj->stack);
-    bstack_dispose(obj->ip_stack);
+    bstack_dispose(obj->locals);
     bbus_dispose(obj->bus);
+    free(obj->frames);
 
     free(obj);
 }
 
-// this is the method which executes the instructions from the IP value forward
-void bcpu_tick(bcpu* obj)
+// runs the function attached to the bus until it returns or the cpu gets killed
+void bcpu_run(bcpu* obj)
 {
     if (obj == NULL)
         return;
 
-    if (bbus_eof(obj->bus, obj->ip))
+    if (obj->bus == NULL || obj->bus->data_holder == NULL || obj->bus->data_holder->code == NULL)
     {
         obj->kill_triggered = 1;
         return;
     }
 
-    obj->opcode = bbus_read(obj->bus, obj->ip);
-    LOGDEBUG("IP: 0x%2.16x | Ticks (total): 0x%2.16x | Opcode: 0x%2.2x | Instruction: '%s'",
-               obj->ip, obj->ticks, obj->opcode, opcodes[obj->opcode].name);
-    obj->ip++;
-    opcodes[obj->opcode].handle(obj);
-    obj->ticks++;
+    bcpu_opcodes_execute(obj);
 }
 
 // resets the cpu
@@ -65,34 +59,58 @@ void bcpu_reset(bcpu* obj)
 
     obj->ip = 0;
     obj->stack = bstack_init();
-    obj->ip_stack = bstack_init();
+    obj->locals = bstack_init();
+    obj->frame = 0;
+    obj->frames = NULL;
+    obj->frame_count = 0;
+    obj->frame_capacity = 0;
+    obj->frame_base = 0;
     obj->flags.CMP = 1;
     obj->flags.RESERVED = 0;
     obj->ticks = 0;
     obj->bus = bbus_init(NULL);
 }
 
-uint64_t _bcpu_fetch(bcpu* obj, int bits)
+// saves the state of the current function before calling another function
+uint8_t bcpu_push_frame(bcpu* obj)
 {
-    if (obj == NULL)
-        return 0;
-
-    if (bits > 64 || bits % 8 != 0)
+    if (obj->frame_count == obj->frame_capacity)
     {
-        obj->kill_triggered = 1;
-        return 0;
-    }
-    int bytes = bits / 8;
-    int bitindex = bits - 8;
+        size_t capacity = obj->frame_capacity ? obj->frame_capacity * 2 : BCPU_INITIAL_FRAME_CAPACITY;
+        bcpu_frame* frames = realloc(obj->frames, sizeof(bcpu_frame) * capacity);
+        if (frames == NULL)
+            return 0;
 
-    obj->fetched = 0;
-    for (int i = 0; i < bytes; i++)
-    {
-        uint64_t data = bbus_read(obj->bus, obj->ip);
-        obj->fetched |= data << bitindex;
-        bitindex -= 8;
-        obj->ip++;
+        obj->frames = frames;
+        obj->frame_capacity = capacity;
     }
 
-    return obj->fetched;
+    obj->frames[obj->frame_count++] = (bcpu_frame){
+        .function = obj->bus->data_holder,
+        .ip = obj->ip,
+        .frame = obj->frame,
+    };
+
+    return 1;
+}
+
+// drops the locals of the current function and continues with the calling function
+void bcpu_pop_frame(bcpu* obj)
+{
+    bcpu_frame* caller = &obj->frames[--obj->frame_count];
+    bstack_truncate(obj->locals, obj->frame);
+    obj->bus->data_holder = caller->function;
+    obj->ip = caller->ip;
+    obj->frame = caller->frame;
+}
+
+// starts executing a function from the beginning
+void bcpu_enter_function(bcpu* obj, baranium_function* function)
+{
+    obj->bus->data_holder = function;
+    obj->ip = 0;
+
+    // verified code knows how many values it pushes, so the stack grows once here instead of while it runs
+    if (function->code != NULL && function->code->verified)
+        bstack_reserve(obj->stack, function->code->max_stack);
 }
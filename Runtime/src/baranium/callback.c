@@ -1,3 +1,5 @@
+#include <baranium/backend/bfunccache.h>
+#include <baranium/backend/bidhash.h>
 #include <baranium/runtime.h>
 #include <baranium/callback.h>
 #include <baranium/logging.h>
@@ -21,6 +23,74 @@ void baranium_callback_set_internal_operations(internal_operation_t instantiateC
     detach_callback = detachCB;
 }
 
+// initial number of buckets of the hash index of a callback list, always a power of two
+#define BARANIUM_CALLBACK_LIST_INITIAL_CAPACITY 0x40
+
+static index_t baranium_callback_bucket_id(const void* table, size_t bucket)
+{
+    baranium_callback_list_entry* entry = ((baranium_callback_list_entry* const*)table)[bucket];
+    return entry ? entry->id : BARANIUM_INVALID_INDEX;
+}
+
+static void baranium_callback_move_bucket(void* table, size_t from, size_t to)
+{
+    baranium_callback_list_entry** buckets = table;
+    buckets[to] = buckets[from];
+    buckets[from] = NULL;
+}
+
+// finds the bucket of an id, or the empty bucket the id would go into
+static baranium_callback_list_entry** baranium_callback_find_bucket(baranium_callback_list* list, index_t id)
+{
+    return &list->buckets[bidhash_find(list->buckets, list->capacity, id, baranium_callback_bucket_id)];
+}
+
+// rehashes every entry into a bucket array of the given capacity
+static uint8_t baranium_callback_resize(baranium_callback_list* list, size_t capacity)
+{
+    baranium_callback_list_entry** buckets = malloc(sizeof(baranium_callback_list_entry*) * capacity);
+    if (buckets == NULL)
+        return 0;
+
+    memset(buckets, 0, sizeof(baranium_callback_list_entry*) * capacity);
+
+    baranium_callback_list_entry** oldBuckets = list->buckets;
+    size_t oldCapacity = list->capacity;
+    list->buckets = buckets;
+    list->capacity = capacity;
+
+    for (size_t i = 0; i < oldCapacity; i++)
+        if (oldBuckets[i] != NULL)
+            *baranium_callback_find_bucket(list, oldBuckets[i]->id) = oldBuckets[i];
+
+    free(oldBuckets);
+    return 1;
+}
+
+// unlinks an entry from the list and its index and frees it
+static void baranium_callback_list_remove(baranium_callback_list* list, baranium_callback_list_entry* entry)
+{
+    baranium_callback_list_entry** bucket = baranium_callback_find_bucket(list, entry->id);
+    if (*bucket == entry)
+    {
+        *bucket = NULL;
+        bidhash_close_hole(list->buckets, list->capacity, bucket - list->buckets, baranium_callback_bucket_id, baranium_callback_move_bucket);
+    }
+
+    if (entry->prev)
+        entry->prev->next = entry->next;
+    else
+        list->start = entry->next;
+
+    if (entry->next)
+        entry->next->prev = entry->prev;
+    else
+        list->end = entry->prev;
+
+    list->count--;
+    free(entry);
+}
+
 baranium_callback_list* baranium_callback_list_init(void)
 {
     baranium_callback_list* list = malloc(sizeof(baranium_callback_list));
@@ -32,6 +102,12 @@ baranium_callback_list* baranium_callback_list_init(void)
     list->end = NULL;
     list->count = 0;
 
+    if (!baranium_callback_resize(list, BARANIUM_CALLBACK_LIST_INITIAL_CAPACITY))
+    {
+        free(list);
+        return NULL;
+    }
+
     LOGDEBUG("Created callback list");
 
     return list;
@@ -53,35 +129,52 @@ void baranium_callback_list_dispose(baranium_callback_list* list)
     list->start = list->end = NULL;
     list->count = 0;
 
+    free(list->buckets);
     free(list);
 }
 
-void baranium_callback_add(index_t id, baranium_callback_t cb, int numParams)
+// creates an entry and appends it to the callback list of the runtime, `extraSize` bytes are allocated right after the entry
+static baranium_callback_list_entry* baranium_callback_create_entry(index_t id, int numParams, size_t extraSize)
 {
     baranium_runtime* runtime = baranium_get_runtime();
 
-    if (runtime == NULL || id == BARANIUM_INVALID_INDEX || cb == NULL)
-        return;
+    if (runtime == NULL || id == BARANIUM_INVALID_INDEX)
+        return NULL;
 
     baranium_callback_list* list = runtime->callbacks;
     if (list == NULL)
-        return;
+        return NULL;
 
-    baranium_callback_list_entry* newEntry = malloc(sizeof(baranium_callback_list_entry));
+    size_t capacity = bidhash_grown_capacity(list->count, list->capacity);
+    if (capacity != list->capacity && !baranium_callback_resize(list, capacity))
+        return NULL;
+
+    baranium_callback_list_entry* newEntry = malloc(sizeof(baranium_callback_list_entry) + extraSize);
     if (!newEntry)
-        return;
-    memset(newEntry, 0, sizeof(baranium_callback_list_entry));
-    newEntry->callback = cb;
+        return NULL;
+    memset(newEntry, 0, sizeof(baranium_callback_list_entry) + extraSize);
     newEntry->id = id;
     newEntry->parameter_count = numParams;
 
+    // a call to the id may have been resolved to a function or an older callback before
+    baranium_function_cache_remove(runtime->function_cache, id);
+
+    baranium_callback_list_entry** bucket = baranium_callback_find_bucket(list, id);
+    if (*bucket != NULL)
+    {
+        LOGDEBUG("Replacing callback with id %ld", id);
+        baranium_callback_list_remove(list, *bucket);
+        bucket = baranium_callback_find_bucket(list, id);
+    }
+    *bucket = newEntry;
+
     if (list->start == NULL)
     {
         newEntry->prev = NULL;
         newEntry->next = NULL;
         list->end = list->start = newEntry;
         list->count = 1;
-        return;
+        return newEntry;
     }
 
     newEntry->prev = list->end;
@@ -91,7 +184,36 @@ void baranium_callback_add(index_t id, baranium_callback_t cb, int numParams)
     list->end = newEntry;
     list->count++;
 
-    return;
+    return newEntry;
+}
+
+void baranium_callback_add(index_t id, baranium_callback_t cb, int numParams)
+{
+    if (cb == NULL)
+        return;
+
+    baranium_callback_list_entry* entry = baranium_callback_create_entry(id, numParams, 0);
+    if (entry != NULL)
+        entry->callback = cb;
+}
+
+void baranium_callback_add_stack(index_t id, baranium_stack_callback_t cb, int numParams, const baranium_variable_type_t* signature)
+{
+    if (cb == NULL || numParams < 0)
+        return;
+
+    // the signature is kept in the same allocation as the entry
+    size_t signatureSize = signature != NULL ? sizeof(baranium_variable_type_t) * numParams : 0;
+    baranium_callback_list_entry* entry = baranium_callback_create_entry(id, numParams, signatureSize);
+    if (entry == NULL)
+        return;
+
+    entry->stack_callback = cb;
+    if (signatureSize != 0)
+    {
+        memcpy(entry + 1, signature, signatureSize);
+        entry->signature = (const baranium_variable_type_t*)(entry + 1);
+    }
 }
 
 baranium_callback_list_entry* baranium_callback_find_by_id(index_t id)
@@ -102,19 +224,9 @@ baranium_callback_list_entry* baranium_callback_find_by_id(index_t id)
         return NULL;
 
     baranium_callback_list* list = runtime->callbacks;
-    if (!list) return NULL;
-
-    LOGDEBUG("Callback list has %ld entries", list->count);
-
-    for (baranium_callback_list_entry* entry = list->start; entry != NULL; )
-    {
-        baranium_callback_list_entry* next = entry->next;
-        if (entry->id == id)
-            return entry;
-        entry = next;
-    }
+    if (!list || list->count == 0) return NULL;
 
-    return NULL;
+    return *baranium_callback_find_bucket(list, id);
 }
 
 baranium_callback_list_entry* baranium_callback_find_by_cb_ptr(baranium_callback_t cb)
@@ -151,16 +263,8 @@ void baranium_callback_remove_by_id(index_t id)
     if (entry == NULL)
         return;
 
-    baranium_callback_list_entry* prev = entry->prev;
-    baranium_callback_list_entry* next = entry->next;
-
-    free(entry);
-
-    if (prev)
-        prev->next = next;
-    
-    if (next)
-        next->prev = prev;
+    baranium_function_cache_remove(runtime->function_cache, entry->id);
+    baranium_callback_list_remove(runtime->callbacks, entry);
 }
 
 void baranium_callback_remove_by_cb_ptr(baranium_callback_t cb)
@@ -172,14 +276,6 @@ void baranium_callback_remove_by_cb_ptr(baranium_callback_t cb)
     if (entry == NULL)
         return;
 
-    baranium_callback_list_entry* prev = entry->prev;
-    baranium_callback_list_entry* next = entry->next;
-
-    free(entry);
-
-    if (prev)
-        prev->next = next;
-    
-    if (next)
-        next->prev = prev;
+    baranium_function_cache_remove(baranium_get_runtime()->function_cache, entry->id);
+    baranium_callback_list_remove(baranium_get_runtime()->callbacks, entry);
 }
@@ -0,0 +1,236 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_COMPILER
+
+#include <baranium/compiler/binaries/aot.h>
+#include <baranium/backend/bfilemap.h>
+#include <baranium/backend/bindex.h>
+#include <baranium/cpu/bcode.h>
+#include <baranium/cpu/baot.h>
+#include <baranium/logging.h>
+#include <baranium/library.h>
+#include <baranium/script.h>
+#include <baranium/version.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <memory.h>
+
+// typed instructions that are turned into inline C, everything else is run through its handler
+typedef struct
+{
+    uint8_t opcode;
+    const char* field;
+    const char* operator;
+    uint8_t checkZero;
+} baranium_aot_typed_instruction;
+
+static const baranium_aot_typed_instruction baranium_aot_arithmetic[] = {
+    {0x40, "num32", "+", 0}, {0x41, "num32", "-", 0}, {0x42, "num32", "*", 0}, {0x43, "snum32", "/", 1}, {0x44, "snum32", "%", 1},
+    {0x48, "num64", "+", 0}, {0x49, "num64", "-", 0}, {0x4A, "num64", "*", 0}, {0x4B, "snum64", "/", 1}, {0x4C, "snum64", "%", 1},
+    {0x50, "numfloat", "+", 0}, {0x51, "numfloat", "-", 0}, {0x52, "numfloat", "*", 0}, {0x53, "numfloat", "/", 0},
+};
+
+static const baranium_aot_typed_instruction baranium_aot_compare[] = {
+    {0x60, "snum32", "==", 0}, {0x61, "snum32", "!=", 0}, {0x62, "snum32", "<", 0}, {0x63, "snum32", "<=", 0}, {0x64, "snum32", ">", 0}, {0x65, "snum32", ">=", 0},
+    {0x68, "snum64", "==", 0}, {0x69, "snum64", "!=", 0}, {0x6A, "snum64", "<", 0}, {0x6B, "snum64", "<=", 0}, {0x6C, "snum64", ">", 0}, {0x6D, "snum64", ">=", 0},
+    {0x70, "numfloat", "==", 0}, {0x71, "numfloat", "!=", 0}, {0x72, "numfloat", "<", 0}, {0x73, "numfloat", "<=", 0}, {0x74, "numfloat", ">", 0}, {0x75, "numfloat", ">=", 0},
+};
+
+// operators of JEQ, JNE, JLT, JLE, JGT and JGE
+static const char* baranium_aot_compare_jump[] = {"==", "!=", "<", "<=", ">", ">="};
+
+static const baranium_aot_typed_instruction* baranium_aot_find_typed(const baranium_aot_typed_instruction* list, size_t count, uint8_t opcode)
+{
+    for (size_t i = 0; i < count; i++)
+        if (list[i].opcode == opcode)
+            return &list[i];
+
+    return NULL;
+}
+
+static void baranium_aot_emit_instruction(FILE* output, const bcpu_instruction* instruction, size_t index)
+{
+    uint8_t opcode = instruction->opcode;
+    const baranium_aot_typed_instruction* typed = NULL;
+
+    fprintf(output, "i%zu: // %s\n    ", index, opcodes[opcode].name);
+
+    if (opcode == 0x10 || opcode == 0x11) // JMP, JMPOFF
+        fprintf(output, "BARANIUM_AOT_JUMP(%u);\n", instruction->target);
+    else if (opcode == 0x12 || opcode == 0x13) // JMPC, JMPCOFF
+        fprintf(output, "BARANIUM_AOT_JUMP_IF(cpu->cv != 0, %u);\n", instruction->target);
+    else if (opcode == 0x1D) // JMPNC
+        fprintf(output, "BARANIUM_AOT_JUMP_IF(cpu->cv == 0, %u);\n", instruction->target);
+    else if (opcode >= 0x32 && opcode <= 0x37) // JEQ - JGE
+        fprintf(output, "BARANIUM_AOT_COMPARE_JUMP(%zu, 0x%2.2x, %s, %u)\n", index, opcode, baranium_aot_compare_jump[opcode - 0x32], instruction->target);
+    else if (opcode == 0x16) // LOADLOCAL
+        fprintf(output, "BARANIUM_AOT_LOADLOCAL(%zu, 0x%2.2x)\n", index, opcode);
+    else if ((typed = baranium_aot_find_typed(baranium_aot_arithmetic, sizeof(baranium_aot_arithmetic) / sizeof(*baranium_aot_arithmetic), opcode)) != NULL)
+        fprintf(output, "BARANIUM_AOT_ARITHMETIC(%zu, 0x%2.2x, %s, %s, %u)\n", index, opcode, typed->field, typed->operator, typed->checkZero);
+    else if ((typed = baranium_aot_find_typed(baranium_aot_compare, sizeof(baranium_aot_compare) / sizeof(*baranium_aot_compare), opcode)) != NULL)
+        fprintf(output, "BARANIUM_AOT_COMPARE(%zu, 0x%2.2x, %s, %s)\n", index, opcode, typed->field, typed->operator);
+    else if (opcode == 0x0E || opcode == 0x0F || opcode == 0x1C) // CALL, RET, TAILCALL
+        fprintf(output, "BARANIUM_AOT_CALL(%zu, 0x%2.2x);\n    BARANIUM_AOT_STAY(%zu);\n", index, opcode, index);
+    else if (opcode == 0x14 || opcode == 0x1B || (opcode >= 0xCC && opcode <= 0xCE)) // CMPVAR_IMM_JMP, CMPLOCAL_IMM_JMP, JCMP_I32_RR - JCMP_F32_RR
+        fprintf(output, "BARANIUM_AOT_CALL(%zu, 0x%2.2x);\n    BARANIUM_AOT_FOLLOW(%zu);\n", index, opcode, index);
+    else
+        fprintf(output, "BARANIUM_AOT_CALL(%zu, 0x%2.2x);\n", index, opcode);
+}
+
+// writes the native body of a function, it continues at the instruction pointer of the cpu like the interpreter would
+static void baranium_aot_emit_function(FILE* output, index_t id, const bcode* code)
+{
+    uint8_t jumps = 0;
+    for (size_t i = 0; i < code->count; i++)
+    {
+        uint8_t opcode = code->instructions[i].opcode;
+        jumps |= (opcode >= 0x32 && opcode <= 0x37) || opcode == 0x14 || opcode == 0x1B || (opcode >= 0xCC && opcode <= 0xCE);
+    }
+
+    fprintf(output, "static uint8_t baranium_aot_%016llx(bcpu* cpu, const bcpu_instruction* code, const bcpu_opcode* handlers)\n{\n", (unsigned long long)id);
+    if (jumps)
+        fprintf(output, "dispatch:\n");
+    fprintf(output, "    switch (cpu->ip)\n    {\n");
+    for (size_t i = 0; i < code->count; i++)
+        fprintf(output, "        case %zu: goto i%zu;\n", i, i);
+    fprintf(output, "        default: return 0;\n    }\n\n");
+
+    for (size_t i = 0; i < code->count; i++)
+        baranium_aot_emit_instruction(output, &code->instructions[i], i);
+
+    fprintf(output, "\n    return 1;\n}\n\n");
+}
+
+// reads the header and skips the export table, offset is left at the first section of libraries without an index
+static uint8_t baranium_aot_read_header(const bfilemap* image, size_t* offset, baranium_library_header* header, baranium_binary_index* index)
+{
+    if (!bfilemap_read(image, offset, header, sizeof(baranium_library_header)))
+        return 0;
+
+    if (header->magic[0] != BARANIUM_LIBRARY_MAGIC_NUM0 || header->magic[1] != BARANIUM_LIBRARY_MAGIC_NUM1 ||
+        header->magic[2] != BARANIUM_LIBRARY_MAGIC_NUM2 || header->magic[3] != BARANIUM_LIBRARY_MAGIC_NUM3)
+        return 0;
+
+    if (header->version >= BARANIUM_VERSION_INDEXED_FORMAT &&
+        (!bfilemap_read(image, offset, index, sizeof(baranium_binary_index)) || !bindex_validate(image, index, header->section_count)))
+        return 0;
+
+    for (uint64_t i = 0; i < header->exports_count; i++)
+    {
+        size_t symnamelen = 0;
+        *offset += sizeof(baranium_script_section_type_t) + sizeof(index_t) + sizeof(int) + sizeof(baranium_variable_type_t);
+        if (!bfilemap_read(image, offset, &symnamelen, sizeof(size_t)) || bfilemap_view(image, offset, symnamelen) == NULL)
+            return 0;
+    }
+
+    return 1;
+}
+
+uint8_t baranium_aot_compile_library(const char* libraryPath, const char* outputPath)
+{
+    if (libraryPath == NULL || outputPath == NULL)
+        return 0;
+
+    FILE* file = fopen(libraryPath, "rb");
+    if (file == NULL)
+    {
+        LOGERROR("File '%s' not found", libraryPath);
+        return 0;
+    }
+
+    bfilemap image;
+    uint8_t mapped = bfilemap_open(&image, file);
+    fclose(file);
+
+    size_t offset = 0;
+    baranium_library_header header;
+    baranium_binary_index index = {.directory_offset=0,.name_table_offset=0,.name_bucket_count=0,.dependency_offset=0,.flags=0};
+    if (!mapped || !baranium_aot_read_header(&image, &offset, &header, &index))
+    {
+        LOGERROR("'%s' is not a library", libraryPath);
+        bfilemap_close(&image);
+        return 0;
+    }
+
+    FILE* output = fopen(outputPath, "wb");
+    if (output == NULL)
+    {
+        LOGERROR("Could not open '%s' for writing", outputPath);
+        bfilemap_close(&image);
+        return 0;
+    }
+
+    bcpu_opcodes_init();
+
+    fprintf(output, "// native code of '%s', generated by barc\n", libraryPath);
+    fprintf(output, "// build it into the dynamic library of the library with the runtime headers on the include path\n\n");
+    fprintf(output, "#include <baranium/cpu/baot.h>\n\n");
+
+    // the table entries are collected while the functions are written
+    index_t* ids = malloc(sizeof(index_t) * (header.section_count + 1));
+    uint64_t* counts = malloc(sizeof(uint64_t) * (header.section_count + 1));
+    uint64_t* checksums = malloc(sizeof(uint64_t) * (header.section_count + 1));
+    size_t functionCount = 0;
+    uint8_t success = ids != NULL && counts != NULL && checksums != NULL;
+    uint8_t indexed = header.version >= BARANIUM_VERSION_INDEXED_FORMAT;
+
+    for (uint64_t i = 0; success && i < header.section_count; i++)
+    {
+        baranium_script_section section;
+        if (!bindex_read_section(&image, indexed ? &index : NULL, i, &offset, &section))
+        {
+            LOGERROR("Library '%s' is truncated", libraryPath);
+            success = 0;
+            break;
+        }
+
+        if (section.type != BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS || section.data_size <= 2)
+            continue;
+
+        // parameter count and return type come before the code
+        const uint8_t* data = image.data + section.data_location;
+        bcode* code = bcode_decode(data + 2, section.data_size - 2, (index.flags & BARANIUM_BINARY_FLAG_REGISTER_CODE) != 0);
+        if (code == NULL)
+        {
+            LOGERROR("Could not decode function with id %ld", section.id);
+            success = 0;
+            break;
+        }
+
+        baranium_aot_emit_function(output, section.id, code);
+        ids[functionCount] = section.id;
+        counts[functionCount] = code->count;
+        checksums[functionCount] = bcode_checksum(data + 2, section.data_size - 2);
+        functionCount++;
+
+        bcode_dispose(code);
+    }
+
+    if (success)
+    {
+        fprintf(output, "static const baranium_aot_function baranium_aot_functions[] = {\n");
+        for (size_t i = 0; i < functionCount; i++)
+            fprintf(output, "    {.id = %lld, .count = %llu, .checksum = 0x%016llxull, .entry = baranium_aot_%016llx},\n",
+                    (long long)ids[i], (unsigned long long)counts[i], (unsigned long long)checksums[i], (unsigned long long)ids[i]);
+        if (functionCount == 0)
+            fprintf(output, "    {.id = BARANIUM_INVALID_INDEX, .count = 0, .checksum = 0, .entry = NULL},\n");
+        fprintf(output, "};\n\n");
+
+        fprintf(output, "BARANIUM_AOT_EXPORT const baranium_aot_table __baranium_aot__ = {\n");
+        fprintf(output, "    .version = BARANIUM_AOT_VERSION,\n");
+        fprintf(output, "    .count = %zu,\n", functionCount);
+        fprintf(output, "    .functions = baranium_aot_functions,\n");
+        fprintf(output, "};\n");
+
+        LOGINFO("Generated native code for %zu functions as '%s'", functionCount, outputPath);
+    }
+
+    free(ids);
+    free(counts);
+    free(checksums);
+    fclose(output);
+    bfilemap_close(&image);
+
+    if (!success)
+        remove(outputPath);
+
+    return success;
+}
@@ -10,6 +10,7 @@
 #include <baranium/compiler/compiler_context.h>
 #include <baranium/compiler/language/token.h>
 #include <baranium/compiler/source_token.h>
+#include <baranium/backend/bindex.h>
 #include <baranium/string_util.h>
 #include <baranium/variable.h>
 #include <baranium/library.h>
@@ -67,14 +68,26 @@ void baranium_compiler_code_builder_push_uint(baranium_compiler* compiler, uint3
 // push a int value to the stack
 void baranium_compiler_code_builder_push_int(baranium_compiler* compiler, int32_t val);
 
+// push a int64 value to the stack
+void baranium_compiler_code_builder_push_int64(baranium_compiler* compiler, int64_t val);
+
 // push a float value to the stack
 void baranium_compiler_code_builder_push_float(baranium_compiler* compiler, float val);
 
+// push an object id to the stack
+void baranium_compiler_code_builder_push_object(baranium_compiler* compiler, index_t id);
+
 void baranium_compiler_code_builder_push64(baranium_compiler* compiler, uint64_t data);
 void baranium_compiler_code_builder_push32(baranium_compiler* compiler, uint32_t data);
 void baranium_compiler_code_builder_push16(baranium_compiler* compiler, uint16_t data);
 void baranium_compiler_code_builder_push(baranium_compiler* compiler, uint8_t data);
 
+// overwrite 8 bytes of already emitted code, used for addresses that are only known later on
+void baranium_compiler_code_builder_patch64(baranium_compiler* compiler, size_t position, uint64_t data);
+
+// fill in the address of every jump of a chain, each unresolved jump holds the position of the previous one's address, 0 ends the chain
+void baranium_compiler_code_builder_patch_chain(baranium_compiler* compiler, size_t chain, uint64_t addr);
+
 //////////////////////
 ///                ///
 ///   OPERATIONS   ///
@@ -111,12 +124,45 @@ void baranium_compiler_code_builder_POPVAR(baranium_compiler* compiler, index_t
 // push a value to the stack
 void baranium_compiler_code_builder_PUSH(baranium_compiler* compiler, uint64_t val);
 
+// increment a variable by one
+void baranium_compiler_code_builder_INCVAR(baranium_compiler* compiler, index_t id);
+
+// decrement a variable by one
+void baranium_compiler_code_builder_DECVAR(baranium_compiler* compiler, index_t id);
+
+// add an immediate value to a variable
+void baranium_compiler_code_builder_ADDVAR_IMM(baranium_compiler* compiler, index_t id, baranium_variable_type_t type, baranium_value_t value);
+
+// push a typed value to the stack, the value is stored in the code (and referenced by string values)
+void baranium_compiler_code_builder_PUSHV(baranium_compiler* compiler, baranium_variable_type_t type, size_t size, const void* data);
+
+// reserve the frame slots for the locals of a function
+void baranium_compiler_code_builder_ENTER(baranium_compiler* compiler, uint64_t count);
+
+// push the value of a local to the stack
+void baranium_compiler_code_builder_LOADLOCAL(baranium_compiler* compiler, index_t slot);
+
+// pop a value from the stack into a local
+void baranium_compiler_code_builder_STORELOCAL(baranium_compiler* compiler, index_t slot, baranium_variable_type_t type);
+
+// increment a local by one
+void baranium_compiler_code_builder_INCLOCAL(baranium_compiler* compiler, index_t slot);
+
+// decrement a local by one
+void baranium_compiler_code_builder_DECLOCAL(baranium_compiler* compiler, index_t slot);
+
+// add an immediate value to a local
+void baranium_compiler_code_builder_ADDLOCAL_IMM(baranium_compiler* compiler, index_t slot, baranium_variable_type_t type, baranium_value_t value);
+
 // call a function with a specific id
 void baranium_compiler_code_builder_CALL(baranium_compiler* compiler, index_t id);
 
 // return from a function
 void baranium_compiler_code_builder_RET(baranium_compiler* compiler);
 
+// call a function that takes over the frame of the current one, its return value is returned directly
+void baranium_compiler_code_builder_TAILCALL(baranium_compiler* compiler, index_t id);
+
 // jump to
 void baranium_compiler_code_builder_JMP(baranium_compiler* compiler, uint64_t addr);
 
@@ -129,6 +175,18 @@ void baranium_compiler_code_builder_JMPC(baranium_compiler* compiler, uint64_t a
 // jump offset-ed from the current position
 void baranium_compiler_code_builder_JMPCOFF(baranium_compiler* compiler, int16_t addr);
 
+// jump if not equal to
+void baranium_compiler_code_builder_JMPNC(baranium_compiler* compiler, uint64_t addr);
+
+// compare a variable with an immediate value and jump to if the comparison succeeds
+void baranium_compiler_code_builder_CMPVAR_IMM_JMP(baranium_compiler* compiler, index_t id, baranium_variable_type_t type, baranium_value_t value, uint8_t compareMethod, uint64_t addr);
+
+// compare a local with an immediate value and jump to if the comparison succeeds
+void baranium_compiler_code_builder_CMPLOCAL_IMM_JMP(baranium_compiler* compiler, index_t slot, baranium_variable_type_t type, baranium_value_t value, uint8_t compareMethod, uint64_t addr);
+
+// compare two values from the stack and jump to if the comparison succeeds
+void baranium_compiler_code_builder_JCMP(baranium_compiler* compiler, uint8_t compareMethod, uint64_t addr);
+
 // modulo two values from the stack
 void baranium_compiler_code_builder_MOD(baranium_compiler* compiler);
 
@@ -159,12 +217,42 @@ void baranium_compiler_code_builder_SHFTL(baranium_compiler* compiler);
 // bitwise shift right
 void baranium_compiler_code_builder_SHFTR(baranium_compiler* compiler);
 
+// concatenate the given number of values from the stack into one string
+void baranium_compiler_code_builder_CONCATN(baranium_compiler* compiler, uint64_t count);
+
 // compare two values on the stack
 void baranium_compiler_code_builder_CMP(baranium_compiler* compiler, uint8_t compareMethod);
 
 // compare two compared values together
 void baranium_compiler_code_builder_CMPC(baranium_compiler* compiler, uint8_t compareCombineMethod);
 
+// modulo two values of a known type from the stack, falls back to MOD if there is no typed version
+void baranium_compiler_code_builder_TMOD(baranium_compiler* compiler, baranium_variable_type_t type);
+
+// divide two values of a known type from the stack, falls back to DIV if there is no typed version
+void baranium_compiler_code_builder_TDIV(baranium_compiler* compiler, baranium_variable_type_t type);
+
+// multiply two values of a known type from the stack, falls back to MUL if there is no typed version
+void baranium_compiler_code_builder_TMUL(baranium_compiler* compiler, baranium_variable_type_t type);
+
+// subtract two values of a known type from the stack, falls back to SUB if there is no typed version
+void baranium_compiler_code_builder_TSUB(baranium_compiler* compiler, baranium_variable_type_t type);
+
+// add two values of a known type from the stack, falls back to ADD if there is no typed version
+void baranium_compiler_code_builder_TADD(baranium_compiler* compiler, baranium_variable_type_t type);
+
+// compare two values of a known type on the stack, falls back to CMP if there is no typed version
+void baranium_compiler_code_builder_TCMP(baranium_compiler* compiler, uint8_t compareMethod, baranium_variable_type_t type);
+
+// `destination = lhs <operation> rhs` on frame slots, `operation` is the token of the arithmetic or assignment operator
+void baranium_compiler_code_builder_ARITHMETIC_RR(baranium_compiler* compiler, baranium_source_token_type_t operation, baranium_variable_type_t type, index_t destination, index_t lhs, index_t rhs);
+
+// `destination = lhs <operation> value` on frame slots, `operation` is the token of the arithmetic or assignment operator
+void baranium_compiler_code_builder_ARITHMETIC_RI(baranium_compiler* compiler, baranium_source_token_type_t operation, baranium_variable_type_t type, index_t destination, index_t lhs, baranium_value_t value);
+
+// compare two frame slots of a known type and jump if the comparison succeeds
+void baranium_compiler_code_builder_JCMP_RR(baranium_compiler* compiler, uint8_t compareMethod, baranium_variable_type_t type, index_t lhs, index_t rhs, uint64_t addr);
+
 // allocate memory
 void baranium_compiler_code_builder_MEM(baranium_compiler* compiler, size_t size, uint8_t type, index_t id);
 
@@ -189,10 +277,11 @@ void baranium_compiler_code_builder_DETACH(baranium_compiler* compiler);
 // stop execution with return code
 void baranium_compiler_code_builder_KILL(baranium_compiler* compiler, int64_t code);
 void baranium_compiler_compile_variable(baranium_compiler* compiler, baranium_variable_token* token);
+
+// push a value given as source text (literal, keyword or variable name) with a known type
+void baranium_compiler_compile_value(baranium_compiler* compiler, const char* value, baranium_variable_type_t type);
 void baranium_compiler_compile_expression(baranium_compiler* compiler, baranium_expression_token* token);
 void baranium_compiler_compile_if_else_statement(baranium_compiler* compiler, baranium_if_else_token* token);
-void baranium_compiler_compile_if_else_sub_statement(baranium_compiler* compiler, baranium_if_else_token* token);
-void baranium_compiler_compile_else_statement(baranium_compiler* compiler, baranium_if_else_token* token);
 void baranium_compiler_compile_do_while_loop(baranium_compiler* compiler, baranium_loop_token* token);
 void baranium_compiler_compile_while_loop(baranium_compiler* compiler, baranium_loop_token* token);
 void baranium_compiler_compile_for_loop(baranium_compiler* compiler, baranium_loop_token* token);
@@ -200,16 +289,58 @@ void baranium_compiler_compile_ast_node(baranium_compiler* compiler, baranium_ab
 void baranium_compiler_compile_assignment(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* root);
 void baranium_compiler_compile_return_statement(baranium_compiler* compiler, baranium_expression_token* expression);
 void baranium_compiler_compile_arithmetic_operation(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* root, uint8_t isRoot);
+static uint8_t baranium_compiler_compile_concatenation(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* root);
 void baranium_compiler_compile_condition(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* root);
+void baranium_compiler_compile_loop_condition(baranium_compiler* compiler, baranium_expression_token* condition, uint64_t addr);
+
+// compile a condition that jumps if its result is `when`, the emitted jumps are added to the chain of jumps that still need an address
+static void baranium_compiler_compile_branch(baranium_compiler* compiler, baranium_expression_token* condition, uint8_t when, size_t* chain);
+static void baranium_compiler_compile_condition_jump(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node, uint8_t when, size_t* chain);
+
+// compile one side of `&&`/`||` into the compare value
+static void baranium_compiler_compile_condition_operand(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node);
+
+// compile `lhs <compare> rhs` together with a jump that is taken if the comparison succeeds
+static void baranium_compiler_compile_compare_jump(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* root, uint8_t compareMethod, uint64_t addr);
+
+// returns the number of operations of an arithmetic node if it can be computed with register instructions, which is the
+// case if its operands are locals, number literals or other such nodes that all have the same type, 0 otherwise
+static size_t baranium_compiler_count_register_operations(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node);
+
+// compile a node counted by `baranium_compiler_count_register_operations` into a frame slot
+static void baranium_compiler_compile_register_expression(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node, index_t destination);
+
+// compile an arithmetic node into a temporary and push it, returns 0 if it has to be computed on the stack
+static uint8_t baranium_compiler_compile_register_push(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node);
+
+// compile an assignment to a local with register instructions, returns 0 if it has to go over the stack
+static uint8_t baranium_compiler_compile_register_assignment(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* root, baranium_symbol_table_entry* local);
+
+// compile `lhs <compare> rhs` with a register instruction, returns 0 if it has to go over the stack
+static uint8_t baranium_compiler_compile_register_compare_jump(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* root, uint8_t compareMethod, uint64_t addr);
 void baranium_compiler_compile_keyword_expression(baranium_compiler* compiler, baranium_expression_token* expression);
 void baranium_compiler_compile_function_call(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node);
+static uint8_t baranium_compiler_is_compare_operator(baranium_source_token_type_t type);
 static uint8_t baranium_compiler_get_compare_method(baranium_source_token_type_t type);
+static uint8_t baranium_compiler_invert_compare_method(uint8_t compareMethod);
+baranium_variable_type_t baranium_compiler_infer_type(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node);
+static uint8_t baranium_compiler_get_number_literal(baranium_abstract_syntax_tree_node* node, baranium_variable_type_t* type, baranium_value_t* value);
 
 baranium_compiler baranium_compiler_predict_code_size(baranium_compiler* compiler, baranium_token_list* tokens);
 baranium_compiler baranium_compiler_predict_code_size_expression(baranium_compiler* compiler, baranium_expression_token* token);
+baranium_compiler baranium_compiler_predict_code_size_loop_condition(baranium_compiler* compiler, baranium_expression_token* condition);
 
 index_t baranium_compiler_get_id(baranium_compiler* compiler, const char* name, int lineNumber);
 
+// push the value of a variable, locals are read from the frame of the function
+void baranium_compiler_compile_load_variable(baranium_compiler* compiler, index_t id);
+
+// pop a value into a variable, locals are written to the frame of the function
+void baranium_compiler_compile_store_variable(baranium_compiler* compiler, index_t id);
+
+// compile the code of a function, its parameters and locals are placed in the frame of the function
+void baranium_compiler_compile_function(baranium_compiler* compiler, baranium_function_token* function);
+
 
 /////////////////////////////////
 ///                           ///
@@ -275,121 +406,158 @@ void baranium_compiler_add_dependency(baranium_compiler* compiler, baranium_libr
     compiler->dependencies[compiler->dependency_count-1] = libid;
 }
 
-void baranium_compiler_write(baranium_compiler* compiler, baranium_token_list* tokens, FILE* file, uint8_t library)
+// binaries are assembled in memory and written with a single call, tables are patched by offset because the buffer moves when it grows
+typedef struct
 {
-    if (compiler == NULL || tokens == NULL || file == NULL || tokens->count == 0)
-        return;
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    uint8_t failed;
+} baranium_compiler_image;
 
-    size_t tmp = 0;
-    if (!library)
+// append zeroed bytes to the image and return their offset
+static size_t baranium_compiler_image_reserve(baranium_compiler_image* image, size_t size)
+{
+    size_t offset = image->size;
+    if (image->failed)
+        return offset;
+
+    if (image->size + size > image->capacity)
     {
-        baranium_script_header header = {
-            .magic = { BARANIUM_MAGIC_NUM0, BARANIUM_MAGIC_NUM1, BARANIUM_MAGIC_NUM2, BARANIUM_MAGIC_NUM3 },
-            .version = BARANIUM_VERSION_CURRENT,
-            .section_count = tokens->count,
-        };
-        fwrite(&header, sizeof(baranium_script_header), 1, file);
+        size_t capacity = image->capacity ? image->capacity : 0x1000;
+        while (capacity < image->size + size)
+            capacity *= 2;
 
-        size_t tokencountposition = offsetof(struct baranium_script_header, section_count);
-        size_t uselesssectioncount = 0;
-        for (size_t i = 0; i < tokens->count; i++)
+        uint8_t* data = realloc(image->data, capacity);
+        if (data == NULL)
         {
-            baranium_token* token = tokens->data[i];
-            if (token->type == BARANIUM_TOKEN_TYPE_FUNCTION)
-            {
-                baranium_function_token* function = (baranium_function_token*)token;
-                baranium_symbol_table_add_from_name_and_id(&compiler->var_table, token->name, token->id);
-                if (function->only_declaration)
-                {
-                    uselesssectioncount++;
-                    continue;
-                }
+            image->failed = 1;
+            return offset;
+        }
 
-                tmp = (uint8_t)BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS; fwrite(&tmp, sizeof(uint8_t), 1, file);
-                fwrite(&token->id, sizeof(index_t), 1, file);
+        image->data = data;
+        image->capacity = capacity;
+    }
 
-                // "compile" the code
-                baranium_compiler_code_builder_clear(compiler);
-                baranium_compiler_compile_variables(compiler, &function->parameters);
-                baranium_compiler_compile(compiler, &function->tokens);
-                baranium_compiler_clear_variables(compiler, &function->parameters);
+    memset(image->data + offset, 0, size);
+    image->size += size;
+    return offset;
+}
 
-                // Size calculation: parameter count + return type + compiled code size
-                uint64_t dataSize = 2 + compiler->code_length;
-                fwrite(&dataSize, sizeof(uint64_t), 1, file);
+static size_t baranium_compiler_image_append(baranium_compiler_image* image, const void* data, size_t size)
+{
+    size_t offset = baranium_compiler_image_reserve(image, size);
+    if (!image->failed && size != 0)
+        memcpy(image->data + offset, data, size);
 
-                tmp = (uint8_t)function->parameters.count; fwrite(&tmp, sizeof(uint8_t), 1, file);
-                tmp = (uint8_t)function->return_type; fwrite(&tmp, sizeof(uint8_t), 1, file);
-                fwrite(compiler->code, sizeof(uint8_t), compiler->code_length, file);
+    return offset;
+}
 
-                baranium_compiler_code_builder_clear(compiler);
-                continue;
-            }
+static void baranium_compiler_image_patch(baranium_compiler_image* image, size_t offset, const void* data, size_t size)
+{
+    if (!image->failed)
+        memcpy(image->data + offset, data, size);
+}
 
-            if (token->type == BARANIUM_TOKEN_TYPE_VARIABLE)
-            {
-                baranium_variable_token* variable = (baranium_variable_token*)token;
-                tmp = (uint8_t)BARANIUM_SCRIPT_SECTION_TYPE_FIELDS; fwrite(&tmp, sizeof(uint8_t), 1, file);
-                fwrite(&token->id, sizeof(index_t), 1, file);
-                int8_t dataTypeSize = baranium_variable_get_size_of_type(variable->type);
-                if (dataTypeSize == -1) // meaning this is a string
-                    dataTypeSize = strlen(variable->value) + 1; // for now store the initial string's length + 1 because of the null-char at the end
-
-                // Size calculation: data type(1 byte) + data size
-                uint64_t dataSize = sizeof(uint8_t) + dataTypeSize;
-                fwrite(&dataSize, sizeof(uint64_t), 1, file);
-                void* data = (uint8_t*)malloc(dataSize);
-                memset(data, 0, dataSize);
-                baranium_compiler_copy_variable_data(data, variable->value, variable->type);
-                fwrite(data, sizeof(uint8_t), dataSize, file);
-                free(data);
-
-                baranium_symbol_table_add_from_name_and_id(&compiler->var_table, token->name, token->id);
-                continue;
-            }
+static void baranium_compiler_image_align(baranium_compiler_image* image)
+{
+    baranium_compiler_image_reserve(image, (BINDEX_ALIGNMENT - image->size % BINDEX_ALIGNMENT) % BINDEX_ALIGNMENT);
+}
 
-            if (token->type == BARANIUM_TOKEN_TYPE_FIELD)
-            {
-                baranium_field_token* field = (baranium_field_token*)token;
-                tmp = (uint8_t)BARANIUM_SCRIPT_SECTION_TYPE_FIELDS; fwrite(&tmp, sizeof(uint8_t), 1, file);
-                fwrite(&token->id, sizeof(index_t), 1, file);
-                int8_t dataTypeSize = baranium_variable_get_size_of_type(field->type);
-                if (dataTypeSize == -1) // meaning this is a string
-                    dataTypeSize = strlen(field->value) + 1; // for now store the initial string's length + 1 because of the null-char at the end
-
-                // Size calculation: data type(1 byte) + data size
-                uint64_t dataSize = sizeof(uint8_t) + dataTypeSize;
-                fwrite(&dataSize, sizeof(uint64_t), 1, file);
-                void* data = (uint8_t*)malloc(dataSize);
-                memset(data, 0, dataSize);
-                baranium_compiler_copy_variable_data(data, field->value, field->type);
-                fwrite(data, sizeof(uint8_t), dataSize, file);
-                free(data);
-
-                baranium_symbol_table_add_from_name_and_id(&compiler->var_table, token->name, token->id);
-                continue;
-            }
+static int baranium_compiler_compare_sections(const void* a, const void* b)
+{
+    index_t lhs = ((const baranium_binary_section_entry*)a)->id;
+    index_t rhs = ((const baranium_binary_section_entry*)b)->id;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+// append the initial value of a global, the type comes first
+static uint64_t baranium_compiler_image_append_value(baranium_compiler_image* image, const char* value, baranium_variable_type_t type)
+{
+    int8_t dataTypeSize = baranium_variable_get_size_of_type(type);
+    if (dataTypeSize == -1) // meaning this is a string
+        dataTypeSize = (value ? strlen(value) : 0) + 1; // for now store the initial string's length + 1 because of the null-char at the end
+
+    // Size calculation: data type(1 byte) + data size
+    uint64_t dataSize = sizeof(uint8_t) + dataTypeSize;
+    size_t offset = baranium_compiler_image_reserve(image, dataSize);
+    if (!image->failed)
+        baranium_compiler_copy_variable_data(image->data + offset, value, type);
+
+    return dataSize;
+}
+
+// get the initial value of a global from its initializer as source text, globals are never run through code so their
+// initializer has to be a literal which is stored as the initial value of the section
+static const char* baranium_compiler_get_initial_value(const char* value, baranium_expression_token* init, char* buffer, size_t bufferSize)
+{
+    if (init->expression_type == BARANIUM_EXPRESSION_TYPE_INVALID || init->ast == NULL)
+        return value;
+
+    baranium_compiler_context* ctx = baranium_get_compiler_context();
+    baranium_abstract_syntax_tree_node* node = init->ast->right;
+    if (init->ast->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_EQUALSIGN && node != NULL && node->sub_nodes.count == 0)
+    {
+        if (node->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_NUMBER || node->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_KEYWORD)
+            return node->contents.contents;
+        if (node->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_DOUBLEQUOTE)
+            return node->left ? node->left->contents.contents : "";
+        if (node->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_NULL)
+            return "";
+
+        // negative numbers are parsed as a minus in front of the number
+        if (node->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_MINUS && node->left == NULL && node->right != NULL &&
+            node->right->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_NUMBER)
+        {
+            snprintf(buffer, bufferSize, "-%s", node->right->contents.contents);
+            return buffer;
         }
+    }
+
+    LOGERROR("Line %d: Invalid initializer for global, only literals can be used", init->line_number);
+    if (ctx)
+        ctx->error_occurred = 1;
+    return value;
+}
+
+void baranium_compiler_write(baranium_compiler* compiler, baranium_token_list* tokens, FILE* file, uint8_t library)
+{
+    if (compiler == NULL || tokens == NULL || file == NULL || tokens->count == 0)
+        return;
+
+    baranium_compiler_image image = {.data=NULL,.size=0,.capacity=0,.failed=0};
+    baranium_binary_index index = {.directory_offset=0,.name_table_offset=0,.name_bucket_count=0,.dependency_offset=0,.flags=BARANIUM_BINARY_FLAG_REGISTER_CODE};
 
-        // update the old section count
-        size_t end_pos = ftell(file);
-        fseek(file, tokencountposition, SEEK_SET);
-        tmp = tokens->count - uselesssectioncount;
-        fwrite(&tmp, sizeof(uint64_t), 1, file);
-        fseek(file, end_pos, SEEK_SET);
+    // every global gets a section, except functions that are only declared
+    uint64_t sectionCount = 0;
+    for (size_t i = 0; i < tokens->count; i++)
+    {
+        baranium_token* token = tokens->data[i];
+        if (token->type == BARANIUM_TOKEN_TYPE_FUNCTION && ((baranium_function_token*)token)->only_declaration)
+            continue;
+        if (token->type == BARANIUM_TOKEN_TYPE_FUNCTION || token->type == BARANIUM_TOKEN_TYPE_VARIABLE || token->type == BARANIUM_TOKEN_TYPE_FIELD)
+            sectionCount++;
     }
+
+    baranium_script_header scriptheader = {
+        .magic = { BARANIUM_MAGIC_NUM0, BARANIUM_MAGIC_NUM1, BARANIUM_MAGIC_NUM2, BARANIUM_MAGIC_NUM3 },
+        .version = BARANIUM_VERSION_CURRENT,
+        .section_count = sectionCount,
+    };
+    baranium_library_header libheader = {
+        .magic = {BARANIUM_LIBRARY_MAGIC_NUM0,BARANIUM_LIBRARY_MAGIC_NUM1,BARANIUM_LIBRARY_MAGIC_NUM2,BARANIUM_LIBRARY_MAGIC_NUM3},
+        .version = BARANIUM_VERSION_CURRENT,
+        .exports_count = 0,
+        .section_count = sectionCount,
+    };
+    if (library)
+        baranium_compiler_image_reserve(&image, sizeof(baranium_library_header));
     else
-    {
-        baranium_library_header header = {
-            .magic = {BARANIUM_LIBRARY_MAGIC_NUM0,BARANIUM_LIBRARY_MAGIC_NUM1,BARANIUM_LIBRARY_MAGIC_NUM2,BARANIUM_LIBRARY_MAGIC_NUM3},
-            .version = BARANIUM_VERSION_CURRENT,
-            .exports_count = 0,
-            .section_count = tokens->count,
-        };
-        size_t exportcountposition = offsetof(struct baranium_library_header, exports_count);
-        size_t tokencountposition = offsetof(struct baranium_library_header, section_count);
-        fwrite(&header, sizeof(baranium_library_header), 1, file);
+        baranium_compiler_image_reserve(&image, sizeof(baranium_script_header));
+    size_t indexposition = baranium_compiler_image_reserve(&image, sizeof(baranium_binary_index));
 
+    if (library)
+    {
         size_t externalsymbolnameappendixlength = 7;
         const char* externalsymbolnameappendix = "_extern";
         for (size_t i = 0; i < tokens->count; i++)
@@ -423,119 +591,152 @@ void baranium_compiler_write(baranium_compiler* compiler, baranium_token_list* t
             if (token->type == BARANIUM_TOKEN_TYPE_FIELD)
                 export.type = BARANIUM_SCRIPT_SECTION_TYPE_FIELDS;
 
-            fwrite(&export.type, sizeof(baranium_script_section_type_t), 1, file);
-            fwrite(&export.id, sizeof(index_t), 1, file);
-            fwrite(&export.num_params, sizeof(int), 1, file);
-            fwrite(&export.return_type, sizeof(baranium_variable_type_t), 1, file);
-            fwrite(&export.symnamelen, sizeof(size_t), 1, file);
+            baranium_compiler_image_append(&image, &export.type, sizeof(baranium_script_section_type_t));
+            baranium_compiler_image_append(&image, &export.id, sizeof(index_t));
+            baranium_compiler_image_append(&image, &export.num_params, sizeof(int));
+            baranium_compiler_image_append(&image, &export.return_type, sizeof(baranium_variable_type_t));
+            baranium_compiler_image_append(&image, &export.symnamelen, sizeof(size_t));
             if (export.symname)
             {
-                fwrite(export.symname, sizeof(char), export.symnamelen-externalsymbolnameappendixlength, file);
-                fwrite(externalsymbolnameappendix, sizeof(char), externalsymbolnameappendixlength, file);
+                baranium_compiler_image_append(&image, export.symname, export.symnamelen-externalsymbolnameappendixlength);
+                baranium_compiler_image_append(&image, externalsymbolnameappendix, externalsymbolnameappendixlength);
             }
 
-            header.exports_count++;
+            libheader.exports_count++;
         }
+    }
 
-        size_t uselesssectioncount = 0;
-        for (size_t i = 0; i < tokens->count; i++)
+    // the directory is filled in once every section is written and then sorted by id
+    baranium_compiler_image_align(&image);
+    index.directory_offset = baranium_compiler_image_reserve(&image, sizeof(baranium_binary_section_entry) * sectionCount);
+    baranium_binary_section_entry* directory = calloc(sectionCount ? sectionCount : 1, sizeof(baranium_binary_section_entry));
+    baranium_token** named = calloc(sectionCount ? sectionCount : 1, sizeof(baranium_token*));
+    if (directory == NULL || named == NULL)
+        image.failed = 1;
+
+    uint64_t sectionIndex = 0;
+    char initialValue[64];
+    for (size_t i = 0; !image.failed && i < tokens->count; i++)
+    {
+        baranium_token* token = tokens->data[i];
+        if (token->type != BARANIUM_TOKEN_TYPE_FUNCTION && token->type != BARANIUM_TOKEN_TYPE_VARIABLE && token->type != BARANIUM_TOKEN_TYPE_FIELD)
+            continue;
+
+        if (token->type == BARANIUM_TOKEN_TYPE_FUNCTION)
         {
-            baranium_token* token = tokens->data[i];
-            if (token->type == BARANIUM_TOKEN_TYPE_FUNCTION)
-            {
-                baranium_function_token* function = (baranium_function_token*)token;
-                baranium_symbol_table_add_from_name_and_id(&compiler->var_table, token->name, token->id);
-                if (function->only_declaration)
-                {
-                    uselesssectioncount++;
-                    continue;
-                }
+            baranium_function_token* function = (baranium_function_token*)token;
+            baranium_symbol_table_add_from_name_and_id(&compiler->var_table, token->name, token->id);
+            if (function->only_declaration)
+                continue;
+        }
 
-                tmp = (uint8_t)BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS; fwrite(&tmp, sizeof(uint8_t), 1, file);
-                fwrite(&token->id, sizeof(index_t), 1, file);
+        baranium_binary_section_entry* entry = &directory[sectionIndex];
+        named[sectionIndex] = token;
+        sectionIndex++;
 
-                // "compile" the code
-                baranium_compiler_code_builder_clear(compiler);
-                baranium_compiler_compile_variables(compiler, &function->parameters);
-                baranium_compiler_compile(compiler, &function->tokens);
-                baranium_compiler_clear_variables(compiler, &function->parameters);
+        baranium_compiler_image_align(&image);
+        entry->id = token->id;
+        entry->data_offset = image.size;
 
-                // Size calculation: parameter count + return type + compiled code size
-                uint64_t dataSize = 2 + compiler->code_length;
-                fwrite(&dataSize, sizeof(uint64_t), 1, file);
+        if (token->type == BARANIUM_TOKEN_TYPE_FUNCTION)
+        {
+            baranium_function_token* function = (baranium_function_token*)token;
+            entry->type = BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS;
 
-                tmp = (uint8_t)function->parameters.count; fwrite(&tmp, sizeof(uint8_t), 1, file);
-                tmp = (uint8_t)function->return_type; fwrite(&tmp, sizeof(uint8_t), 1, file);
-                fwrite(compiler->code, sizeof(uint8_t), compiler->code_length, file);
+            // "compile" the code
+            baranium_compiler_compile_function(compiler, function);
 
-                baranium_compiler_code_builder_clear(compiler);
-                continue;
-            }
+            // Size calculation: parameter count + return type + compiled code size
+            entry->data_size = 2 + compiler->code_length;
 
-            if (token->type == BARANIUM_TOKEN_TYPE_VARIABLE)
-            {
-                baranium_variable_token* variable = (baranium_variable_token*)token;
-                tmp = (uint8_t)BARANIUM_SCRIPT_SECTION_TYPE_FIELDS; fwrite(&tmp, sizeof(uint8_t), 1, file);
-                fwrite(&token->id, sizeof(index_t), 1, file);
-                int8_t dataTypeSize = baranium_variable_get_size_of_type(variable->type);
-                if (dataTypeSize == -1) // meaning this is a string
-                    dataTypeSize = strlen(variable->value) + 1; // for now store the initial string's length + 1 because of the null-char at the end
-
-                // Size calculation: data type(1 byte) + data size
-                uint64_t dataSize = sizeof(uint8_t) + dataTypeSize;
-                fwrite(&dataSize, sizeof(uint64_t), 1, file);
-                void* data = (uint8_t*)malloc(dataSize);
-                memset(data, 0, dataSize);
-                baranium_compiler_copy_variable_data(data, variable->value, variable->type);
-                fwrite(data, sizeof(uint8_t), dataSize, file);
-                free(data);
-
-                baranium_symbol_table_add_from_name_and_id(&compiler->var_table, token->name, token->id);
-                continue;
-            }
+            uint8_t tmp = (uint8_t)function->parameters.count; baranium_compiler_image_append(&image, &tmp, sizeof(uint8_t));
+            tmp = (uint8_t)function->return_type; baranium_compiler_image_append(&image, &tmp, sizeof(uint8_t));
+            baranium_compiler_image_append(&image, compiler->code, compiler->code_length);
 
-            if (token->type == BARANIUM_TOKEN_TYPE_FIELD)
-            {
-                baranium_field_token* field = (baranium_field_token*)token;
-                tmp = (uint8_t)BARANIUM_SCRIPT_SECTION_TYPE_FIELDS; fwrite(&tmp, sizeof(uint8_t), 1, file);
-                fwrite(&token->id, sizeof(index_t), 1, file);
-                int8_t dataTypeSize = baranium_variable_get_size_of_type(field->type);
-                if (dataTypeSize == -1) // meaning this is a string
-                    dataTypeSize = strlen(field->value) + 1; // for now store the initial string's length + 1 because of the null-char at the end
-
-                // Size calculation: data type(1 byte) + data size
-                uint64_t dataSize = sizeof(uint8_t) + dataTypeSize;
-                fwrite(&dataSize, sizeof(uint64_t), 1, file);
-                void* data = (uint8_t*)malloc(dataSize);
-                memset(data, 0, dataSize);
-                baranium_compiler_copy_variable_data(data, field->value, field->type);
-                fwrite(data, sizeof(uint8_t), dataSize, file);
-                free(data);
-
-                baranium_symbol_table_add_from_name_and_id(&compiler->var_table, token->name, token->id);
-                continue;
-            }
+            baranium_compiler_code_builder_clear(compiler);
+            continue;
+        }
+
+        if (token->type == BARANIUM_TOKEN_TYPE_VARIABLE)
+        {
+            baranium_variable_token* variable = (baranium_variable_token*)token;
+            entry->type = BARANIUM_SCRIPT_SECTION_TYPE_FIELDS;
+            entry->data_size = baranium_compiler_image_append_value(&image, baranium_compiler_get_initial_value(variable->value, &variable->init_expression, initialValue, sizeof(initialValue)), variable->type);
+            baranium_symbol_table_add_from_name_id_and_type(&compiler->var_table, token->name, token->id, variable->type);
+            continue;
         }
 
-        // update the old section count
-        size_t end_pos = ftell(file);
-        fseek(file, tokencountposition, SEEK_SET);
-        header.section_count = tokens->count - uselesssectioncount;
-        fwrite(&header.section_count, sizeof(uint64_t), 1, file);
-        fseek(file, exportcountposition, SEEK_SET);
-        fwrite(&header.exports_count, sizeof(uint64_t), 1, file);
-        fseek(file, end_pos, SEEK_SET);
+        baranium_field_token* field = (baranium_field_token*)token;
+        entry->type = BARANIUM_SCRIPT_SECTION_TYPE_FIELDS;
+        entry->data_size = baranium_compiler_image_append_value(&image, baranium_compiler_get_initial_value(field->value, &field->init_expression, initialValue, sizeof(initialValue)), field->type);
+        baranium_symbol_table_add_from_name_id_and_type(&compiler->var_table, token->name, token->id, field->type);
+    }
+
+    if (!image.failed)
+    {
+        qsort(directory, sectionCount, sizeof(baranium_binary_section_entry), baranium_compiler_compare_sections);
+        baranium_compiler_image_patch(&image, index.directory_offset, directory, sizeof(baranium_binary_section_entry) * sectionCount);
+    }
+
+    // name table, kept at most half full so that probing stays short
+    index.name_bucket_count = 0;
+    if (sectionCount != 0)
+    {
+        index.name_bucket_count = 1;
+        while (index.name_bucket_count < sectionCount * 2)
+            index.name_bucket_count <<= 1;
+    }
+
+    baranium_compiler_image_align(&image);
+    index.name_table_offset = baranium_compiler_image_reserve(&image, sizeof(baranium_binary_name_bucket) * index.name_bucket_count);
+    for (uint64_t i = 0; !image.failed && i < index.name_bucket_count; i++)
+    {
+        baranium_binary_name_bucket empty = {.id=BARANIUM_INVALID_INDEX,.name_offset=0};
+        baranium_compiler_image_patch(&image, index.name_table_offset + i * sizeof(baranium_binary_name_bucket), &empty, sizeof(baranium_binary_name_bucket));
+    }
+
+    for (uint64_t i = 0; !image.failed && i < sectionCount; i++)
+    {
+        baranium_binary_name_bucket bucket = {
+            .id = named[i]->id,
+            .name_offset = baranium_compiler_image_append(&image, named[i]->name, strlen(named[i]->name) + 1),
+        };
+        if (image.failed)
+            break;
+
+        // names that share an id each get their own bucket, so the probing goes on past buckets of the same id
+        uint64_t slot = bidhash_home(bucket.id, index.name_bucket_count);
+        baranium_binary_name_bucket* buckets = (baranium_binary_name_bucket*)(image.data + index.name_table_offset);
+        while (buckets[slot].id != BARANIUM_INVALID_INDEX)
+            slot = bidhash_next(slot, index.name_bucket_count);
+        buckets[slot] = bucket;
     }
 
     // write dependencies (shared feature on both library files and executable scripts)
-    fwrite(&compiler->dependency_count, sizeof(size_t), 1, file);
+    baranium_compiler_image_align(&image);
+    index.dependency_offset = baranium_compiler_image_append(&image, &compiler->dependency_count, sizeof(size_t));
     for (size_t i = 0; i < compiler->dependency_count; i++)
     {
         const char* dependency = compiler->dependencies[i];
         size_t len = strlen(dependency);
-        fwrite(&len, sizeof(size_t), 1, file);
-        fwrite(dependency, sizeof(char), len, file);
+        baranium_compiler_image_append(&image, &len, sizeof(size_t));
+        baranium_compiler_image_append(&image, dependency, len);
     }
+
+    if (library)
+        baranium_compiler_image_patch(&image, 0, &libheader, sizeof(baranium_library_header));
+    else
+        baranium_compiler_image_patch(&image, 0, &scriptheader, sizeof(baranium_script_header));
+    baranium_compiler_image_patch(&image, indexposition, &index, sizeof(baranium_binary_index));
+
+    if (image.failed)
+        LOGERROR("Could not allocate enough memory to write the %s", library ? "library" : "script");
+    else if (fwrite(image.data, 1, image.size, file) != image.size)
+        LOGERROR("Could not write the %s", library ? "library" : "script");
+
+    free(directory);
+    free(named);
+    free(image.data);
 }
 
 void baranium_compiler_clear_compiled_code(baranium_compiler* compiler)
@@ -552,6 +753,10 @@ void baranium_compiler_copy_variable_data(void* __dst, const char* __src, barani
     (*(uint8_t*)__dst) = (uint8_t)varType;
     void* dest = (void*)((uint64_t)__dst + 1);
 
+    // variables without an initial value are zero initialized
+    if (__src == NULL)
+        __src = "";
+
     switch (varType)
     {
         default:
@@ -686,8 +891,8 @@ baranium_compiler baranium_compiler_predict_code_size(baranium_compiler* compile
 {
     baranium_compiler c;
     baranium_compiler_init(&c);
-    for (size_t i = 0; i < compiler->var_table.count; i++)
-        baranium_symbol_table_add_from_name_and_id(&c.var_table, compiler->var_table.data[i].name, compiler->var_table.data[i].id);
+    baranium_symbol_table_copy(&c.var_table, &compiler->var_table);
+    c.local_count = compiler->local_count;
 
     baranium_compiler_compile(&c, tokens);
     return c;
@@ -697,13 +902,24 @@ baranium_compiler baranium_compiler_predict_code_size_expression(baranium_compil
 {
     baranium_compiler c;
     baranium_compiler_init(&c);
-    for (size_t i = 0; i < compiler->var_table.count; i++)
-        baranium_symbol_table_add_from_name_and_id(&c.var_table, compiler->var_table.data[i].name, compiler->var_table.data[i].id);
+    baranium_symbol_table_copy(&c.var_table, &compiler->var_table);
+    c.local_count = compiler->local_count;
 
     baranium_compiler_compile_expression(&c, token);
     return c;
 }
 
+baranium_compiler baranium_compiler_predict_code_size_loop_condition(baranium_compiler* compiler, baranium_expression_token* condition)
+{
+    baranium_compiler c;
+    baranium_compiler_init(&c);
+    baranium_symbol_table_copy(&c.var_table, &compiler->var_table);
+    c.local_count = compiler->local_count;
+
+    baranium_compiler_compile_loop_condition(&c, condition, 0);
+    return c;
+}
+
 baranium_value_t baranium_compiler_get_variable_value_as_data(const char* value, baranium_variable_type_t type)
 {
     baranium_value_t data = {0};
@@ -755,118 +971,83 @@ baranium_value_t baranium_compiler_get_variable_value_as_data(const char* value,
 
 void baranium_compiler_compile_variable(baranium_compiler* compiler, baranium_variable_token* token)
 {
-    size_t size = baranium_variable_get_size_of_type(token->type);
-    if (token->type == BARANIUM_VARIABLE_TYPE_STRING)
-    {
-        if (token->value)
-            size = strlen(token->value) + 1; // plus the nullchar at the end
-        else
-            size = 1;
-    }
+    if (token->base.id == BARANIUM_INVALID_INDEX)
+        return;
+
+    // variables inside of functions are locals that live in the frame of the function
+    index_t slot = compiler->local_count++;
+    baranium_symbol_table_add_local(&compiler->var_table, token, slot);
 
-    baranium_compiler_code_builder_MEM(compiler, size, (uint8_t)token->type, token->base.id);
     if (token->init_expression.expression_type != BARANIUM_EXPRESSION_TYPE_INVALID)
-        baranium_compiler_compile_expression(compiler, &token->init_expression);
-    else if (token->type != BARANIUM_VARIABLE_TYPE_OBJECT)
-    {
-        baranium_value_t data = baranium_compiler_get_variable_value_as_data(token->value, token->type);
-        baranium_compiler_code_builder_SET(compiler, token->base.id, size, data, token->type);
-    }
-    else
     {
-        if (token->value == baranium_keywords[BARANIUM_KEYWORD_INDEX_ATTACHED].name)
-            baranium_compiler_code_builder_PUSH(compiler, -1);
-        else if (token->value == baranium_keywords[BARANIUM_KEYWORD_INDEX_NULL].name)
-            baranium_compiler_code_builder_PUSH(compiler, 0);
-        else if (strisnum(token->value))
-            baranium_compiler_code_builder_PUSH(compiler, strgetnumval(token->value));
-        else
-        {
-            index_t varID = baranium_compiler_get_id(compiler, token->value, -1);
-            baranium_compiler_code_builder_PUSHVAR(compiler, varID);
-            baranium_compiler_code_builder_POPVAR(compiler, token->base.id);
-        }
-        baranium_compiler_code_builder_POPVAR(compiler, token->base.id);
+        baranium_compiler_compile_expression(compiler, &token->init_expression);
+        return;
     }
 
-    baranium_symbol_table_add(&compiler->var_table, token);
+    baranium_compiler_compile_value(compiler, token->value, token->type);
+    baranium_compiler_code_builder_STORELOCAL(compiler, slot, token->type);
 }
 
-void baranium_compiler_compile_if_else_statement(baranium_compiler* compiler, baranium_if_else_token* token)
+void baranium_compiler_compile_value(baranium_compiler* compiler, const char* value, baranium_variable_type_t type)
 {
-    baranium_compiler code = baranium_compiler_predict_code_size(compiler, &token->tokens);
-    baranium_compiler_code_builder_SCF(compiler);
-    baranium_compiler_compile_expression(compiler, &token->condition);
-    baranium_compiler_code_builder_PUSHCV(compiler);
-    baranium_compiler_code_builder_ICV(compiler);
-    baranium_compiler_code_builder_JMPCOFF(compiler, code.code_length);
-    for (size_t i = 0; i < code.code_length; i++)
-        baranium_compiler_code_builder_push(compiler, code.code[i]);
-
-    for (size_t i = 0; i < token->chained_statements.count; i++)
-        baranium_compiler_compile_if_else_sub_statement(compiler, (baranium_if_else_token*)token->chained_statements.data[i]);
-
-    baranium_compiler_code_builder_POPCV(compiler);
-    baranium_compiler_code_builder_CCF(compiler);
-
-    baranium_compiler_dispose(&code);
+    if (type == BARANIUM_VARIABLE_TYPE_STRING)
+        baranium_compiler_code_builder_push_string(compiler, value ? value : "");
+    else if (type != BARANIUM_VARIABLE_TYPE_OBJECT)
+    {
+        baranium_value_t data = baranium_compiler_get_variable_value_as_data(value, type);
+        baranium_compiler_code_builder_PUSHV(compiler, type, baranium_variable_get_size_of_type(type), &data);
+    }
+    else if (value == baranium_keywords[BARANIUM_KEYWORD_INDEX_ATTACHED].name)
+        baranium_compiler_code_builder_push_object(compiler, -1);
+    else if (value == NULL || value == baranium_keywords[BARANIUM_KEYWORD_INDEX_NULL].name)
+        baranium_compiler_code_builder_push_object(compiler, 0);
+    else if (strisnum(value))
+        baranium_compiler_code_builder_push_object(compiler, strgetnumval(value));
+    else
+        baranium_compiler_compile_load_variable(compiler, baranium_compiler_get_id(compiler, value, -1));
 }
 
-void baranium_compiler_compile_if_else_sub_statement(baranium_compiler* compiler, baranium_if_else_token* token)
+void baranium_compiler_compile_if_else_statement(baranium_compiler* compiler, baranium_if_else_token* token)
 {
-    if (token->condition.base.type == BARANIUM_TOKEN_TYPE_INVALID)
+    // every branch but the last one jumps to the end of the statement, which is only known at the end
+    size_t exits = 0;
+    size_t count = token->chained_statements.count;
+
+    for (size_t i = 0; i <= count; i++)
     {
-        baranium_compiler_compile_else_statement(compiler, token);
-        return;
-    }
+        baranium_if_else_token* branch = i == 0 ? token : (baranium_if_else_token*)token->chained_statements.data[i-1];
+        uint8_t hasCondition = branch->condition.base.type != BARANIUM_TOKEN_TYPE_INVALID;
 
-    baranium_compiler code = baranium_compiler_predict_code_size(compiler, &token->tokens);
-    baranium_compiler condition = baranium_compiler_predict_code_size_expression(compiler, &token->condition);
-    baranium_compiler_code_builder_SCF(compiler);
-    baranium_compiler_code_builder_POPCV(compiler);
-    baranium_compiler_code_builder_PUSHCV(compiler);
-    baranium_compiler_code_builder_JMPCOFF(compiler, condition.code_length + 3); // + 3 because POPCV, PUSHCV and ICV are one byte instructions each
-    baranium_compiler_code_builder_POPCV(compiler);
-    for (size_t i = 0; i < condition.code_length; i++)
-        baranium_compiler_code_builder_push(compiler, condition.code[i]);
-    baranium_compiler_code_builder_PUSHCV(compiler);
-    baranium_compiler_code_builder_ICV(compiler);
-    baranium_compiler_code_builder_JMPCOFF(compiler, code.code_length);
-    for (size_t i = 0; i < code.code_length; i++)
-        baranium_compiler_code_builder_push(compiler, code.code[i]);
+        size_t skip = 0;
+        if (hasCondition)
+            baranium_compiler_compile_branch(compiler, &branch->condition, 0, &skip);
 
-    baranium_compiler_dispose(&code);
-    baranium_compiler_dispose(&condition);
-}
+        // the body is compiled in place so jumps inside of it get their final addresses, its variables stay inside of it
+        size_t symbolCount = compiler->var_table.count;
+        baranium_compiler_compile(compiler, &branch->tokens);
+        compiler->var_table.count = symbolCount;
 
-void baranium_compiler_compile_else_statement(baranium_compiler* compiler, baranium_if_else_token* token)
-{
-    if (token->condition.base.type != BARANIUM_TOKEN_TYPE_INVALID)
-        return;
+        if (i < count)
+        {
+            baranium_compiler_code_builder_JMP(compiler, exits);
+            exits = compiler->code_length - sizeof(uint64_t);
+        }
 
-    baranium_compiler code = baranium_compiler_predict_code_size(compiler, &token->tokens);
-    baranium_compiler_code_builder_SCF(compiler);
-    baranium_compiler_code_builder_POPCV(compiler);
-    baranium_compiler_code_builder_PUSHCV(compiler);
-    baranium_compiler_code_builder_JMPCOFF(compiler, code.code_length);
-    for (size_t i = 0; i < code.code_length; i++)
-        baranium_compiler_code_builder_push(compiler, code.code[i]);
+        baranium_compiler_code_builder_patch_chain(compiler, skip, compiler->code_length);
+    }
 
-    baranium_compiler_dispose(&code);
+    baranium_compiler_code_builder_patch_chain(compiler, exits, compiler->code_length);
 }
 
 void baranium_compiler_compile_do_while_loop(baranium_compiler* compiler, baranium_loop_token* token)
 {
     uint64_t pointer = compiler->code_length;
     baranium_compiler offset0 = baranium_compiler_predict_code_size(compiler, &token->tokens);
-    baranium_compiler offset1 = baranium_compiler_predict_code_size_expression(compiler, &token->condition);
+    baranium_compiler offset1 = baranium_compiler_predict_code_size_loop_condition(compiler, &token->condition);
     compiler->loop_begin_addr = pointer + offset0.code_length;
-    compiler->loop_end_addr = compiler->loop_begin_addr + offset1.code_length + 13; // SCF, CCV, CCF each 1 byte, JMPC is 1 byte + 8 byte address
+    compiler->loop_end_addr = compiler->loop_begin_addr + offset1.code_length + 2; // CCV, CCF each 1 byte
     baranium_compiler_compile(compiler, &token->tokens);
-    baranium_compiler_code_builder_SCF(compiler);
-    baranium_compiler_code_builder_CCV(compiler);
-    baranium_compiler_compile_expression(compiler, &token->condition);
-    baranium_compiler_code_builder_JMPC(compiler, pointer);
+    baranium_compiler_compile_loop_condition(compiler, &token->condition, pointer);
     baranium_compiler_code_builder_CCV(compiler);
     baranium_compiler_code_builder_CCF(compiler);
 
@@ -877,16 +1058,13 @@ void baranium_compiler_compile_do_while_loop(baranium_compiler* compiler, barani
 void baranium_compiler_compile_while_loop(baranium_compiler* compiler, baranium_loop_token* token)
 {
     baranium_compiler offset0 = baranium_compiler_predict_code_size(compiler, &token->tokens);
-    baranium_compiler offset1 = baranium_compiler_predict_code_size_expression(compiler, &token->condition);
+    baranium_compiler offset1 = baranium_compiler_predict_code_size_loop_condition(compiler, &token->condition);
     baranium_compiler_code_builder_JMPOFF(compiler, offset0.code_length);
     uint64_t pointer = compiler->code_length;
     compiler->loop_begin_addr = pointer + offset0.code_length;
-    compiler->loop_end_addr = compiler->loop_begin_addr + offset1.code_length + 13; // SCF, CCV, CCF each 1 byte, JMPC is 1 byte + 8 byte address
+    compiler->loop_end_addr = compiler->loop_begin_addr + offset1.code_length + 2; // CCV, CCF each 1 byte
     baranium_compiler_compile(compiler, &token->tokens);
-    baranium_compiler_code_builder_SCF(compiler);
-    baranium_compiler_code_builder_CCV(compiler);
-    baranium_compiler_compile_expression(compiler, &token->condition);
-    baranium_compiler_code_builder_JMPC(compiler, pointer);
+    baranium_compiler_compile_loop_condition(compiler, &token->condition, pointer);
     baranium_compiler_code_builder_CCV(compiler);
     baranium_compiler_code_builder_CCF(compiler);
 
@@ -897,27 +1075,22 @@ void baranium_compiler_compile_while_loop(baranium_compiler* compiler, baranium_
 void baranium_compiler_compile_for_loop(baranium_compiler* compiler, baranium_loop_token* token)
 {
     baranium_compiler_compile_variable(compiler, &token->start_variable); // either a variable was declared
-    baranium_compiler_compile_expression(compiler, &token->start_expression);   // or a starting expression
+    if (token->start_expression.expression_type != BARANIUM_EXPRESSION_TYPE_INVALID)
+        baranium_compiler_compile_expression(compiler, &token->start_expression);   // or a starting expression
     baranium_compiler offset0 = baranium_compiler_predict_code_size(compiler, &token->tokens);
     baranium_compiler offset1 = baranium_compiler_predict_code_size_expression(compiler, &token->iteration);
-    baranium_compiler offset2 = baranium_compiler_predict_code_size_expression(compiler, &token->condition);
+    baranium_compiler offset2 = baranium_compiler_predict_code_size_loop_condition(compiler, &token->condition);
     int offset = offset0.code_length + offset1.code_length;
     baranium_compiler_code_builder_JMPOFF(compiler, offset);
     uint64_t pointer = compiler->code_length;
     compiler->loop_begin_addr = pointer + offset0.code_length;
-    compiler->loop_end_addr = compiler->loop_begin_addr + offset2.code_length + offset1.code_length + 11; // SCF, CCV each 1 byte, JMPC is 1 byte + 8 byte address
+    compiler->loop_end_addr = compiler->loop_begin_addr + offset2.code_length + offset1.code_length;
     baranium_compiler_compile(compiler, &token->tokens);
     baranium_compiler_compile_expression(compiler, &token->iteration);
-    baranium_compiler_code_builder_SCF(compiler);
-    baranium_compiler_code_builder_CCV(compiler);
-    baranium_compiler_compile_expression(compiler, &token->condition);
-    baranium_compiler_code_builder_JMPC(compiler, pointer);
+    baranium_compiler_compile_loop_condition(compiler, &token->condition, pointer);
 
     if (token->start_variable.base.id != BARANIUM_INVALID_INDEX)
-    {
         baranium_symbol_table_remove(&compiler->var_table, &token->start_variable);
-        baranium_compiler_code_builder_FEM(compiler, token->start_variable.base.id);
-    }
 
     baranium_compiler_dispose(&offset0);
     baranium_compiler_dispose(&offset1);
@@ -951,6 +1124,24 @@ index_t baranium_compiler_get_id(baranium_compiler* compiler, const char* name,
     return varID;
 }
 
+void baranium_compiler_compile_load_variable(baranium_compiler* compiler, index_t id)
+{
+    baranium_symbol_table_entry* local = baranium_symbol_table_lookup_local(&compiler->var_table, id);
+    if (local != NULL)
+        baranium_compiler_code_builder_LOADLOCAL(compiler, local->local);
+    else
+        baranium_compiler_code_builder_PUSHVAR(compiler, id);
+}
+
+void baranium_compiler_compile_store_variable(baranium_compiler* compiler, index_t id)
+{
+    baranium_symbol_table_entry* local = baranium_symbol_table_lookup_local(&compiler->var_table, id);
+    if (local != NULL)
+        baranium_compiler_code_builder_STORELOCAL(compiler, local->local, local->type);
+    else
+        baranium_compiler_code_builder_POPVAR(compiler, id);
+}
+
 void baranium_compiler_compile_expression(baranium_compiler* compiler, baranium_expression_token* token)
 {
     baranium_abstract_syntax_tree_node* ast_root = token->ast;
@@ -964,6 +1155,7 @@ void baranium_compiler_compile_expression(baranium_compiler* compiler, baranium_
 
     if (token->expression_type == BARANIUM_EXPRESSION_TYPE_CONDITION)
     {
+        baranium_compiler_code_builder_SCF(compiler);
         baranium_compiler_compile_condition(compiler, ast_root);
         return;
     }
@@ -1012,21 +1204,20 @@ void baranium_compiler_compile_ast_node(baranium_compiler* compiler, baranium_ab
     baranium_compiler_context* ctx = baranium_get_compiler_context();
     baranium_source_token token = node->contents;
 
-    if (token.type == BARANIUM_SOURCE_TOKEN_TYPE_NUMBER && !isRoot)
+    baranium_variable_type_t literalType = BARANIUM_VARIABLE_TYPE_INVALID;
+    baranium_value_t literal = {0};
+    if (!isRoot && baranium_compiler_get_number_literal(node, &literalType, &literal))
     {
-        uint64_t value = 0;
-        if (stridx(token.contents, '.') != -1)
-        {
-            float val = strgetfloatval(token.contents);
-            baranium_compiler_code_builder_push_float(compiler, val);
-        }
+        if (literalType == BARANIUM_VARIABLE_TYPE_FLOAT)
+            baranium_compiler_code_builder_push_float(compiler, literal.numfloat);
+        else if (literalType == BARANIUM_VARIABLE_TYPE_INT64)
+            baranium_compiler_code_builder_push_int64(compiler, literal.snum64);
         else
-        {
-            value = strgetnumval(token.contents);
-            baranium_compiler_code_builder_push_int(compiler, value);
-        }
+            baranium_compiler_code_builder_push_int(compiler, literal.snum32);
+        return;
     }
-    else if (token.type == BARANIUM_SOURCE_TOKEN_TYPE_KEYWORD && !isRoot)
+
+    if (token.type == BARANIUM_SOURCE_TOKEN_TYPE_KEYWORD && !isRoot)
     {
         if (token.special_index == BARANIUM_KEYWORD_INDEX_FALSE)
             baranium_compiler_code_builder_push_bool(compiler, 0);
@@ -1043,7 +1234,7 @@ void baranium_compiler_compile_ast_node(baranium_compiler* compiler, baranium_ab
     else if (token.type == BARANIUM_SOURCE_TOKEN_TYPE_NULL && !isRoot)
         baranium_compiler_code_builder_push_uint(compiler, 0);
     else if (token.type == BARANIUM_SOURCE_TOKEN_TYPE_TEXT && !isRoot)
-        baranium_compiler_code_builder_PUSHVAR(compiler, baranium_compiler_get_id(compiler, token.contents, token.line_number));
+        baranium_compiler_compile_load_variable(compiler, baranium_compiler_get_id(compiler, token.contents, token.line_number));
     else if (token.type == BARANIUM_SOURCE_TOKEN_TYPE_DOUBLEQUOTE && !isRoot)
     {
         char* contents = "";
@@ -1071,8 +1262,11 @@ void baranium_compiler_compile_ast_node(baranium_compiler* compiler, baranium_ab
     if (token.type == BARANIUM_SOURCE_TOKEN_TYPE_EQUALTO   || token.type == BARANIUM_SOURCE_TOKEN_TYPE_NOTEQUAL       ||
         token.type == BARANIUM_SOURCE_TOKEN_TYPE_LESSEQUAL || token.type == BARANIUM_SOURCE_TOKEN_TYPE_GREATEREQUAL   ||
         token.type == BARANIUM_SOURCE_TOKEN_TYPE_LESSTHAN  || token.type == BARANIUM_SOURCE_TOKEN_TYPE_GREATERTHAN    ||
-        token.type == BARANIUM_SOURCE_TOKEN_TYPE_ANDAND    || token.type == BARANIUM_SOURCE_TOKEN_TYPE_OROR)
+        token.type == BARANIUM_SOURCE_TOKEN_TYPE_ANDAND    || token.type == BARANIUM_SOURCE_TOKEN_TYPE_OROR           ||
+        token.type == BARANIUM_SOURCE_TOKEN_TYPE_EXCLAMATIONPOINT)
     {
+        // loops clear the compare flag once they are done
+        baranium_compiler_code_builder_SCF(compiler);
         baranium_compiler_compile_condition(compiler, node);
         baranium_compiler_code_builder_PUSHCV(compiler);
     }
@@ -1095,21 +1289,49 @@ void baranium_compiler_compile_assignment(baranium_compiler* compiler, baranium_
     const char* varName = leftToken.contents;
     index_t varID = baranium_compiler_get_id(compiler, varName, leftToken.line_number);
 
-    baranium_compiler_compile_ast_node(compiler, root->right, 0);
+    // adding/subtracting a constant doesn't need to go over the stack
+    baranium_variable_type_t literalType = BARANIUM_VARIABLE_TYPE_INVALID;
+    baranium_value_t literal = {0};
+    if ((root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_PLUSEQUAL || root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_MINUSEQUAL) &&
+        baranium_compiler_get_number_literal(root->right, &literalType, &literal))
+    {
+        if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_MINUSEQUAL && literalType == BARANIUM_VARIABLE_TYPE_FLOAT)
+            literal.numfloat = -literal.numfloat;
+        else if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_MINUSEQUAL)
+            literal.snum64 = -literal.snum64;
+
+        baranium_symbol_table_entry* local = baranium_symbol_table_lookup_local(&compiler->var_table, varID);
+        if (local != NULL)
+            baranium_compiler_code_builder_ADDLOCAL_IMM(compiler, local->local, literalType, literal);
+        else
+            baranium_compiler_code_builder_ADDVAR_IMM(compiler, varID, literalType, literal);
+        return;
+    }
+
+    baranium_symbol_table_entry* local = baranium_symbol_table_lookup_local(&compiler->var_table, varID);
+    if (local != NULL && root->right != NULL && baranium_compiler_compile_register_assignment(compiler, root, local))
+        return;
 
     if (root->contents.type != BARANIUM_SOURCE_TOKEN_TYPE_EQUALSIGN)
-        baranium_compiler_code_builder_PUSHVAR(compiler, varID);
+        baranium_compiler_compile_load_variable(compiler, varID);
+
+    baranium_compiler_compile_ast_node(compiler, root->right, 0);
+
+    // the typed operations can only be used if both sides are known to have the same type
+    baranium_variable_type_t type = baranium_compiler_infer_type(compiler, root->left);
+    if (type != baranium_compiler_infer_type(compiler, root->right))
+        type = BARANIUM_VARIABLE_TYPE_INVALID;
 
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_MODEQUAL)
-        baranium_compiler_code_builder_MOD(compiler);
+        baranium_compiler_code_builder_TMOD(compiler, type);
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_DIVEQUAL)
-        baranium_compiler_code_builder_DIV(compiler);
+        baranium_compiler_code_builder_TDIV(compiler, type);
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_MULEQUAL)
-        baranium_compiler_code_builder_MUL(compiler);
+        baranium_compiler_code_builder_TMUL(compiler, type);
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_MINUSEQUAL)
-        baranium_compiler_code_builder_SUB(compiler);
+        baranium_compiler_code_builder_TSUB(compiler, type);
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_PLUSEQUAL)
-        baranium_compiler_code_builder_ADD(compiler);
+        baranium_compiler_code_builder_TADD(compiler, type);
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_ANDEQUAL)
         baranium_compiler_code_builder_AND(compiler);
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_OREQUAL)
@@ -1117,7 +1339,7 @@ void baranium_compiler_compile_assignment(baranium_compiler* compiler, baranium_
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_XOREQUAL)
         baranium_compiler_code_builder_XOR(compiler);
 
-    baranium_compiler_code_builder_POPVAR(compiler, varID);
+    baranium_compiler_compile_store_variable(compiler, varID);
 }
 
 void baranium_compiler_compile_return_statement(baranium_compiler* compiler, baranium_expression_token* expression)
@@ -1126,27 +1348,25 @@ void baranium_compiler_compile_return_statement(baranium_compiler* compiler, bar
     {
         const char* varName = expression->return_variable;
         index_t varID = baranium_compiler_get_id(compiler, varName, expression->line_number);
-        baranium_compiler_code_builder_PUSHVAR(compiler, varID);
+        baranium_compiler_compile_load_variable(compiler, varID);
+    }
+    else if (expression->return_expression != NULL && expression->return_expression->expression_type == BARANIUM_EXPRESSION_TYPE_FUNCTION_CALL)
+    {
+        // nothing is left to do in this function after the call, so the callee can reuse its frame
+        baranium_abstract_syntax_tree_node* call = expression->return_expression->ast;
+        index_t id = baranium_compiler_get_id(compiler, call->contents.contents, call->contents.line_number);
+        for (size_t i = 0; i < call->sub_nodes.count; i++)
+            baranium_compiler_compile_ast_node(compiler, call->sub_nodes.nodes[i], 0);
+
+        baranium_compiler_code_builder_TAILCALL(compiler, id);
+        return;
     }
     else if (expression->return_expression != NULL)
         baranium_compiler_compile_ast_node(compiler, expression->return_expression->ast, 1);
     else if (expression->return_type != BARANIUM_VARIABLE_TYPE_VOID)
-    {
-        baranium_variable_token var;
-        baranium_variable_token_init(&var);
-        var.type = expression->return_type;
-        var.value = expression->return_value;
-        var.base.id = 0;
-        baranium_compiler_compile_variable(compiler, &var);
-        baranium_compiler_code_builder_PUSHVAR(compiler, 0);
-        baranium_compiler_code_builder_FEM(compiler, 0);
-        baranium_symbol_table_remove(&compiler->var_table, &var);
-    }
-
-    // clear all currently allocated variables
-    for (size_t i = 0; i < compiler->var_table.count; i++)
-        baranium_compiler_code_builder_FEM(compiler, compiler->var_table.data[i].id);
+        baranium_compiler_compile_value(compiler, expression->return_value, expression->return_type);
 
+    // the locals are freed together with the frame of the function
     baranium_compiler_code_builder_RET(compiler);
 }
 
@@ -1163,10 +1383,11 @@ void baranium_compiler_compile_arithmetic_operation(baranium_compiler* compiler,
         // to do this other than having duplicated code, sorry
         const char* varName = lhs->contents.contents;
         index_t varID = baranium_compiler_get_id(compiler, varName, lhs->contents.line_number);
-        baranium_compiler_code_builder_PUSHVAR(compiler, varID);
-        baranium_compiler_code_builder_push_int(compiler, 1);
-        baranium_compiler_code_builder_SUB(compiler);
-        baranium_compiler_code_builder_POPVAR(compiler, varID);
+        baranium_symbol_table_entry* local = baranium_symbol_table_lookup_local(&compiler->var_table, varID);
+        if (local != NULL)
+            baranium_compiler_code_builder_DECLOCAL(compiler, local->local);
+        else
+            baranium_compiler_code_builder_DECVAR(compiler, varID);
         return;
     }
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_PLUSPLUS && lhs->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_TEXT)
@@ -1175,10 +1396,11 @@ void baranium_compiler_compile_arithmetic_operation(baranium_compiler* compiler,
         // to do this other than having duplicated code, sorry
         const char* varName = lhs->contents.contents;
         index_t varID = baranium_compiler_get_id(compiler, varName, lhs->contents.line_number);
-        baranium_compiler_code_builder_PUSHVAR(compiler, varID);
-        baranium_compiler_code_builder_push_int(compiler, 1);
-        baranium_compiler_code_builder_ADD(compiler);
-        baranium_compiler_code_builder_POPVAR(compiler, varID);
+        baranium_symbol_table_entry* local = baranium_symbol_table_lookup_local(&compiler->var_table, varID);
+        if (local != NULL)
+            baranium_compiler_code_builder_INCLOCAL(compiler, local->local);
+        else
+            baranium_compiler_code_builder_INCVAR(compiler, varID);
         return;
     }
 
@@ -1192,6 +1414,13 @@ void baranium_compiler_compile_arithmetic_operation(baranium_compiler* compiler,
         return;
     }
 
+    if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_PLUS && baranium_compiler_compile_concatenation(compiler, root))
+        return;
+
+    // computing it in the frame takes one instruction per operation instead of one per operand and operation
+    if (baranium_compiler_compile_register_push(compiler, root))
+        return;
+
     if (lhs)
         baranium_compiler_compile_ast_node(compiler, lhs, 0);
     else
@@ -1202,16 +1431,18 @@ void baranium_compiler_compile_arithmetic_operation(baranium_compiler* compiler,
     else
         baranium_compiler_code_builder_push_int(compiler, 0);
 
+    baranium_variable_type_t type = baranium_compiler_infer_type(compiler, root);
+
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_MODULO)
-        baranium_compiler_code_builder_MOD(compiler);
+        baranium_compiler_code_builder_TMOD(compiler, type);
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_SLASH)
-        baranium_compiler_code_builder_DIV(compiler);
+        baranium_compiler_code_builder_TDIV(compiler, type);
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_ASTERISK)
-        baranium_compiler_code_builder_MUL(compiler);
+        baranium_compiler_code_builder_TMUL(compiler, type);
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_MINUS)
-        baranium_compiler_code_builder_SUB(compiler);
+        baranium_compiler_code_builder_TSUB(compiler, type);
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_PLUS)
-        baranium_compiler_code_builder_ADD(compiler);
+        baranium_compiler_code_builder_TADD(compiler, type);
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_AND)
         baranium_compiler_code_builder_AND(compiler);
     if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_OR)
@@ -1224,6 +1455,61 @@ void baranium_compiler_compile_arithmetic_operation(baranium_compiler* compiler,
         baranium_compiler_code_builder_SHFTR(compiler);
 }
 
+uint8_t baranium_compiler_compile_concatenation(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* root)
+{
+    // `a + b + c` is parsed as `(a + b) + c`, so the `+` nodes of a chain form the left spine of the tree
+    size_t depth = 0;
+    for (baranium_abstract_syntax_tree_node* node = root; node != NULL && node->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_PLUS; node = node->left)
+    {
+        if (node->left == NULL || node->right == NULL)
+            return 0;
+        depth++;
+    }
+
+    if (depth < 2)
+        return 0;
+
+    // the operands in source order and the spine nodes that hold them, spine[i] adds operand i + 1 to everything in front of it
+    baranium_abstract_syntax_tree_node** operands = malloc(sizeof(baranium_abstract_syntax_tree_node*) * (depth + 1));
+    baranium_abstract_syntax_tree_node** spine = malloc(sizeof(baranium_abstract_syntax_tree_node*) * depth);
+    if (operands == NULL || spine == NULL)
+    {
+        free(operands);
+        free(spine);
+        return 0;
+    }
+
+    baranium_abstract_syntax_tree_node* node = root;
+    for (size_t i = depth; i > 0; i--, node = node->left)
+    {
+        spine[i-1] = node;
+        operands[i] = node->right;
+    }
+    operands[0] = node;
+
+    // everything in front of the first string is still added up as numbers, only the rest is concatenated
+    size_t first = 0;
+    while (first <= depth && baranium_compiler_infer_type(compiler, operands[first]) != BARANIUM_VARIABLE_TYPE_STRING)
+        first++;
+
+    size_t start = first == 0 ? 1 : first;
+    if (first > depth || depth - start + 2 < 3)
+    {
+        free(operands);
+        free(spine);
+        return 0;
+    }
+
+    baranium_compiler_compile_ast_node(compiler, start == 1 ? operands[0] : spine[start-2], 0);
+    for (size_t i = start; i <= depth; i++)
+        baranium_compiler_compile_ast_node(compiler, operands[i], 0);
+
+    baranium_compiler_code_builder_CONCATN(compiler, depth - start + 2);
+    free(operands);
+    free(spine);
+    return 1;
+}
+
 void baranium_compiler_compile_condition(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* root)
 {
     if (root == NULL) return;
@@ -1231,6 +1517,29 @@ void baranium_compiler_compile_condition(baranium_compiler* compiler, baranium_a
     baranium_abstract_syntax_tree_node* lhs = root->left;
     baranium_abstract_syntax_tree_node* rhs = root->right;
 
+    // the right side only runs if the left one doesn't decide the result already, which is then left in the compare value
+    if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_ANDAND || root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_OROR)
+    {
+        size_t chain = 0;
+        baranium_compiler_compile_condition_operand(compiler, lhs);
+        if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_ANDAND)
+            baranium_compiler_code_builder_JMPNC(compiler, chain);
+        else
+            baranium_compiler_code_builder_JMPC(compiler, chain);
+        chain = compiler->code_length - sizeof(uint64_t);
+
+        baranium_compiler_compile_condition_operand(compiler, rhs);
+        baranium_compiler_code_builder_patch_chain(compiler, chain, compiler->code_length);
+        return;
+    }
+
+    if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_EXCLAMATIONPOINT)
+    {
+        baranium_compiler_compile_condition_operand(compiler, rhs);
+        baranium_compiler_code_builder_ICV(compiler);
+        return;
+    }
+
     if (lhs)
         baranium_compiler_compile_ast_node(compiler, lhs, 0);
     else
@@ -1241,12 +1550,344 @@ void baranium_compiler_compile_condition(baranium_compiler* compiler, baranium_a
     else
         baranium_compiler_code_builder_push_int(compiler, 0);
 
-    if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_ANDAND)
-        baranium_compiler_code_builder_CMPC(compiler, BARANIUM_CMP_AND);
-    else if (root->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_OROR)
-        baranium_compiler_code_builder_CMPC(compiler, BARANIUM_CMP_OR);
+    baranium_variable_type_t type = baranium_compiler_infer_type(compiler, lhs);
+    if (type != baranium_compiler_infer_type(compiler, rhs))
+        type = BARANIUM_VARIABLE_TYPE_INVALID;
+
+    baranium_compiler_code_builder_TCMP(compiler, baranium_compiler_get_compare_method(root->contents.type), type);
+}
+
+void baranium_compiler_compile_condition_operand(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node)
+{
+    if (node != NULL && node->sub_nodes.count == 0 &&
+        (baranium_compiler_is_compare_operator(node->contents.type) || node->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_EXCLAMATIONPOINT ||
+         node->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_ANDAND || node->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_OROR))
+    {
+        baranium_compiler_compile_condition(compiler, node);
+        return;
+    }
+
+    if (node)
+        baranium_compiler_compile_ast_node(compiler, node, 0);
+    else
+        baranium_compiler_code_builder_push_int(compiler, 0);
+    baranium_compiler_code_builder_POPCV(compiler);
+}
+
+void baranium_compiler_compile_loop_condition(baranium_compiler* compiler, baranium_expression_token* condition, uint64_t addr)
+{
+    size_t chain = 0;
+    baranium_compiler_compile_branch(compiler, condition, 1, &chain);
+    baranium_compiler_code_builder_patch_chain(compiler, chain, addr);
+}
+
+void baranium_compiler_compile_branch(baranium_compiler* compiler, baranium_expression_token* condition, uint8_t when, size_t* chain)
+{
+    if (condition->expression_type == BARANIUM_EXPRESSION_TYPE_CONDITION && condition->ast != NULL)
+    {
+        baranium_compiler_compile_condition_jump(compiler, condition->ast, when, chain);
+        return;
+    }
+
+    // anything else leaves its value on the stack
+    baranium_compiler_code_builder_SCF(compiler);
+    baranium_compiler_compile_expression(compiler, condition);
+    baranium_compiler_code_builder_POPCV(compiler);
+    if (when)
+        baranium_compiler_code_builder_JMPC(compiler, *chain);
+    else
+        baranium_compiler_code_builder_JMPNC(compiler, *chain);
+    *chain = compiler->code_length - sizeof(uint64_t);
+}
+
+void baranium_compiler_compile_condition_jump(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node, uint8_t when, size_t* chain)
+{
+    baranium_source_token_type_t type = node ? node->contents.type : BARANIUM_SOURCE_TOKEN_TYPE_INVALID;
+    if (node != NULL && node->sub_nodes.count == 0 &&
+        (type == BARANIUM_SOURCE_TOKEN_TYPE_ANDAND || type == BARANIUM_SOURCE_TOKEN_TYPE_OROR))
+    {
+        // `a && b` can only jump if false and `a || b` only if true without looking at `b`, otherwise `a` skips the
+        // jump of `b` if it decides the result the other way
+        uint8_t isAnd = type == BARANIUM_SOURCE_TOKEN_TYPE_ANDAND;
+        if (when != isAnd)
+        {
+            baranium_compiler_compile_condition_jump(compiler, node->left, when, chain);
+            baranium_compiler_compile_condition_jump(compiler, node->right, when, chain);
+            return;
+        }
+
+        size_t skip = 0;
+        baranium_compiler_compile_condition_jump(compiler, node->left, !when, &skip);
+        baranium_compiler_compile_condition_jump(compiler, node->right, when, chain);
+        baranium_compiler_code_builder_patch_chain(compiler, skip, compiler->code_length);
+        return;
+    }
+
+    if (node != NULL && node->sub_nodes.count == 0 && type == BARANIUM_SOURCE_TOKEN_TYPE_EXCLAMATIONPOINT)
+    {
+        baranium_compiler_compile_condition_jump(compiler, node->right, !when, chain);
+        return;
+    }
+
+    // jumping if false is done by jumping on the inverted comparison, which only differs from negating the original one for NaN
+    if (node != NULL && node->sub_nodes.count == 0 && baranium_compiler_is_compare_operator(type))
+    {
+        uint8_t compareMethod = baranium_compiler_get_compare_method(type);
+        baranium_compiler_compile_compare_jump(compiler, node, when ? compareMethod : baranium_compiler_invert_compare_method(compareMethod), *chain);
+        *chain = compiler->code_length - sizeof(uint64_t);
+        return;
+    }
+
+    baranium_compiler_code_builder_SCF(compiler);
+    baranium_compiler_compile_condition_operand(compiler, node);
+    if (when)
+        baranium_compiler_code_builder_JMPC(compiler, *chain);
+    else
+        baranium_compiler_code_builder_JMPNC(compiler, *chain);
+    *chain = compiler->code_length - sizeof(uint64_t);
+}
+
+void baranium_compiler_compile_compare_jump(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* root, uint8_t compareMethod, uint64_t addr)
+{
+    // `variable <compare> number` is the condition of most loops, so it gets its own instruction
+    baranium_variable_type_t literalType = BARANIUM_VARIABLE_TYPE_INVALID;
+    baranium_value_t literal = {0};
+    if (root->left != NULL && root->left->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_TEXT && root->left->sub_nodes.count == 0 &&
+        baranium_compiler_get_number_literal(root->right, &literalType, &literal))
+    {
+        index_t varID = baranium_compiler_get_id(compiler, root->left->contents.contents, root->left->contents.line_number);
+        baranium_symbol_table_entry* local = baranium_symbol_table_lookup_local(&compiler->var_table, varID);
+        if (local != NULL)
+            baranium_compiler_code_builder_CMPLOCAL_IMM_JMP(compiler, local->local, literalType, literal, compareMethod, addr);
+        else
+            baranium_compiler_code_builder_CMPVAR_IMM_JMP(compiler, varID, literalType, literal, compareMethod, addr);
+        return;
+    }
+
+    if (root->left != NULL && root->right != NULL && baranium_compiler_compile_register_compare_jump(compiler, root, compareMethod, addr))
+        return;
+
+    if (root->left)
+        baranium_compiler_compile_ast_node(compiler, root->left, 0);
+    else
+        baranium_compiler_code_builder_push_int(compiler, 0);
+
+    if (root->right)
+        baranium_compiler_compile_ast_node(compiler, root->right, 0);
     else
-        baranium_compiler_code_builder_CMP(compiler, baranium_compiler_get_compare_method(root->contents.type));
+        baranium_compiler_code_builder_push_int(compiler, 0);
+
+    baranium_compiler_code_builder_JCMP(compiler, compareMethod, addr);
+}
+
+// the frame slot of a local that is used as an operand, NULL if the node isn't a local
+static baranium_symbol_table_entry* baranium_compiler_get_register_local(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node)
+{
+    if (node == NULL || node->sub_nodes.count > 0 || node->contents.type != BARANIUM_SOURCE_TOKEN_TYPE_TEXT)
+        return NULL;
+
+    index_t id = baranium_symbol_table_lookup(&compiler->var_table, node->contents.contents);
+    return baranium_symbol_table_lookup_local(&compiler->var_table, id);
+}
+
+// the operands of an arithmetic node in the order they are compiled in, a number literal can only be the right operand
+// so it is swapped to the right side of commutative operations
+static void baranium_compiler_get_register_operands(baranium_abstract_syntax_tree_node* node, baranium_abstract_syntax_tree_node** lhs, baranium_abstract_syntax_tree_node** rhs)
+{
+    *lhs = node->left;
+    *rhs = node->right;
+    if (*lhs != NULL && (*lhs)->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_NUMBER &&
+        (node->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_PLUS || node->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_ASTERISK))
+    {
+        *lhs = node->right;
+        *rhs = node->left;
+    }
+}
+
+// a temporary that is not used by the expression that is compiled right now, they are reserved like locals so
+// they never share a frame slot with a local
+static index_t baranium_compiler_acquire_temporary(baranium_compiler* compiler)
+{
+    if (compiler->temporary_count == compiler->temporary_slot_count)
+        compiler->temporaries[compiler->temporary_slot_count++] = compiler->local_count++;
+
+    return compiler->temporaries[compiler->temporary_count++];
+}
+
+size_t baranium_compiler_count_register_operations(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node)
+{
+    if (node == NULL || node->sub_nodes.count > 0 || node->left == NULL || node->right == NULL)
+        return 0;
+
+    baranium_source_token_type_t operation = node->contents.type;
+    if (operation != BARANIUM_SOURCE_TOKEN_TYPE_PLUS     && operation != BARANIUM_SOURCE_TOKEN_TYPE_MINUS &&
+        operation != BARANIUM_SOURCE_TOKEN_TYPE_ASTERISK && operation != BARANIUM_SOURCE_TOKEN_TYPE_SLASH &&
+        operation != BARANIUM_SOURCE_TOKEN_TYPE_MODULO)
+        return 0;
+
+    // the type is only known if both operands have it
+    baranium_variable_type_t type = baranium_compiler_infer_type(compiler, node);
+    if (type != BARANIUM_VARIABLE_TYPE_INT32 && type != BARANIUM_VARIABLE_TYPE_INT64 && type != BARANIUM_VARIABLE_TYPE_FLOAT)
+        return 0;
+    if (type == BARANIUM_VARIABLE_TYPE_FLOAT && operation == BARANIUM_SOURCE_TOKEN_TYPE_MODULO)
+        return 0;
+
+    baranium_abstract_syntax_tree_node* lhs = NULL;
+    baranium_abstract_syntax_tree_node* rhs = NULL;
+    baranium_compiler_get_register_operands(node, &lhs, &rhs);
+
+    size_t count = 1;
+    if (baranium_compiler_get_register_local(compiler, lhs) == NULL)
+    {
+        size_t operations = baranium_compiler_count_register_operations(compiler, lhs);
+        if (operations == 0)
+            return 0;
+        count += operations;
+    }
+
+    baranium_variable_type_t literalType = BARANIUM_VARIABLE_TYPE_INVALID;
+    baranium_value_t literal = {0};
+    if (baranium_compiler_get_register_local(compiler, rhs) == NULL && !baranium_compiler_get_number_literal(rhs, &literalType, &literal))
+    {
+        size_t operations = baranium_compiler_count_register_operations(compiler, rhs);
+        if (operations == 0)
+            return 0;
+        count += operations;
+    }
+
+    return count;
+}
+
+// the slot of a local operand, other operands are compiled into a temporary that stays in use
+static index_t baranium_compiler_compile_register_operand(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node)
+{
+    baranium_symbol_table_entry* local = baranium_compiler_get_register_local(compiler, node);
+    if (local != NULL)
+        return local->local;
+
+    index_t temporary = baranium_compiler_acquire_temporary(compiler);
+    baranium_compiler_compile_register_expression(compiler, node, temporary);
+    return temporary;
+}
+
+void baranium_compiler_compile_register_expression(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node, index_t destination)
+{
+    size_t temporaries = compiler->temporary_count;
+    baranium_variable_type_t type = baranium_compiler_infer_type(compiler, node);
+    baranium_abstract_syntax_tree_node* lhs = NULL;
+    baranium_abstract_syntax_tree_node* rhs = NULL;
+    baranium_compiler_get_register_operands(node, &lhs, &rhs);
+
+    // the destination is only written by the last instruction, so it may be one of the operands
+    index_t lhsSlot = baranium_compiler_compile_register_operand(compiler, lhs);
+
+    baranium_variable_type_t literalType = BARANIUM_VARIABLE_TYPE_INVALID;
+    baranium_value_t literal = {0};
+    if (baranium_compiler_get_register_local(compiler, rhs) == NULL && baranium_compiler_get_number_literal(rhs, &literalType, &literal))
+        baranium_compiler_code_builder_ARITHMETIC_RI(compiler, node->contents.type, type, destination, lhsSlot, literal);
+    else
+        baranium_compiler_code_builder_ARITHMETIC_RR(compiler, node->contents.type, type, destination, lhsSlot, baranium_compiler_compile_register_operand(compiler, rhs));
+
+    compiler->temporary_count = temporaries;
+}
+
+uint8_t baranium_compiler_compile_register_push(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node)
+{
+    // every operation needs at most one temporary
+    size_t operations = baranium_compiler_count_register_operations(compiler, node);
+    if (operations == 0 || compiler->temporary_count + operations > BARANIUM_COMPILER_MAX_TEMPORARIES)
+        return 0;
+
+    size_t temporaries = compiler->temporary_count;
+    index_t temporary = baranium_compiler_acquire_temporary(compiler);
+    baranium_compiler_compile_register_expression(compiler, node, temporary);
+    compiler->temporary_count = temporaries;
+
+    baranium_compiler_code_builder_LOADLOCAL(compiler, temporary);
+    return 1;
+}
+
+uint8_t baranium_compiler_compile_register_assignment(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* root, baranium_symbol_table_entry* local)
+{
+    baranium_source_token_type_t operation = root->contents.type;
+    baranium_variable_type_t type = baranium_compiler_infer_type(compiler, root->left);
+    if (type != baranium_compiler_infer_type(compiler, root->right))
+        return 0;
+
+    // `local = a <operation> b` is computed right into the slot of the local
+    if (operation == BARANIUM_SOURCE_TOKEN_TYPE_EQUALSIGN)
+    {
+        size_t operations = baranium_compiler_count_register_operations(compiler, root->right);
+        if (operations == 0 || compiler->temporary_count + operations > BARANIUM_COMPILER_MAX_TEMPORARIES)
+            return 0;
+
+        baranium_compiler_compile_register_expression(compiler, root->right, local->local);
+        return 1;
+    }
+
+    // `local <operation>= value` is `local = local <operation> value`
+    if (operation != BARANIUM_SOURCE_TOKEN_TYPE_PLUSEQUAL && operation != BARANIUM_SOURCE_TOKEN_TYPE_MINUSEQUAL &&
+        operation != BARANIUM_SOURCE_TOKEN_TYPE_MULEQUAL  && operation != BARANIUM_SOURCE_TOKEN_TYPE_DIVEQUAL   &&
+        operation != BARANIUM_SOURCE_TOKEN_TYPE_MODEQUAL)
+        return 0;
+    if (type != BARANIUM_VARIABLE_TYPE_INT32 && type != BARANIUM_VARIABLE_TYPE_INT64 && type != BARANIUM_VARIABLE_TYPE_FLOAT)
+        return 0;
+    if (type == BARANIUM_VARIABLE_TYPE_FLOAT && operation == BARANIUM_SOURCE_TOKEN_TYPE_MODEQUAL)
+        return 0;
+
+    baranium_variable_type_t literalType = BARANIUM_VARIABLE_TYPE_INVALID;
+    baranium_value_t literal = {0};
+    if (baranium_compiler_get_number_literal(root->right, &literalType, &literal))
+    {
+        baranium_compiler_code_builder_ARITHMETIC_RI(compiler, operation, type, local->local, local->local, literal);
+        return 1;
+    }
+
+    if (baranium_compiler_get_register_local(compiler, root->right) == NULL)
+    {
+        size_t operations = baranium_compiler_count_register_operations(compiler, root->right);
+        if (operations == 0 || compiler->temporary_count + operations > BARANIUM_COMPILER_MAX_TEMPORARIES)
+            return 0;
+    }
+
+    size_t temporaries = compiler->temporary_count;
+    index_t rhs = baranium_compiler_compile_register_operand(compiler, root->right);
+    baranium_compiler_code_builder_ARITHMETIC_RR(compiler, operation, type, local->local, local->local, rhs);
+    compiler->temporary_count = temporaries;
+    return 1;
+}
+
+uint8_t baranium_compiler_compile_register_compare_jump(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* root, uint8_t compareMethod, uint64_t addr)
+{
+    baranium_variable_type_t type = baranium_compiler_infer_type(compiler, root->left);
+    if (type != baranium_compiler_infer_type(compiler, root->right))
+        return 0;
+    if (type != BARANIUM_VARIABLE_TYPE_INT32 && type != BARANIUM_VARIABLE_TYPE_INT64 && type != BARANIUM_VARIABLE_TYPE_FLOAT)
+        return 0;
+
+    // both sides have to be locals or computable with register instructions
+    size_t operations = 0;
+    for (int i = 0; i < 2; i++)
+    {
+        baranium_abstract_syntax_tree_node* operand = i == 0 ? root->left : root->right;
+        if (baranium_compiler_get_register_local(compiler, operand) != NULL)
+            continue;
+
+        size_t count = baranium_compiler_count_register_operations(compiler, operand);
+        if (count == 0)
+            return 0;
+        operations += count;
+    }
+
+    if (compiler->temporary_count + operations > BARANIUM_COMPILER_MAX_TEMPORARIES)
+        return 0;
+
+    size_t temporaries = compiler->temporary_count;
+    index_t lhs = baranium_compiler_compile_register_operand(compiler, root->left);
+    index_t rhs = baranium_compiler_compile_register_operand(compiler, root->right);
+    baranium_compiler_code_builder_JCMP_RR(compiler, compareMethod, type, lhs, rhs, addr);
+    compiler->temporary_count = temporaries;
+    return 1;
 }
 
 void baranium_compiler_compile_keyword_expression(baranium_compiler* compiler, baranium_expression_token* expression)
@@ -1265,7 +1906,7 @@ void baranium_compiler_compile_keyword_expression(baranium_compiler* compiler, b
     {
         index_t id = baranium_compiler_get_id(compiler, expression->return_value, expression->line_number);
         ///TODO: check if variable is an signed/unsigned integer or an object, since any other type doesn't make sense
-        baranium_compiler_code_builder_PUSHVAR(compiler, id);
+        baranium_compiler_compile_load_variable(compiler, id);
     }
 
     if (keyword == baranium_keywords[BARANIUM_KEYWORD_INDEX_INSTANTIATE].name)
@@ -1315,6 +1956,51 @@ void baranium_compiler_compile_function_call(baranium_compiler* compiler, barani
     baranium_compiler_code_builder_CALL(compiler, id);
 }
 
+baranium_variable_type_t baranium_compiler_infer_type(baranium_compiler* compiler, baranium_abstract_syntax_tree_node* node)
+{
+    // function return values aren't tracked (yet), so calls are treated as unknown
+    if (node == NULL || node->sub_nodes.count > 0)
+        return BARANIUM_VARIABLE_TYPE_INVALID;
+
+    baranium_source_token token = node->contents;
+
+    baranium_variable_type_t literalType = BARANIUM_VARIABLE_TYPE_INVALID;
+    baranium_value_t literal = {0};
+    if (baranium_compiler_get_number_literal(node, &literalType, &literal))
+        return literalType;
+
+    if (token.type == BARANIUM_SOURCE_TOKEN_TYPE_TEXT)
+        return baranium_symbol_table_lookup_type(&compiler->var_table, token.contents);
+
+    if (token.type == BARANIUM_SOURCE_TOKEN_TYPE_DOUBLEQUOTE)
+        return BARANIUM_VARIABLE_TYPE_STRING;
+
+    if (token.type == BARANIUM_SOURCE_TOKEN_TYPE_KEYWORD &&
+        (token.special_index == BARANIUM_KEYWORD_INDEX_TRUE || token.special_index == BARANIUM_KEYWORD_INDEX_FALSE))
+        return BARANIUM_VARIABLE_TYPE_BOOL;
+
+    if (token.type == BARANIUM_SOURCE_TOKEN_TYPE_PLUS     || token.type == BARANIUM_SOURCE_TOKEN_TYPE_MINUS ||
+        token.type == BARANIUM_SOURCE_TOKEN_TYPE_ASTERISK || token.type == BARANIUM_SOURCE_TOKEN_TYPE_SLASH ||
+        token.type == BARANIUM_SOURCE_TOKEN_TYPE_MODULO)
+    {
+        // mixed types are converted at runtime, so only operations on equal types have a known result
+        baranium_variable_type_t type = baranium_compiler_infer_type(compiler, node->left);
+        if (node->left == NULL || node->right == NULL || type != baranium_compiler_infer_type(compiler, node->right))
+            return BARANIUM_VARIABLE_TYPE_INVALID;
+
+        return type;
+    }
+
+    return BARANIUM_VARIABLE_TYPE_INVALID;
+}
+
+uint8_t baranium_compiler_is_compare_operator(baranium_source_token_type_t type)
+{
+    return type == BARANIUM_SOURCE_TOKEN_TYPE_EQUALTO   || type == BARANIUM_SOURCE_TOKEN_TYPE_NOTEQUAL     ||
+           type == BARANIUM_SOURCE_TOKEN_TYPE_LESSEQUAL || type == BARANIUM_SOURCE_TOKEN_TYPE_GREATEREQUAL ||
+           type == BARANIUM_SOURCE_TOKEN_TYPE_LESSTHAN  || type == BARANIUM_SOURCE_TOKEN_TYPE_GREATERTHAN;
+}
+
 uint8_t baranium_compiler_get_compare_method(baranium_source_token_type_t type)
 {
     switch (type)
@@ -1336,26 +2022,99 @@ uint8_t baranium_compiler_get_compare_method(baranium_source_token_type_t type)
     return BARANIUM_CMP_EQUAL;
 }
 
+uint8_t baranium_compiler_invert_compare_method(uint8_t compareMethod)
+{
+    switch (compareMethod)
+    {
+        default:
+        case BARANIUM_CMP_EQUAL:         return BARANIUM_CMP_NOTEQUAL;
+        case BARANIUM_CMP_NOTEQUAL:      return BARANIUM_CMP_EQUAL;
+        case BARANIUM_CMP_LESS_THAN:     return BARANIUM_CMP_GREATER_EQUAL;
+        case BARANIUM_CMP_LESS_EQUAL:    return BARANIUM_CMP_GREATER_THAN;
+        case BARANIUM_CMP_GREATER_THAN:  return BARANIUM_CMP_LESS_EQUAL;
+        case BARANIUM_CMP_GREATER_EQUAL: return BARANIUM_CMP_LESS_THAN;
+    }
+}
+
+uint8_t baranium_compiler_get_number_literal(baranium_abstract_syntax_tree_node* node, baranium_variable_type_t* type, baranium_value_t* value)
+{
+    // negative numbers are parsed as a minus in front of the number
+    if (node != NULL && node->contents.type == BARANIUM_SOURCE_TOKEN_TYPE_MINUS && node->left == NULL && node->sub_nodes.count == 0)
+    {
+        if (!baranium_compiler_get_number_literal(node->right, type, value))
+            return 0;
+
+        if (*type == BARANIUM_VARIABLE_TYPE_FLOAT)
+            value->numfloat = -value->numfloat;
+        else
+        {
+            value->snum64 = -value->snum64;
+            *type = (value->snum64 < INT32_MIN || value->snum64 > INT32_MAX) ? BARANIUM_VARIABLE_TYPE_INT64 : BARANIUM_VARIABLE_TYPE_INT32;
+        }
+        return 1;
+    }
+
+    if (node == NULL || node->contents.type != BARANIUM_SOURCE_TOKEN_TYPE_NUMBER || node->sub_nodes.count > 0)
+        return 0;
+
+    // same literal types as `baranium_compiler_compile_ast_node` would push
+    *value = (baranium_value_t){0};
+    if (stridx(node->contents.contents, '.') != -1)
+    {
+        *type = BARANIUM_VARIABLE_TYPE_FLOAT;
+        value->numfloat = strgetfloatval(node->contents.contents);
+    }
+    else
+    {
+        // integers that don't fit into an int32 are int64 literals, both are stored sign extended so that they
+        // keep their value when they are applied to a variable of any other integer type
+        value->snum64 = (int64_t)strgetnumval(node->contents.contents);
+        *type = (value->snum64 < INT32_MIN || value->snum64 > INT32_MAX) ? BARANIUM_VARIABLE_TYPE_INT64 : BARANIUM_VARIABLE_TYPE_INT32;
+    }
+
+    return 1;
+}
+
 void baranium_compiler_compile_variables(baranium_compiler* compiler, baranium_token_list* variables)
 {
+    // the parameters take the first slots of the frame in order of declaration, the arguments are popped in reverse
+    index_t firstSlot = compiler->local_count;
+    for (size_t var = 0; var < variables->count; var++)
+        baranium_symbol_table_add_local(&compiler->var_table, (baranium_variable_token*)variables->data[var], compiler->local_count++);
+
     for (size_t var = variables->count; var > 0; var--)
     {
         baranium_variable_token* entry = (baranium_variable_token*)variables->data[var-1];
-        baranium_compiler_compile_variable(compiler, entry);
-        baranium_compiler_code_builder_POPVAR(compiler, entry->base.id);
+        baranium_compiler_code_builder_STORELOCAL(compiler, firstSlot + var - 1, entry->type);
     }
 }
 
 void baranium_compiler_clear_variables(baranium_compiler* compiler, baranium_token_list* variables)
 {
-    if (baranium_compiler_code_builder_returned_from_execution(compiler))
-        return;
-
     for (size_t i = 0; i < variables->count; i++)
-    {
-        baranium_compiler_code_builder_FEM(compiler, variables->data[i]->id);
         baranium_symbol_table_remove(&compiler->var_table, (baranium_variable_token*)variables->data[i]);
-    }
+}
+
+void baranium_compiler_compile_function(baranium_compiler* compiler, baranium_function_token* function)
+{
+    size_t symbolCount = compiler->var_table.count;
+
+    baranium_compiler_code_builder_clear(compiler);
+    compiler->local_count = 0;
+
+    // the amount of locals is only known after compiling the body, so it gets filled in afterwards
+    baranium_compiler_code_builder_ENTER(compiler, 0);
+    baranium_compiler_compile_variables(compiler, &function->parameters);
+    baranium_compiler_compile(compiler, &function->tokens);
+    baranium_compiler_clear_variables(compiler, &function->parameters);
+
+    baranium_compiler_code_builder_patch64(compiler, 1, compiler->local_count);
+
+    // locals of this function are not visible to any other function
+    compiler->var_table.count = symbolCount;
+    compiler->local_count = 0;
+    compiler->temporary_slot_count = 0;
+    compiler->temporary_count = 0;
 }
 
 void baranium_compiler_compile(baranium_compiler* compiler, baranium_token_list* tokens)
@@ -1447,59 +2206,37 @@ uint8_t baranium_compiler_code_builder_returned_from_execution(baranium_compiler
 
 void baranium_compiler_code_builder_push_string(baranium_compiler* compiler, const char* str)
 {
-    uint64_t data = 0;
-
-    size_t strLength = strlen(str);
-    size_t leftOverSize = strLength;
-    void* value = (void*)str;
-    void* valPtr = (void*)str;
-    size_t index = 0;
-    for (index = 0; index * 8 < strLength; index++)
-    {
-        if (leftOverSize <= 8)
-            break;
-
-        valPtr = (void*)((uint64_t)value + index*8);
-        memcpy(&data, valPtr, 8);
-        leftOverSize -= 8;
-        baranium_compiler_code_builder_PUSH(compiler, data);
-    }
-    valPtr = (void*)((uint64_t)value + index*8);
-    data = 0;
-    memcpy(&data, valPtr, leftOverSize);
-    baranium_compiler_code_builder_PUSH(compiler, data);
-    baranium_compiler_code_builder_PUSH(compiler, strLength);
-    baranium_compiler_code_builder_PUSH(compiler, (uint64_t)BARANIUM_VARIABLE_TYPE_STRING);
+    baranium_compiler_code_builder_PUSHV(compiler, BARANIUM_VARIABLE_TYPE_STRING, strlen(str), str);
 }
 
 void baranium_compiler_code_builder_push_bool(baranium_compiler* compiler, uint8_t b)
 {
-    baranium_compiler_code_builder_PUSH(compiler, b);
-    baranium_compiler_code_builder_PUSH(compiler, sizeof(uint8_t));
-    baranium_compiler_code_builder_PUSH(compiler, (uint64_t)BARANIUM_VARIABLE_TYPE_BOOL);
+    baranium_compiler_code_builder_PUSHV(compiler, BARANIUM_VARIABLE_TYPE_BOOL, sizeof(uint8_t), &b);
 }
 
 void baranium_compiler_code_builder_push_uint(baranium_compiler* compiler, uint32_t val)
 {
-    baranium_compiler_code_builder_PUSH(compiler, val);
-    baranium_compiler_code_builder_PUSH(compiler, sizeof(uint32_t));
-    baranium_compiler_code_builder_PUSH(compiler, (uint64_t)BARANIUM_VARIABLE_TYPE_UINT32);
+    baranium_compiler_code_builder_PUSHV(compiler, BARANIUM_VARIABLE_TYPE_UINT32, sizeof(uint32_t), &val);
 }
 
 void baranium_compiler_code_builder_push_int(baranium_compiler* compiler, int32_t val)
 {
-    baranium_compiler_code_builder_PUSH(compiler, val);
-    baranium_compiler_code_builder_PUSH(compiler, sizeof(int32_t));
-    baranium_compiler_code_builder_PUSH(compiler, (uint64_t)BARANIUM_VARIABLE_TYPE_INT32);
+    baranium_compiler_code_builder_PUSHV(compiler, BARANIUM_VARIABLE_TYPE_INT32, sizeof(int32_t), &val);
+}
+
+void baranium_compiler_code_builder_push_int64(baranium_compiler* compiler, int64_t val)
+{
+    baranium_compiler_code_builder_PUSHV(compiler, BARANIUM_VARIABLE_TYPE_INT64, sizeof(int64_t), &val);
 }
 
 void baranium_compiler_code_builder_push_float(baranium_compiler* compiler, float val)
 {
-    uint64_t data = 0;
-    memcpy(&data, &val, sizeof(float));
-    baranium_compiler_code_builder_PUSH(compiler, data);
-    baranium_compiler_code_builder_PUSH(compiler, sizeof(float));
-    baranium_compiler_code_builder_PUSH(compiler, (uint64_t)BARANIUM_VARIABLE_TYPE_FLOAT);
+    baranium_compiler_code_builder_PUSHV(compiler, BARANIUM_VARIABLE_TYPE_FLOAT, sizeof(float), &val);
+}
+
+void baranium_compiler_code_builder_push_object(baranium_compiler* compiler, index_t id)
+{
+    baranium_compiler_code_builder_PUSHV(compiler, BARANIUM_VARIABLE_TYPE_OBJECT, sizeof(index_t), &id);
 }
 
 void baranium_compiler_code_builder_push64(baranium_compiler* compiler, uint64_t data)
@@ -1540,6 +2277,25 @@ void baranium_compiler_code_builder_push(baranium_compiler* compiler, uint8_t da
     compiler->code_length++;
 }
 
+void baranium_compiler_code_builder_patch64(baranium_compiler* compiler, size_t position, uint64_t data)
+{
+    for (int i = 0; i < 8; i++)
+        compiler->code[position + i] = (uint8_t)(data >> (56 - i*8));
+}
+
+void baranium_compiler_code_builder_patch_chain(baranium_compiler* compiler, size_t chain, uint64_t addr)
+{
+    while (chain != 0)
+    {
+        size_t previous = 0;
+        for (int i = 0; i < 8; i++)
+            previous = (previous << 8) | compiler->code[chain + i];
+
+        baranium_compiler_code_builder_patch64(compiler, chain, addr);
+        chain = previous;
+    }
+}
+
 void baranium_compiler_code_builder_NOP(baranium_compiler* compiler)
 {
     baranium_compiler_code_builder_push(compiler, 0x00);
@@ -1593,12 +2349,88 @@ void baranium_compiler_code_builder_PUSH(baranium_compiler* compiler, uint64_t v
     baranium_compiler_code_builder_push64(compiler, val);
 }
 
+void baranium_compiler_code_builder_INCVAR(baranium_compiler* compiler, index_t id)
+{
+    baranium_compiler_code_builder_push(compiler, 0x0A);
+    baranium_compiler_code_builder_push64(compiler, id);
+}
+
+void baranium_compiler_code_builder_DECVAR(baranium_compiler* compiler, index_t id)
+{
+    baranium_compiler_code_builder_push(compiler, 0x0B);
+    baranium_compiler_code_builder_push64(compiler, id);
+}
+
+void baranium_compiler_code_builder_ADDVAR_IMM(baranium_compiler* compiler, index_t id, baranium_variable_type_t type, baranium_value_t value)
+{
+    baranium_compiler_code_builder_push(compiler, 0x0C);
+    baranium_compiler_code_builder_push64(compiler, id);
+    baranium_compiler_code_builder_push(compiler, type);
+    baranium_compiler_code_builder_push64(compiler, value.num64);
+}
+
+void baranium_compiler_code_builder_PUSHV(baranium_compiler* compiler, baranium_variable_type_t type, size_t size, const void* data)
+{
+    baranium_compiler_code_builder_push(compiler, 0x0D);
+    baranium_compiler_code_builder_push(compiler, type);
+    baranium_compiler_code_builder_push64(compiler, size);
+
+    const uint8_t* dataPtr = data;
+    for (size_t i = 0; i < size; i++)
+        baranium_compiler_code_builder_push(compiler, dataPtr[i]);
+}
+
+void baranium_compiler_code_builder_ENTER(baranium_compiler* compiler, uint64_t count)
+{
+    baranium_compiler_code_builder_push(compiler, 0x15);
+    baranium_compiler_code_builder_push64(compiler, count);
+}
+
+void baranium_compiler_code_builder_LOADLOCAL(baranium_compiler* compiler, index_t slot)
+{
+    baranium_compiler_code_builder_push(compiler, 0x16);
+    baranium_compiler_code_builder_push64(compiler, slot);
+}
+
+void baranium_compiler_code_builder_STORELOCAL(baranium_compiler* compiler, index_t slot, baranium_variable_type_t type)
+{
+    baranium_compiler_code_builder_push(compiler, 0x17);
+    baranium_compiler_code_builder_push64(compiler, slot);
+    baranium_compiler_code_builder_push(compiler, type);
+}
+
+void baranium_compiler_code_builder_INCLOCAL(baranium_compiler* compiler, index_t slot)
+{
+    baranium_compiler_code_builder_push(compiler, 0x18);
+    baranium_compiler_code_builder_push64(compiler, slot);
+}
+
+void baranium_compiler_code_builder_DECLOCAL(baranium_compiler* compiler, index_t slot)
+{
+    baranium_compiler_code_builder_push(compiler, 0x19);
+    baranium_compiler_code_builder_push64(compiler, slot);
+}
+
+void baranium_compiler_code_builder_ADDLOCAL_IMM(baranium_compiler* compiler, index_t slot, baranium_variable_type_t type, baranium_value_t value)
+{
+    baranium_compiler_code_builder_push(compiler, 0x1A);
+    baranium_compiler_code_builder_push64(compiler, slot);
+    baranium_compiler_code_builder_push(compiler, type);
+    baranium_compiler_code_builder_push64(compiler, value.num64);
+}
+
 void baranium_compiler_code_builder_CALL(baranium_compiler* compiler, index_t id)
 {
     baranium_compiler_code_builder_push(compiler, 0x0E);
     baranium_compiler_code_builder_push64(compiler, id);
 }
 
+void baranium_compiler_code_builder_TAILCALL(baranium_compiler* compiler, index_t id)
+{
+    baranium_compiler_code_builder_push(compiler, 0x1C);
+    baranium_compiler_code_builder_push64(compiler, id);
+}
+
 void baranium_compiler_code_builder_RET(baranium_compiler* compiler)
 {
     baranium_compiler_code_builder_push(compiler, 0x0F);
@@ -1628,6 +2460,50 @@ void baranium_compiler_code_builder_JMPCOFF(baranium_compiler* compiler, int16_t
     baranium_compiler_code_builder_push16(compiler, addr);
 }
 
+void baranium_compiler_code_builder_JMPNC(baranium_compiler* compiler, uint64_t addr)
+{
+    baranium_compiler_code_builder_push(compiler, 0x1D);
+    baranium_compiler_code_builder_push64(compiler, addr);
+}
+
+void baranium_compiler_code_builder_CMPVAR_IMM_JMP(baranium_compiler* compiler, index_t id, baranium_variable_type_t type, baranium_value_t value, uint8_t compareMethod, uint64_t addr)
+{
+    baranium_compiler_code_builder_push(compiler, 0x14);
+    baranium_compiler_code_builder_push64(compiler, id);
+    baranium_compiler_code_builder_push(compiler, type);
+    baranium_compiler_code_builder_push64(compiler, value.num64);
+    baranium_compiler_code_builder_push(compiler, compareMethod);
+    baranium_compiler_code_builder_push64(compiler, addr);
+}
+
+void baranium_compiler_code_builder_CMPLOCAL_IMM_JMP(baranium_compiler* compiler, index_t slot, baranium_variable_type_t type, baranium_value_t value, uint8_t compareMethod, uint64_t addr)
+{
+    baranium_compiler_code_builder_push(compiler, 0x1B);
+    baranium_compiler_code_builder_push64(compiler, slot);
+    baranium_compiler_code_builder_push(compiler, type);
+    baranium_compiler_code_builder_push64(compiler, value.num64);
+    baranium_compiler_code_builder_push(compiler, compareMethod);
+    baranium_compiler_code_builder_push64(compiler, addr);
+}
+
+void baranium_compiler_code_builder_JCMP(baranium_compiler* compiler, uint8_t compareMethod, uint64_t addr)
+{
+    uint8_t opcode = 0x32;
+    switch (compareMethod)
+    {
+        default:
+        case BARANIUM_CMP_EQUAL:         opcode = 0x32; break;
+        case BARANIUM_CMP_NOTEQUAL:      opcode = 0x33; break;
+        case BARANIUM_CMP_LESS_THAN:     opcode = 0x34; break;
+        case BARANIUM_CMP_LESS_EQUAL:    opcode = 0x35; break;
+        case BARANIUM_CMP_GREATER_THAN:  opcode = 0x36; break;
+        case BARANIUM_CMP_GREATER_EQUAL: opcode = 0x37; break;
+    }
+
+    baranium_compiler_code_builder_push(compiler, opcode);
+    baranium_compiler_code_builder_push64(compiler, addr);
+}
+
 void baranium_compiler_code_builder_MOD(baranium_compiler* compiler)     { baranium_compiler_code_builder_push(compiler, 0x20); }
 void baranium_compiler_code_builder_DIV(baranium_compiler* compiler)     { baranium_compiler_code_builder_push(compiler, 0x21); }
 void baranium_compiler_code_builder_MUL(baranium_compiler* compiler)     { baranium_compiler_code_builder_push(compiler, 0x22); }
@@ -1639,6 +2515,12 @@ void baranium_compiler_code_builder_XOR(baranium_compiler* compiler)     { baran
 void baranium_compiler_code_builder_SHFTL(baranium_compiler* compiler)   { baranium_compiler_code_builder_push(compiler, 0x28); }
 void baranium_compiler_code_builder_SHFTR(baranium_compiler* compiler)   { baranium_compiler_code_builder_push(compiler, 0x29); }
 
+void baranium_compiler_code_builder_CONCATN(baranium_compiler* compiler, uint64_t count)
+{
+    baranium_compiler_code_builder_push(compiler, 0x2A);
+    baranium_compiler_code_builder_push64(compiler, count);
+}
+
 void baranium_compiler_code_builder_CMP(baranium_compiler* compiler, uint8_t compareMethod)
 {
     baranium_compiler_code_builder_push(compiler, 0x30);
@@ -1651,6 +2533,85 @@ void baranium_compiler_code_builder_CMPC(baranium_compiler* compiler, uint8_t co
     baranium_compiler_code_builder_push(compiler, compareCombineMethod);
 }
 
+// offset of the typed instructions of a type, -1 if there are none
+static int baranium_compiler_code_builder_typed_offset(baranium_variable_type_t type)
+{
+    if (type == BARANIUM_VARIABLE_TYPE_INT32)
+        return 0x00;
+    if (type == BARANIUM_VARIABLE_TYPE_INT64)
+        return 0x08;
+    if (type == BARANIUM_VARIABLE_TYPE_FLOAT)
+        return 0x10;
+
+    return -1;
+}
+
+void baranium_compiler_code_builder_TMOD(baranium_compiler* compiler, baranium_variable_type_t type)
+{
+    int offset = baranium_compiler_code_builder_typed_offset(type);
+    if (offset == -1 || type == BARANIUM_VARIABLE_TYPE_FLOAT)
+        baranium_compiler_code_builder_MOD(compiler);
+    else
+        baranium_compiler_code_builder_push(compiler, 0x44 + offset);
+}
+
+void baranium_compiler_code_builder_TDIV(baranium_compiler* compiler, baranium_variable_type_t type)
+{
+    int offset = baranium_compiler_code_builder_typed_offset(type);
+    if (offset == -1)
+        baranium_compiler_code_builder_DIV(compiler);
+    else
+        baranium_compiler_code_builder_push(compiler, 0x43 + offset);
+}
+
+void baranium_compiler_code_builder_TMUL(baranium_compiler* compiler, baranium_variable_type_t type)
+{
+    int offset = baranium_compiler_code_builder_typed_offset(type);
+    if (offset == -1)
+        baranium_compiler_code_builder_MUL(compiler);
+    else
+        baranium_compiler_code_builder_push(compiler, 0x42 + offset);
+}
+
+void baranium_compiler_code_builder_TSUB(baranium_compiler* compiler, baranium_variable_type_t type)
+{
+    int offset = baranium_compiler_code_builder_typed_offset(type);
+    if (offset == -1)
+        baranium_compiler_code_builder_SUB(compiler);
+    else
+        baranium_compiler_code_builder_push(compiler, 0x41 + offset);
+}
+
+void baranium_compiler_code_builder_TADD(baranium_compiler* compiler, baranium_variable_type_t type)
+{
+    int offset = baranium_compiler_code_builder_typed_offset(type);
+    if (offset == -1)
+        baranium_compiler_code_builder_ADD(compiler);
+    else
+        baranium_compiler_code_builder_push(compiler, 0x40 + offset);
+}
+
+void baranium_compiler_code_builder_TCMP(baranium_compiler* compiler, uint8_t compareMethod, baranium_variable_type_t type)
+{
+    int offset = baranium_compiler_code_builder_typed_offset(type);
+    int method = -1;
+    switch (compareMethod)
+    {
+        case BARANIUM_CMP_EQUAL:         method = 0; break;
+        case BARANIUM_CMP_NOTEQUAL:      method = 1; break;
+        case BARANIUM_CMP_LESS_THAN:     method = 2; break;
+        case BARANIUM_CMP_LESS_EQUAL:    method = 3; break;
+        case BARANIUM_CMP_GREATER_THAN:  method = 4; break;
+        case BARANIUM_CMP_GREATER_EQUAL: method = 5; break;
+        default: break;
+    }
+
+    if (offset == -1 || method == -1)
+        baranium_compiler_code_builder_CMP(compiler, compareMethod);
+    else
+        baranium_compiler_code_builder_push(compiler, 0x60 + offset + method);
+}
+
 void baranium_compiler_code_builder_MEM(baranium_compiler* compiler, size_t size, uint8_t type, index_t id)
 {
     baranium_compiler_code_builder_push(compiler, 0x80);
@@ -1691,3 +2652,65 @@ void baranium_compiler_code_builder_KILL(baranium_compiler* compiler, int64_t co
     baranium_compiler_code_builder_push(compiler, 0xFF);
     baranium_compiler_code_builder_push64(compiler, code);
 }
+
+// the register instructions are ADD, SUB, MUL, DIV and MOD for int32, int64 and float (which has no MOD),
+// first the ones that take two slots and then the ones that take a slot and an immediate
+static uint8_t baranium_compiler_code_builder_register_opcode(baranium_source_token_type_t operation, baranium_variable_type_t type, uint8_t immediate)
+{
+    uint8_t opcode = immediate ? 0xBE : 0xB0;
+    if (type == BARANIUM_VARIABLE_TYPE_INT64)
+        opcode += 5;
+    if (type == BARANIUM_VARIABLE_TYPE_FLOAT)
+        opcode += 10;
+
+    switch (operation)
+    {
+        default:
+        case BARANIUM_SOURCE_TOKEN_TYPE_PLUS:
+        case BARANIUM_SOURCE_TOKEN_TYPE_PLUSEQUAL:
+            return opcode;
+        case BARANIUM_SOURCE_TOKEN_TYPE_MINUS:
+        case BARANIUM_SOURCE_TOKEN_TYPE_MINUSEQUAL:
+            return opcode + 1;
+        case BARANIUM_SOURCE_TOKEN_TYPE_ASTERISK:
+        case BARANIUM_SOURCE_TOKEN_TYPE_MULEQUAL:
+            return opcode + 2;
+        case BARANIUM_SOURCE_TOKEN_TYPE_SLASH:
+        case BARANIUM_SOURCE_TOKEN_TYPE_DIVEQUAL:
+            return opcode + 3;
+        case BARANIUM_SOURCE_TOKEN_TYPE_MODULO:
+        case BARANIUM_SOURCE_TOKEN_TYPE_MODEQUAL:
+            return opcode + 4;
+    }
+}
+
+void baranium_compiler_code_builder_ARITHMETIC_RR(baranium_compiler* compiler, baranium_source_token_type_t operation, baranium_variable_type_t type, index_t destination, index_t lhs, index_t rhs)
+{
+    baranium_compiler_code_builder_push(compiler, baranium_compiler_code_builder_register_opcode(operation, type, 0));
+    baranium_compiler_code_builder_push64(compiler, destination);
+    baranium_compiler_code_builder_push64(compiler, lhs);
+    baranium_compiler_code_builder_push64(compiler, rhs);
+}
+
+void baranium_compiler_code_builder_ARITHMETIC_RI(baranium_compiler* compiler, baranium_source_token_type_t operation, baranium_variable_type_t type, index_t destination, index_t lhs, baranium_value_t value)
+{
+    baranium_compiler_code_builder_push(compiler, baranium_compiler_code_builder_register_opcode(operation, type, 1));
+    baranium_compiler_code_builder_push64(compiler, destination);
+    baranium_compiler_code_builder_push64(compiler, lhs);
+    baranium_compiler_code_builder_push64(compiler, value.num64);
+}
+
+void baranium_compiler_code_builder_JCMP_RR(baranium_compiler* compiler, uint8_t compareMethod, baranium_variable_type_t type, index_t lhs, index_t rhs, uint64_t addr)
+{
+    uint8_t opcode = 0xCC;
+    if (type == BARANIUM_VARIABLE_TYPE_INT64)
+        opcode = 0xCD;
+    if (type == BARANIUM_VARIABLE_TYPE_FLOAT)
+        opcode = 0xCE;
+
+    baranium_compiler_code_builder_push(compiler, opcode);
+    baranium_compiler_code_builder_push64(compiler, lhs);
+    baranium_compiler_code_builder_push64(compiler, rhs);
+    baranium_compiler_code_builder_push(compiler, compareMethod);
+    baranium_compiler_code_builder_push64(compiler, addr);
+}
@@ -52,32 +52,84 @@ const char* baranium_symbol_table_lookup_name(baranium_symbol_table* table, inde
     return NULL;
 }
 
+baranium_variable_type_t baranium_symbol_table_lookup_type(baranium_symbol_table* table, const char* name)
+{
+    if (table == NULL || name == NULL || table->data == NULL || table->count == 0)
+        return BARANIUM_VARIABLE_TYPE_INVALID;
+
+    // newer entries shadow older ones with the same name
+    for (size_t i = table->count; i > 0; i--)
+        if (strcmp(table->data[i-1].name, name) == 0)
+            return table->data[i-1].type;
+
+    return BARANIUM_VARIABLE_TYPE_INVALID;
+}
+
+baranium_symbol_table_entry* baranium_symbol_table_lookup_local(baranium_symbol_table* table, index_t id)
+{
+    if (table == NULL || id == BARANIUM_INVALID_INDEX || table->data == NULL || table->count == 0)
+        return NULL;
+
+    for (size_t i = table->count; i > 0; i--)
+    {
+        if (table->data[i-1].id != id)
+            continue;
+
+        if (table->data[i-1].local == BARANIUM_INVALID_INDEX)
+            return NULL;
+
+        return &table->data[i-1];
+    }
+
+    return NULL;
+}
+
 void baranium_symbol_table_add(baranium_symbol_table* table, baranium_variable_token* var)
 {
     if (table == NULL || var == NULL)
         return;
 
-    baranium_symbol_table_add_from_name_and_id(table, var->base.name, var->base.id);
+    baranium_symbol_table_add_from_name_id_and_type(table, var->base.name, var->base.id, var->type);
 }
 
 void baranium_symbol_table_add_from_name_and_id(baranium_symbol_table* table, const char* name, index_t id)
 {
-    if (table == NULL || name == NULL || id == BARANIUM_INVALID_INDEX)
-        return;
-
-    if (baranium_symbol_table_lookup_name(table, id) != NULL)
-        return;
+    baranium_symbol_table_add_from_name_id_and_type(table, name, id, BARANIUM_VARIABLE_TYPE_INVALID);
+}
 
+// appends an entry to the table
+static void baranium_symbol_table_add_entry(baranium_symbol_table* table, baranium_symbol_table_entry entry)
+{
     if (table->count + 1 >= table->buffer_size)
     {
         table->buffer_size += BARANIUM_SYMBOL_TABLE_BUFFER_SIZE;
         table->data = realloc(table->data, sizeof(baranium_symbol_table_entry)*table->buffer_size);
     }
 
-    table->data[table->count] = (baranium_symbol_table_entry){.id = id, .name = name};
+    table->data[table->count] = entry;
     table->count++;
 }
 
+void baranium_symbol_table_add_from_name_id_and_type(baranium_symbol_table* table, const char* name, index_t id, baranium_variable_type_t type)
+{
+    if (table == NULL || name == NULL || id == BARANIUM_INVALID_INDEX)
+        return;
+
+    if (baranium_symbol_table_lookup_name(table, id) != NULL)
+        return;
+
+    baranium_symbol_table_add_entry(table, (baranium_symbol_table_entry){.id = id, .name = name, .type = type, .local = BARANIUM_INVALID_INDEX});
+}
+
+void baranium_symbol_table_add_local(baranium_symbol_table* table, baranium_variable_token* var, index_t slot)
+{
+    if (table == NULL || var == NULL || var->base.id == BARANIUM_INVALID_INDEX)
+        return;
+
+    // locals are always added so that they shadow older entries with the same name
+    baranium_symbol_table_add_entry(table, (baranium_symbol_table_entry){.id = var->base.id, .name = var->base.name, .type = var->type, .local = slot});
+}
+
 void baranium_symbol_table_remove(baranium_symbol_table* table, baranium_variable_token* var)
 {
     if (table == NULL || var == NULL || var->base.id == BARANIUM_INVALID_INDEX || table->data == NULL || table->count)
@@ -98,7 +150,7 @@ void baranium_symbol_table_remove(baranium_symbol_table* table, baranium_variabl
 
     for (size_t idx = index; idx < table->count-1; idx++)
     {
-        baranium_symbol_table_entry tmp = {.id = BARANIUM_INVALID_INDEX, .name = NULL};
+        baranium_symbol_table_entry tmp = {.id = BARANIUM_INVALID_INDEX, .name = NULL, .type = BARANIUM_VARIABLE_TYPE_INVALID, .local = BARANIUM_INVALID_INDEX};
         size_t tmpindex = idx+1;
         if (tmpindex < table->count)
             tmp = table->data[tmpindex];
@@ -106,3 +158,12 @@ void baranium_symbol_table_remove(baranium_symbol_table* table, baranium_variabl
     }
     table->count--;
 }
+
+void baranium_symbol_table_copy(baranium_symbol_table* table, baranium_symbol_table* other)
+{
+    if (table == NULL || other == NULL)
+        return;
+
+    for (size_t i = 0; i < other->count; i++)
+        baranium_symbol_table_add_entry(table, other->data[i]);
+}
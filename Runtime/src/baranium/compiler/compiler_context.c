@@ -1,3 +1,5 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_COMPILER
+
 #include <baranium/compiler/binaries/compiler.h>
 #include <baranium/compiler/compiler_context.h>
 #include <baranium/compiler/token_parser.h>
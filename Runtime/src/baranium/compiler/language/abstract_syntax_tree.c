@@ -1,3 +1,5 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_COMPILER
+
 #include <baranium/compiler/language/abstract_syntax_tree.h>
 #include <baranium/compiler/language/language.h>
 #include <baranium/compiler/compiler_context.h>
@@ -54,6 +54,12 @@ void baranium_expression_token_dispose(baranium_expression_token* expression)
 {
     baranium_abstract_syntax_tree_node_dispose(expression->ast);
     baranium_source_token_list_dispose(&expression->inner_tokens);
+
+    if (expression->return_expression != NULL)
+    {
+        baranium_expression_token_dispose(expression->return_expression);
+        free(expression->return_expression);
+    }
 }
 
 void baranium_expression_token_parse_return_statement(baranium_expression_token* expression, baranium_token_list* local_tokens, baranium_token_list* global_tokens)
@@ -91,7 +97,8 @@ void baranium_expression_token_parse_return_statement(baranium_expression_token*
     if (return_value_list.count > 1)
     {
         expression->return_expression = malloc(sizeof(baranium_expression_token));
-        assert(expression->return_expression == NULL);
+        assert(expression->return_expression != NULL);
+        baranium_expression_token_init(expression->return_expression);
         expression->return_expression->inner_tokens = return_value_list;
         baranium_expression_token_identify(expression->return_expression, local_tokens, global_tokens);
 
@@ -1,3 +1,5 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_COMPILER
+
 #include "baranium/logging.h"
 #include <baranium/compiler/language/expression_token.h>
 #include <baranium/compiler/language/function_token.h>
@@ -1,3 +1,5 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_COMPILER
+
 #include <baranium/compiler/language/language.h>
 #include <baranium/compiler/preprocessor.h>
 #include <baranium/compiler/source_token.h>
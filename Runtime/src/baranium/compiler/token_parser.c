@@ -901,12 +901,15 @@ parseLoopInitializers:
 
         if (outputSize+1 == output->count)
         {
+            // the loop takes over the contents of the token, only the token itself is freed
+            baranium_token* start = output->data[outputSize];
             if (isVar)
-                loop->start_variable = *(baranium_variable_token*)(&output->data[outputSize]);
+                loop->start_variable = *(baranium_variable_token*)start;
             else
-                loop->start_expression = *(baranium_expression_token*)(&output->data[outputSize]);
+                loop->start_expression = *(baranium_expression_token*)start;
 
-            baranium_token_list_remove(output, output->data[output->count-1]->id);
+            baranium_token_list_remove_at(output, outputSize);
+            free(start);
         }
     }
 
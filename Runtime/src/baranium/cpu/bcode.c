@@ -0,0 +1,358 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_CPU
+
+#include <baranium/backend/bfunccache.h>
+#include <baranium/cpu/bcpu_opcodes.h>
+#include <baranium/cpu/bjit.h>
+#include <baranium/backend/bstring.h>
+#include <baranium/backend/bvarmgr.h>
+#include <baranium/cpu/bverify.h>
+#include <baranium/cpu/bcode.h>
+#include <baranium/variable.h>
+#include <baranium/logging.h>
+#include <baranium/runtime.h>
+#include <stdlib.h>
+#include <memory.h>
+
+#define BCODE_NO_INSTRUCTION (uint32_t)-1
+
+// reads a big endian immediate, returns 0 if the immediate doesn't fit into the code
+static uint8_t bcode_read(const uint8_t* data, size_t size, size_t* offset, int bytes, uint64_t* value)
+{
+    if (*offset + bytes > size)
+        return 0;
+
+    *value = 0;
+    for (int i = 0; i < bytes; i++)
+        *value = (*value << 8) | data[(*offset)++];
+
+    return 1;
+}
+
+// resolves a byte address to an instruction index
+static uint32_t bcode_resolve(bcode* code, uint32_t* instruction_at, size_t size, uint64_t address)
+{
+    if (address > size || instruction_at[address] == BCODE_NO_INSTRUCTION)
+    {
+        code->malformed = 1;
+        return code->count - 1;
+    }
+
+    return instruction_at[address];
+}
+
+bcode* bcode_decode(const uint8_t* data, size_t size, uint8_t registers)
+{
+    if (data == NULL && size != 0)
+        return NULL;
+
+    bcode* code = malloc(sizeof(bcode));
+    if (code == NULL)
+        return NULL;
+
+    memset(code, 0, sizeof(bcode));
+
+    // worst case every byte is an instruction, plus the terminating RET
+    code->instructions = malloc(sizeof(bcpu_instruction) * (size + 1));
+    uint32_t* instruction_at = malloc(sizeof(uint32_t) * (size + 1));
+    if (code->instructions == NULL || instruction_at == NULL)
+    {
+        free(instruction_at);
+        bcode_dispose(code);
+        return NULL;
+    }
+
+    for (size_t i = 0; i <= size; i++)
+        instruction_at[i] = BCODE_NO_INSTRUCTION;
+
+    size_t offset = 0;
+    while (offset < size)
+    {
+        size_t start = offset;
+        bcpu_instruction instruction = {0};
+        uint64_t value = 0;
+        uint8_t valid = 1;
+        instruction.opcode = data[offset++];
+        if (instruction.opcode >= BCPU_OPCODE_QUICKENED_FIRST && instruction.opcode <= BCPU_OPCODE_QUICKENED_LAST)
+            instruction.opcode = BCPU_OPCODE_INVALID;
+        if (!registers && instruction.opcode >= BCPU_OPCODE_REGISTER_FIRST && instruction.opcode <= BCPU_OPCODE_REGISTER_LAST)
+            instruction.opcode = BCPU_OPCODE_INVALID;
+
+        switch (instruction.opcode)
+        {
+            case 0x07: // PUSHVAR
+            case 0x08: // POPVAR
+            case 0x09: // PUSH
+            case 0x0A: // INCVAR
+            case 0x0B: // DECVAR
+            case 0x0E: // CALL
+            case 0x10: // JMP
+            case 0x12: // JMPC
+            case 0x15: // ENTER
+            case 0x16: // LOADLOCAL
+            case 0x18: // INCLOCAL
+            case 0x19: // DECLOCAL
+            case 0x1C: // TAILCALL
+            case 0x1D: // JMPNC
+            case 0x2A: // CONCATN
+            case 0x32: // JEQ
+            case 0x33: // JNE
+            case 0x34: // JLT
+            case 0x35: // JLE
+            case 0x36: // JGT
+            case 0x37: // JGE
+            case 0x81: // FEM
+            case 0xFF: // KILL
+                valid = bcode_read(data, size, &offset, 8, &instruction.operand);
+                break;
+
+            case 0x0C: // ADDVAR_IMM
+            case 0x1A: // ADDLOCAL_IMM
+                valid = bcode_read(data, size, &offset, 8, &instruction.operand) &&
+                        bcode_read(data, size, &offset, 1, &value) &&
+                        bcode_read(data, size, &offset, 8, &instruction.operand2);
+                instruction.type = value;
+                break;
+
+            case 0x0D: // PUSHV
+                valid = bcode_read(data, size, &offset, 1, &value) &&
+                        bcode_read(data, size, &offset, 8, &instruction.operand);
+                instruction.type = value;
+                instruction.target = offset;
+                if (!valid || instruction.operand > size - offset)
+                    valid = 0;
+                else if (instruction.type != BARANIUM_VARIABLE_TYPE_STRING && instruction.operand > sizeof(uint64_t))
+                    valid = 0;
+                else
+                {
+                    // small values are kept in the record, strings become runtime strings owned by the code
+                    if (instruction.type != BARANIUM_VARIABLE_TYPE_STRING)
+                        memcpy(&instruction.operand2, data + offset, instruction.operand);
+                    else
+                        instruction.operand2 = (uint64_t)bstring_create((const char*)data + offset, instruction.operand);
+                    offset += instruction.operand;
+
+                    if (instruction.type == BARANIUM_VARIABLE_TYPE_STRING && instruction.operand2 == 0)
+                    {
+                        free(instruction_at);
+                        bcode_dispose(code);
+                        return NULL;
+                    }
+                }
+                break;
+
+            case 0x11: // JMPOFF
+                valid = bcode_read(data, size, &offset, 2, &value);
+                instruction.operand = offset + (int16_t)value;
+                break;
+
+            case 0x13: // JMPCOFF
+                valid = bcode_read(data, size, &offset, 2, &value);
+                instruction.operand = offset + (uint16_t)value;
+                break;
+
+            case 0x14: // CMPVAR_IMM_JMP
+            case 0x1B: // CMPLOCAL_IMM_JMP
+                valid = bcode_read(data, size, &offset, 8, &instruction.operand) &&
+                        bcode_read(data, size, &offset, 1, &value) &&
+                        bcode_read(data, size, &offset, 8, &instruction.operand2);
+                instruction.type = value;
+                valid = valid && bcode_read(data, size, &offset, 1, &value);
+                instruction.method = value;
+                valid = valid && bcode_read(data, size, &offset, 8, &value);
+                // both immediates are taken, the address is kept in the target until it gets resolved
+                instruction.target = value > UINT32_MAX ? UINT32_MAX : value;
+                break;
+
+            case 0xCC: // JCMP_I32_RR
+            case 0xCD: // JCMP_I64_RR
+            case 0xCE: // JCMP_F32_RR
+                valid = bcode_read(data, size, &offset, 8, &instruction.operand) &&
+                        bcode_read(data, size, &offset, 8, &instruction.operand2) &&
+                        bcode_read(data, size, &offset, 1, &value);
+                instruction.method = value;
+                valid = valid && bcode_read(data, size, &offset, 8, &value);
+                instruction.target = value > UINT32_MAX ? UINT32_MAX : value;
+                break;
+
+            case 0x17: // STORELOCAL
+                valid = bcode_read(data, size, &offset, 8, &instruction.operand) &&
+                        bcode_read(data, size, &offset, 1, &value);
+                instruction.type = value;
+                break;
+
+            case 0x30: // CMP
+            case 0x31: // CMPC
+                valid = bcode_read(data, size, &offset, 1, &value);
+                instruction.method = value;
+                break;
+
+            case 0x80: // MEM
+                valid = bcode_read(data, size, &offset, 8, &instruction.operand) &&
+                        bcode_read(data, size, &offset, 1, &value) &&
+                        bcode_read(data, size, &offset, 8, &instruction.operand2);
+                instruction.type = value;
+                break;
+
+            case 0x82: // SET
+                valid = bcode_read(data, size, &offset, 8, &instruction.operand) &&
+                        bcode_read(data, size, &offset, 8, &instruction.operand2);
+                instruction.target = offset;
+                if (valid && instruction.operand2 > size - offset)
+                    valid = 0;
+                else
+                    offset += instruction.operand2;
+                break;
+
+            default:
+                // ADD_I32_RR - DIV_F32_RI take the destination slot, the left slot and either the right slot or an immediate
+                if (instruction.opcode >= BCPU_OPCODE_REGISTER_FIRST && instruction.opcode <= 0xCB)
+                {
+                    valid = bcode_read(data, size, &offset, 8, &value) &&
+                            bcode_read(data, size, &offset, 8, &instruction.operand) &&
+                            bcode_read(data, size, &offset, 8, &instruction.operand2);
+                    instruction.target = value;
+                    valid = valid && value <= UINT32_MAX;
+                }
+                break;
+        }
+
+        if (!valid)
+        {
+            LOGWARNING("Truncated instruction 0x%2.2x at 0x%zx, ignoring the rest of the function", instruction.opcode, start);
+            code->malformed = 1;
+            break;
+        }
+
+        instruction_at[start] = code->count;
+        code->instructions[code->count++] = instruction;
+    }
+
+    instruction_at[size] = code->count;
+    code->instructions[code->count++] = (bcpu_instruction){.opcode = BCPU_OPCODE_RET};
+
+    for (size_t i = 0; i < code->count; i++)
+    {
+        bcpu_instruction* instruction = &code->instructions[i];
+        if ((instruction->opcode >= 0x10 && instruction->opcode <= 0x13) || instruction->opcode == 0x1D ||
+            (instruction->opcode >= 0x32 && instruction->opcode <= 0x37))
+            instruction->target = bcode_resolve(code, instruction_at, size, instruction->operand);
+        else if (instruction->opcode == 0x14 || instruction->opcode == 0x1B || (instruction->opcode >= 0xCC && instruction->opcode <= 0xCE))
+            instruction->target = bcode_resolve(code, instruction_at, size, instruction->target);
+    }
+
+    free(instruction_at);
+
+    bcpu_instruction* instructions = realloc(code->instructions, sizeof(bcpu_instruction) * code->count);
+    if (instructions != NULL)
+        code->instructions = instructions;
+
+    bverify_code(code);
+    return code;
+}
+
+// whether an instruction refers to a global by id
+static uint8_t bcode_refers_to_global(uint8_t opcode)
+{
+    switch (opcode)
+    {
+        case 0x07: // PUSHVAR
+        case 0x08: // POPVAR
+        case 0x0A: // INCVAR
+        case 0x0B: // DECVAR
+        case 0x0C: // ADDVAR_IMM
+        case 0x14: // CMPVAR_IMM_JMP
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+// whether an instruction refers to a callee by id
+static uint8_t bcode_refers_to_callee(uint8_t opcode)
+{
+    return opcode == 0x0E || opcode == 0x1C; // CALL, TAILCALL
+}
+
+uint8_t bcode_link(bcode* code)
+{
+    baranium_runtime* runtime = baranium_get_runtime();
+    if (code == NULL || runtime == NULL)
+        return 0;
+
+    for (size_t i = 0; i < code->count; i++)
+    {
+        bcpu_instruction* instruction = &code->instructions[i];
+        size_t slot = 0;
+        if (bcode_refers_to_global(instruction->opcode))
+        {
+            slot = bvarmgr_link(runtime->varmgr, instruction->operand);
+            if (slot == BVARMGR_NO_SLOT)
+                return 0;
+        }
+        else if (bcode_refers_to_callee(instruction->opcode))
+        {
+            slot = baranium_function_cache_link(runtime->function_cache, instruction->operand);
+            if (slot == BARANIUM_FUNCTION_CACHE_NO_SLOT)
+                return 0;
+        }
+        else
+            continue;
+
+        instruction->operand = slot;
+    }
+
+    return 1;
+}
+
+size_t bcode_report_unresolved(bcode* code, index_t functionID)
+{
+    baranium_runtime* runtime = baranium_get_runtime();
+    if (code == NULL || runtime == NULL)
+        return 0;
+
+    size_t unresolved = 0;
+    for (size_t i = 0; i < code->count; i++)
+    {
+        bcpu_instruction* instruction = &code->instructions[i];
+        if (bcode_refers_to_global(instruction->opcode) && bvarmgr_get_slot(runtime->varmgr, instruction->operand) == NULL)
+        {
+            LOGERROR("Function with id %ld refers to unknown variable/field with id %ld", functionID, runtime->varmgr->slots[instruction->operand].id);
+            unresolved++;
+        }
+        else if (bcode_refers_to_callee(instruction->opcode) && baranium_function_cache_get_slot(runtime->function_cache, instruction->operand) == NULL)
+        {
+            LOGERROR("Function with id %ld calls unknown function with id %ld", functionID, runtime->function_cache->slots[instruction->operand].id);
+            unresolved++;
+        }
+    }
+
+    return unresolved;
+}
+
+uint64_t bcode_checksum(const uint8_t* data, size_t size)
+{
+    // 64 bit FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+void bcode_dispose(bcode* code)
+{
+    if (code == NULL)
+        return;
+
+    for (size_t i = 0; code->instructions != NULL && i < code->count; i++)
+        if (code->instructions[i].opcode == 0x0D && code->instructions[i].type == BARANIUM_VARIABLE_TYPE_STRING)
+            bstring_release((char*)code->instructions[i].operand2);
+
+    bjit_dispose(code->jit);
+    free(code->instructions);
+    free(code);
+}
@@ -1,8 +1,11 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_CPU
+
 #include <baranium/cpu/bcpu_opcodes.h>
 #include "instructions.c"
 #include <memory.h>
 
 bcpu_opcode opcodes[MAX_OPCODE_AMOUNT];
+bcpu_opcode verified_opcodes[MAX_OPCODE_AMOUNT];
 bool opcodes_initialized = false;
 
 void bcpu_opcodes_init(void)
@@ -28,10 +31,10 @@ void bcpu_opcodes_init(void)
         opcodes[0x07] = (bcpu_opcode){"PUSHVAR", PUSHVAR};
         opcodes[0x08] = (bcpu_opcode){"POPVAR", POPVAR};
         opcodes[0x09] = (bcpu_opcode){"PUSH", PUSH};
-        opcodes[0x0A] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x0B] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x0C] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x0D] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0x0A] = (bcpu_opcode){"INCVAR", INCVAR};
+        opcodes[0x0B] = (bcpu_opcode){"DECVAR", DECVAR};
+        opcodes[0x0C] = (bcpu_opcode){"ADDVAR_IMM", ADDVAR_IMM};
+        opcodes[0x0D] = (bcpu_opcode){"PUSHV", PUSHV};
         opcodes[0x0E] = (bcpu_opcode){"CALL", CALL};
         opcodes[0x0F] = (bcpu_opcode){"RET", RET};
     }
@@ -41,16 +44,16 @@ void bcpu_opcodes_init(void)
         opcodes[0x11] = (bcpu_opcode){"JMPOFF", JMPOFF};
         opcodes[0x12] = (bcpu_opcode){"JMPC", JMPC};
         opcodes[0x13] = (bcpu_opcode){"JMPCOFF", JMPCOFF};
-        opcodes[0x14] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x15] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x16] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x17] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x18] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x19] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x1A] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x1B] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x1C] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x1D] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0x14] = (bcpu_opcode){"CMPVAR_IMM_JMP", CMPVAR_IMM_JMP};
+        opcodes[0x15] = (bcpu_opcode){"ENTER", ENTER};
+        opcodes[0x16] = (bcpu_opcode){"LOADLOCAL", LOADLOCAL};
+        opcodes[0x17] = (bcpu_opcode){"STORELOCAL", STORELOCAL};
+        opcodes[0x18] = (bcpu_opcode){"INCLOCAL", INCLOCAL};
+        opcodes[0x19] = (bcpu_opcode){"DECLOCAL", DECLOCAL};
+        opcodes[0x1A] = (bcpu_opcode){"ADDLOCAL_IMM", ADDLOCAL_IMM};
+        opcodes[0x1B] = (bcpu_opcode){"CMPLOCAL_IMM_JMP", CMPLOCAL_IMM_JMP};
+        opcodes[0x1C] = (bcpu_opcode){"TAILCALL", TAILCALL};
+        opcodes[0x1D] = (bcpu_opcode){"JMPNC", JMPNC};
         opcodes[0x1E] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x1F] = (bcpu_opcode){"???", INVALID_OPCODE};
     }
@@ -66,7 +69,7 @@ void bcpu_opcodes_init(void)
         opcodes[0x27] = (bcpu_opcode){"XOR", XOR};
         opcodes[0x28] = (bcpu_opcode){"SHFTL", SHFTL};
         opcodes[0x29] = (bcpu_opcode){"SHFTR", SHFTR};
-        opcodes[0x2A] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0x2A] = (bcpu_opcode){"CONCATN", CONCATN};
         opcodes[0x2B] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x2C] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x2D] = (bcpu_opcode){"???", INVALID_OPCODE};
@@ -77,12 +80,12 @@ void bcpu_opcodes_init(void)
     { // 0x30 - 0x3F
         opcodes[0x30] = (bcpu_opcode){"CMP", CMP};
         opcodes[0x31] = (bcpu_opcode){"CMPC", CMPC};
-        opcodes[0x32] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x33] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x34] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x35] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x36] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x37] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0x32] = (bcpu_opcode){"JEQ", JEQ};
+        opcodes[0x33] = (bcpu_opcode){"JNE", JNE};
+        opcodes[0x34] = (bcpu_opcode){"JLT", JLT};
+        opcodes[0x35] = (bcpu_opcode){"JLE", JLE};
+        opcodes[0x36] = (bcpu_opcode){"JGT", JGT};
+        opcodes[0x37] = (bcpu_opcode){"JGE", JGE};
         opcodes[0x38] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x39] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x3A] = (bcpu_opcode){"???", INVALID_OPCODE};
@@ -94,29 +97,29 @@ void bcpu_opcodes_init(void)
     }
 
     { // 0x40 - 0x4F
-        opcodes[0x40] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x41] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x42] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x43] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x44] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0x40] = (bcpu_opcode){"ADD_I32", ADD_I32};
+        opcodes[0x41] = (bcpu_opcode){"SUB_I32", SUB_I32};
+        opcodes[0x42] = (bcpu_opcode){"MUL_I32", MUL_I32};
+        opcodes[0x43] = (bcpu_opcode){"DIV_I32", DIV_I32};
+        opcodes[0x44] = (bcpu_opcode){"MOD_I32", MOD_I32};
         opcodes[0x45] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x46] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x47] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x48] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x49] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x4A] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x4B] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x4C] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0x48] = (bcpu_opcode){"ADD_I64", ADD_I64};
+        opcodes[0x49] = (bcpu_opcode){"SUB_I64", SUB_I64};
+        opcodes[0x4A] = (bcpu_opcode){"MUL_I64", MUL_I64};
+        opcodes[0x4B] = (bcpu_opcode){"DIV_I64", DIV_I64};
+        opcodes[0x4C] = (bcpu_opcode){"MOD_I64", MOD_I64};
         opcodes[0x4D] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x4E] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x4F] = (bcpu_opcode){"???", INVALID_OPCODE};
     }
 
     { // 0x50 - 0x5F
-        opcodes[0x50] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x51] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x52] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x53] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0x50] = (bcpu_opcode){"ADD_F32", ADD_F32};
+        opcodes[0x51] = (bcpu_opcode){"SUB_F32", SUB_F32};
+        opcodes[0x52] = (bcpu_opcode){"MUL_F32", MUL_F32};
+        opcodes[0x53] = (bcpu_opcode){"DIV_F32", DIV_F32};
         opcodes[0x54] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x55] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x56] = (bcpu_opcode){"???", INVALID_OPCODE};
@@ -132,31 +135,31 @@ void bcpu_opcodes_init(void)
     }
 
     { // 0x60 - 0x6F
-        opcodes[0x60] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x61] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x62] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x63] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x64] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x65] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0x60] = (bcpu_opcode){"CMP_EQ_I32", CMP_EQ_I32};
+        opcodes[0x61] = (bcpu_opcode){"CMP_NE_I32", CMP_NE_I32};
+        opcodes[0x62] = (bcpu_opcode){"CMP_LT_I32", CMP_LT_I32};
+        opcodes[0x63] = (bcpu_opcode){"CMP_LE_I32", CMP_LE_I32};
+        opcodes[0x64] = (bcpu_opcode){"CMP_GT_I32", CMP_GT_I32};
+        opcodes[0x65] = (bcpu_opcode){"CMP_GE_I32", CMP_GE_I32};
         opcodes[0x66] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x67] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x68] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x69] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x6A] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x6B] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x6C] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x6D] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0x68] = (bcpu_opcode){"CMP_EQ_I64", CMP_EQ_I64};
+        opcodes[0x69] = (bcpu_opcode){"CMP_NE_I64", CMP_NE_I64};
+        opcodes[0x6A] = (bcpu_opcode){"CMP_LT_I64", CMP_LT_I64};
+        opcodes[0x6B] = (bcpu_opcode){"CMP_LE_I64", CMP_LE_I64};
+        opcodes[0x6C] = (bcpu_opcode){"CMP_GT_I64", CMP_GT_I64};
+        opcodes[0x6D] = (bcpu_opcode){"CMP_GE_I64", CMP_GE_I64};
         opcodes[0x6E] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x6F] = (bcpu_opcode){"???", INVALID_OPCODE};
     }
 
     { // 0x70 - 0x7F
-        opcodes[0x70] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x71] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x72] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x73] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x74] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x75] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0x70] = (bcpu_opcode){"CMP_EQ_F32", CMP_EQ_F32};
+        opcodes[0x71] = (bcpu_opcode){"CMP_NE_F32", CMP_NE_F32};
+        opcodes[0x72] = (bcpu_opcode){"CMP_LT_F32", CMP_LT_F32};
+        opcodes[0x73] = (bcpu_opcode){"CMP_LE_F32", CMP_LE_F32};
+        opcodes[0x74] = (bcpu_opcode){"CMP_GT_F32", CMP_GT_F32};
+        opcodes[0x75] = (bcpu_opcode){"CMP_GE_F32", CMP_GE_F32};
         opcodes[0x76] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x77] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0x78] = (bcpu_opcode){"???", INVALID_OPCODE};
@@ -189,27 +192,27 @@ void bcpu_opcodes_init(void)
     }
 
     { // 0x90 - 0x9F
-        opcodes[0x90] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x91] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x92] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x93] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x94] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x95] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x96] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x97] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x98] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x99] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x9A] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x9B] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x9C] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x9D] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x9E] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0x9F] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0x90] = (bcpu_opcode){"PUSHVAR_Q", PUSHVAR_Q};
+        opcodes[0x91] = (bcpu_opcode){"ADD_I32_Q", ADD_I32_Q};
+        opcodes[0x92] = (bcpu_opcode){"SUB_I32_Q", SUB_I32_Q};
+        opcodes[0x93] = (bcpu_opcode){"MUL_I32_Q", MUL_I32_Q};
+        opcodes[0x94] = (bcpu_opcode){"DIV_I32_Q", DIV_I32_Q};
+        opcodes[0x95] = (bcpu_opcode){"MOD_I32_Q", MOD_I32_Q};
+        opcodes[0x96] = (bcpu_opcode){"ADD_I64_Q", ADD_I64_Q};
+        opcodes[0x97] = (bcpu_opcode){"SUB_I64_Q", SUB_I64_Q};
+        opcodes[0x98] = (bcpu_opcode){"MUL_I64_Q", MUL_I64_Q};
+        opcodes[0x99] = (bcpu_opcode){"DIV_I64_Q", DIV_I64_Q};
+        opcodes[0x9A] = (bcpu_opcode){"MOD_I64_Q", MOD_I64_Q};
+        opcodes[0x9B] = (bcpu_opcode){"ADD_F32_Q", ADD_F32_Q};
+        opcodes[0x9C] = (bcpu_opcode){"SUB_F32_Q", SUB_F32_Q};
+        opcodes[0x9D] = (bcpu_opcode){"MUL_F32_Q", MUL_F32_Q};
+        opcodes[0x9E] = (bcpu_opcode){"DIV_F32_Q", DIV_F32_Q};
+        opcodes[0x9F] = (bcpu_opcode){"CMP_I32_Q", CMP_I32_Q};
     }
 
     { // 0xA0 - 0xAF
-        opcodes[0xA0] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xA1] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0xA0] = (bcpu_opcode){"CMP_I64_Q", CMP_I64_Q};
+        opcodes[0xA1] = (bcpu_opcode){"CMP_F32_Q", CMP_F32_Q};
         opcodes[0xA2] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0xA3] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0xA4] = (bcpu_opcode){"???", INVALID_OPCODE};
@@ -227,40 +230,40 @@ void bcpu_opcodes_init(void)
     }
 
     { // 0xB0 - 0xBF
-        opcodes[0xB0] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xB1] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xB2] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xB3] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xB4] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xB5] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xB6] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xB7] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xB8] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xB9] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xBA] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xBB] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xBC] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xBD] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xBE] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xBF] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0xB0] = (bcpu_opcode){"ADD_I32_RR", ADD_I32_RR};
+        opcodes[0xB1] = (bcpu_opcode){"SUB_I32_RR", SUB_I32_RR};
+        opcodes[0xB2] = (bcpu_opcode){"MUL_I32_RR", MUL_I32_RR};
+        opcodes[0xB3] = (bcpu_opcode){"DIV_I32_RR", DIV_I32_RR};
+        opcodes[0xB4] = (bcpu_opcode){"MOD_I32_RR", MOD_I32_RR};
+        opcodes[0xB5] = (bcpu_opcode){"ADD_I64_RR", ADD_I64_RR};
+        opcodes[0xB6] = (bcpu_opcode){"SUB_I64_RR", SUB_I64_RR};
+        opcodes[0xB7] = (bcpu_opcode){"MUL_I64_RR", MUL_I64_RR};
+        opcodes[0xB8] = (bcpu_opcode){"DIV_I64_RR", DIV_I64_RR};
+        opcodes[0xB9] = (bcpu_opcode){"MOD_I64_RR", MOD_I64_RR};
+        opcodes[0xBA] = (bcpu_opcode){"ADD_F32_RR", ADD_F32_RR};
+        opcodes[0xBB] = (bcpu_opcode){"SUB_F32_RR", SUB_F32_RR};
+        opcodes[0xBC] = (bcpu_opcode){"MUL_F32_RR", MUL_F32_RR};
+        opcodes[0xBD] = (bcpu_opcode){"DIV_F32_RR", DIV_F32_RR};
+        opcodes[0xBE] = (bcpu_opcode){"ADD_I32_RI", ADD_I32_RI};
+        opcodes[0xBF] = (bcpu_opcode){"SUB_I32_RI", SUB_I32_RI};
     }
 
     { // 0xC0 - 0xCF
-        opcodes[0xC0] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xC1] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xC2] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xC3] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xC4] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xC5] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xC6] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xC7] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xC8] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xC9] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xCA] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xCB] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xCC] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xCD] = (bcpu_opcode){"???", INVALID_OPCODE};
-        opcodes[0xCE] = (bcpu_opcode){"???", INVALID_OPCODE};
+        opcodes[0xC0] = (bcpu_opcode){"MUL_I32_RI", MUL_I32_RI};
+        opcodes[0xC1] = (bcpu_opcode){"DIV_I32_RI", DIV_I32_RI};
+        opcodes[0xC2] = (bcpu_opcode){"MOD_I32_RI", MOD_I32_RI};
+        opcodes[0xC3] = (bcpu_opcode){"ADD_I64_RI", ADD_I64_RI};
+        opcodes[0xC4] = (bcpu_opcode){"SUB_I64_RI", SUB_I64_RI};
+        opcodes[0xC5] = (bcpu_opcode){"MUL_I64_RI", MUL_I64_RI};
+        opcodes[0xC6] = (bcpu_opcode){"DIV_I64_RI", DIV_I64_RI};
+        opcodes[0xC7] = (bcpu_opcode){"MOD_I64_RI", MOD_I64_RI};
+        opcodes[0xC8] = (bcpu_opcode){"ADD_F32_RI", ADD_F32_RI};
+        opcodes[0xC9] = (bcpu_opcode){"SUB_F32_RI", SUB_F32_RI};
+        opcodes[0xCA] = (bcpu_opcode){"MUL_F32_RI", MUL_F32_RI};
+        opcodes[0xCB] = (bcpu_opcode){"DIV_F32_RI", DIV_F32_RI};
+        opcodes[0xCC] = (bcpu_opcode){"JCMP_I32_RR", JCMP_I32_RR};
+        opcodes[0xCD] = (bcpu_opcode){"JCMP_I64_RR", JCMP_I64_RR};
+        opcodes[0xCE] = (bcpu_opcode){"JCMP_F32_RR", JCMP_F32_RR};
         opcodes[0xCF] = (bcpu_opcode){"???", INVALID_OPCODE};
     }
 
@@ -320,4 +323,10 @@ void bcpu_opcodes_init(void)
         opcodes[0xFE] = (bcpu_opcode){"???", INVALID_OPCODE};
         opcodes[0xFF] = (bcpu_opcode){"KILL", KILL};
     }
+
+    // verified code runs the same instructions, only the ones whose checks the verifier made redundant get other handlers
+    memcpy(verified_opcodes, opcodes, sizeof(bcpu_opcode)*MAX_OPCODE_AMOUNT);
+#   define X(opcode, name, can_stop) verified_opcodes[opcode].handle = name;
+    BCPU_VERIFIED_INSTRUCTION_LIST(X)
+#   undef X
 }
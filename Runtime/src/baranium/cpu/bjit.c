@@ -0,0 +1,978 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_CPU
+
+#include <baranium/compiler/binaries/compiler.h>
+#include <baranium/cpu/bcpu_opcodes.h>
+#include <baranium/cpu/bjit.h>
+#include <baranium/variable.h>
+#include <baranium/logging.h>
+#include <baranium/bcpu.h>
+#include <stdlib.h>
+#include <memory.h>
+
+#if BJIT_AVAILABLE
+
+#include <sys/mman.h>
+
+// upper bound of the native code of a single instruction and of its slow path
+#define BJIT_MAX_INSTRUCTION_SIZE 0x200
+
+// upper bound of the prologue, the dispatch and the exits of a function
+#define BJIT_FRAME_SIZE 0x100
+
+// locals with a higher index are never accessed inline, their offset in the frame doesn't fit a disp32
+#define BJIT_MAX_INLINE_LOCAL 0x1000000
+
+// the stack count is the distance between the first free slot and the first slot shifted by this
+#define BJIT_SLOT_SHIFT 4
+_Static_assert(sizeof(bstack_slot) == (1 << BJIT_SLOT_SHIFT), "stack slots have to be 16 bytes for the native code");
+
+// the native code is entered with the cpu, the address table and the decoded code are built into it
+typedef uint8_t(*bjit_entry)(bcpu* cpu);
+
+#define BJIT_RAX 0x0
+#define BJIT_RCX 0x1
+#define BJIT_RDX 0x2
+#define BJIT_RBX 0x3
+#define BJIT_RSP 0x4
+#define BJIT_RBP 0x5
+#define BJIT_RSI 0x6
+#define BJIT_RDI 0x7
+#define BJIT_R12 0xC
+#define BJIT_R13 0xD
+#define BJIT_R14 0xE
+#define BJIT_R15 0xF
+
+// the native code keeps the hot state of the cpu in callee saved registers while it runs,
+// it's written back into the cpu before every handler call and loaded again after it, see `bjit_emit_spill`
+#define BJIT_CPU   BJIT_RBX    // the cpu
+#define BJIT_TICKS BJIT_RBP    // cpu->ticks
+#define BJIT_STACK BJIT_R12    // cpu->stack
+#define BJIT_TOP   BJIT_R13    // first free slot of the stack
+#define BJIT_FRAME BJIT_R14    // first local slot of the current function
+#define BJIT_LIMIT BJIT_R15    // end of the slots the stack has room for
+
+// condition codes of jcc and setcc
+#define BJIT_CC_B  0x2
+#define BJIT_CC_AE 0x3
+#define BJIT_CC_E  0x4
+#define BJIT_CC_NE 0x5
+#define BJIT_CC_BE 0x6
+#define BJIT_CC_A  0x7
+#define BJIT_CC_L  0xC
+#define BJIT_CC_GE 0xD
+#define BJIT_CC_LE 0xE
+#define BJIT_CC_G  0xF
+#define BJIT_CC_ALWAYS 0xFF
+
+// operations of the typed and register arithmetic instructions, in the order of their opcodes
+#define BJIT_ADD 0
+#define BJIT_SUB 1
+#define BJIT_MUL 2
+#define BJIT_DIV 3
+#define BJIT_MOD 4
+
+// operand types of the typed and register instructions
+#define BJIT_I32 0
+#define BJIT_I64 1
+#define BJIT_F32 2
+
+// compare methods of the typed compare instructions and JEQ - JGE, in the order of their opcodes
+static const uint8_t bjit_compare_methods[] = {
+    BARANIUM_CMP_EQUAL, BARANIUM_CMP_NOTEQUAL, BARANIUM_CMP_LESS_THAN,
+    BARANIUM_CMP_LESS_EQUAL, BARANIUM_CMP_GREATER_THAN, BARANIUM_CMP_GREATER_EQUAL,
+};
+
+// jump to an instruction or its slow path that still has to be placed
+typedef struct
+{
+    size_t position;    // offset of the rel32 field
+    uint32_t target;    // instruction index
+    uint8_t slow;       // set if the jump goes to the slow path of the instruction
+} bjit_fixup;
+
+typedef struct
+{
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+} bjit_emitter;
+
+typedef struct
+{
+    bjit_emitter out;
+    bcode* code;
+    const bcpu_opcode* handlers;    // `verified_opcodes` for verified code, the handlers skip the checks the verifier made redundant
+    size_t* offsets;        // native offset of each instruction
+    size_t* stubs;          // native offset of the slow path of each instruction, nonzero while emitting if it needs one
+    bjit_fixup* fixups;
+    size_t fixup_count;
+    size_t fixup_capacity;
+    size_t inlined;         // instructions that got a native template instead of a handler call
+    uint8_t failed;         // set if the compiler ran out of memory
+    size_t dispatch;        // continues at the instruction rax holds the index of
+    size_t leave;           // the cpu left the function or got killed
+    size_t hand_back;       // the interpreter continues at the instruction pointer of the cpu
+} bjit_compiler;
+
+// makes room for `count` more bytes of native code, returns 0 if out of memory
+static uint8_t bjit_reserve(bjit_emitter* out, size_t count)
+{
+    if (out->size + count <= out->capacity)
+        return 1;
+
+    size_t capacity = out->capacity * 2 > out->size + count ? out->capacity * 2 : out->size + count;
+    uint8_t* data = realloc(out->data, capacity);
+    if (data == NULL)
+        return 0;
+
+    out->data = data;
+    out->capacity = capacity;
+    return 1;
+}
+
+static void bjit_emit8(bjit_emitter* out, uint8_t value)
+{
+    out->data[out->size++] = value;
+}
+
+static void bjit_emit32(bjit_emitter* out, uint32_t value)
+{
+    memcpy(out->data + out->size, &value, sizeof(uint32_t));
+    out->size += sizeof(uint32_t);
+}
+
+static void bjit_emit64(bjit_emitter* out, uint64_t value)
+{
+    memcpy(out->data + out->size, &value, sizeof(uint64_t));
+    out->size += sizeof(uint64_t);
+}
+
+static void bjit_emit_bytes(bjit_emitter* out, const uint8_t* bytes, size_t count)
+{
+    memcpy(out->data + out->size, bytes, count);
+    out->size += count;
+}
+
+// emits the prefix, REX and opcode of an instruction, opcodes above 0xFF are two byte opcodes starting with 0x0F
+static void bjit_emit_opcode(bjit_emitter* out, uint8_t prefix, uint8_t wide, uint16_t opcode, uint8_t reg, uint8_t rm)
+{
+    if (prefix)
+        bjit_emit8(out, prefix);
+
+    uint8_t rex = 0x40 | (wide << 3) | ((reg >> 3) << 2) | (rm >> 3);
+    if (rex != 0x40)
+        bjit_emit8(out, rex);
+
+    if (opcode > 0xFF)
+        bjit_emit8(out, opcode >> 8);
+    bjit_emit8(out, opcode & 0xFF);
+}
+
+// emits an instruction with a [base+disp32] operand, `reg` is a register or the opcode extension of the ModRM byte
+static void bjit_emit_memory(bjit_emitter* out, uint8_t prefix, uint8_t wide, uint16_t opcode, uint8_t reg, uint8_t base, int32_t displacement)
+{
+    bjit_emit_opcode(out, prefix, wide, opcode, reg, base);
+    bjit_emit8(out, 0x80 | ((reg & 7) << 3) | (base & 7));
+    if ((base & 7) == BJIT_RSP)
+        bjit_emit8(out, 0x24);
+    bjit_emit32(out, (uint32_t)displacement);
+}
+
+// emits an instruction with two register operands
+static void bjit_emit_registers(bjit_emitter* out, uint8_t prefix, uint8_t wide, uint16_t opcode, uint8_t reg, uint8_t rm)
+{
+    bjit_emit_opcode(out, prefix, wide, opcode, reg, rm);
+    bjit_emit8(out, 0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+// mov reg, imm64
+static void bjit_emit_load_immediate(bjit_emitter* out, uint8_t reg, uint64_t value)
+{
+    bjit_emit8(out, 0x48 | (reg >> 3));
+    bjit_emit8(out, 0xB8 | (reg & 7));
+    bjit_emit64(out, value);
+}
+
+// emits a rel32 jump or conditional jump whose destination still has to be set, returns the offset of the rel32
+static size_t bjit_emit_branch(bjit_emitter* out, uint8_t condition)
+{
+    if (condition == BJIT_CC_ALWAYS)
+        bjit_emit8(out, 0xE9);
+    else
+        bjit_emit_bytes(out, (const uint8_t[]){0x0F, 0x80 | condition}, 2);
+
+    size_t position = out->size;
+    bjit_emit32(out, 0);
+    return position;
+}
+
+static void bjit_patch(uint8_t* data, size_t position, size_t destination)
+{
+    int32_t relative = (int32_t)(destination - (position + sizeof(uint32_t)));
+    memcpy(data + position, &relative, sizeof(int32_t));
+}
+
+// emits a rel32 jump or conditional jump to an offset that is already known
+static void bjit_emit_jump(bjit_emitter* out, uint8_t condition, size_t destination)
+{
+    bjit_patch(out->data, bjit_emit_branch(out, condition), destination);
+}
+
+// jumps to an instruction, or to its slow path if `slow` is set
+static void bjit_emit_jump_to(bjit_compiler* compiler, uint8_t condition, size_t target, uint8_t slow)
+{
+    if (target >= compiler->code->count)
+        target = compiler->code->count - 1;
+
+    if (compiler->fixup_count == compiler->fixup_capacity)
+    {
+        size_t capacity = compiler->fixup_capacity ? compiler->fixup_capacity * 2 : compiler->code->count;
+        bjit_fixup* fixups = realloc(compiler->fixups, sizeof(bjit_fixup) * capacity);
+        if (fixups == NULL)
+        {
+            compiler->failed = 1;
+            return;
+        }
+        compiler->fixups = fixups;
+        compiler->fixup_capacity = capacity;
+    }
+
+    size_t position = bjit_emit_branch(&compiler->out, condition);
+    compiler->fixups[compiler->fixup_count++] = (bjit_fixup){.position = position, .target = target, .slow = slow};
+    if (slow)
+        compiler->stubs[target] = 1;
+}
+
+// writes the state the native code keeps in registers back into the cpu, handlers and the interpreter only look at the cpu
+static void bjit_emit_spill(bjit_emitter* out)
+{
+    bjit_emit_memory(out, 0, 1, 0x89, BJIT_TICKS, BJIT_CPU, offsetof(bcpu, ticks));      // mov [rbx+ticks], rbp
+    bjit_emit_registers(out, 0, 1, 0x89, BJIT_TOP, BJIT_RAX);                             // mov rax, r13
+    bjit_emit_memory(out, 0, 1, 0x2B, BJIT_RAX, BJIT_STACK, offsetof(bstack, slots));     // sub rax, [r12+slots]
+    bjit_emit_registers(out, 0, 1, 0xC1, 7, BJIT_RAX);                                    // sar rax, BJIT_SLOT_SHIFT
+    bjit_emit8(out, BJIT_SLOT_SHIFT);
+    bjit_emit_memory(out, 0, 1, 0x89, BJIT_RAX, BJIT_STACK, offsetof(bstack, count));     // mov [r12+count], rax
+}
+
+// loads the state of the cpu into registers, handlers may have grown the stack, called a callback or entered a frame
+static void bjit_emit_reload(bjit_emitter* out)
+{
+    bjit_emit_memory(out, 0, 1, 0x8B, BJIT_TICKS, BJIT_CPU, offsetof(bcpu, ticks));      // mov rbp, [rbx+ticks]
+    bjit_emit_memory(out, 0, 1, 0x8B, BJIT_STACK, BJIT_CPU, offsetof(bcpu, stack));      // mov r12, [rbx+stack]
+    bjit_emit_memory(out, 0, 1, 0x8B, BJIT_TOP, BJIT_STACK, offsetof(bstack, count));    // mov r13, [r12+count]
+    bjit_emit_registers(out, 0, 1, 0xC1, 4, BJIT_TOP);                                    // shl r13, BJIT_SLOT_SHIFT
+    bjit_emit8(out, BJIT_SLOT_SHIFT);
+    bjit_emit_memory(out, 0, 1, 0x8B, BJIT_LIMIT, BJIT_STACK, offsetof(bstack, capacity)); // mov r15, [r12+capacity]
+    bjit_emit_registers(out, 0, 1, 0xC1, 4, BJIT_LIMIT);                                  // shl r15, BJIT_SLOT_SHIFT
+    bjit_emit8(out, BJIT_SLOT_SHIFT);
+    bjit_emit_memory(out, 0, 1, 0x8B, BJIT_RAX, BJIT_STACK, offsetof(bstack, slots));    // mov rax, [r12+slots]
+    bjit_emit_registers(out, 0, 1, 0x01, BJIT_RAX, BJIT_TOP);                             // add r13, rax
+    bjit_emit_registers(out, 0, 1, 0x01, BJIT_RAX, BJIT_LIMIT);                           // add r15, rax
+    bjit_emit_memory(out, 0, 1, 0x8B, BJIT_RAX, BJIT_CPU, offsetof(bcpu, locals));       // mov rax, [rbx+locals]
+    bjit_emit_memory(out, 0, 1, 0x8B, BJIT_FRAME, BJIT_RAX, offsetof(bstack, slots));    // mov r14, [rax+slots]
+    bjit_emit_memory(out, 0, 1, 0x8B, BJIT_RAX, BJIT_CPU, offsetof(bcpu, frame));        // mov rax, [rbx+frame]
+    bjit_emit_registers(out, 0, 1, 0xC1, 4, BJIT_RAX);                                    // shl rax, BJIT_SLOT_SHIFT
+    bjit_emit8(out, BJIT_SLOT_SHIFT);
+    bjit_emit_registers(out, 0, 1, 0x01, BJIT_RAX, BJIT_FRAME);                           // add r14, rax
+}
+
+// mov rax, [rbx+ip]; jmp dispatch
+static void bjit_emit_redispatch(bjit_compiler* compiler)
+{
+    bjit_emit_memory(&compiler->out, 0, 1, 0x8B, BJIT_RAX, BJIT_CPU, offsetof(bcpu, ip));
+    bjit_emit_jump(&compiler->out, BJIT_CC_ALWAYS, compiler->dispatch);
+}
+
+// calls the handler of an instruction exactly like the interpreter does it, the state has to be spilled before
+static void bjit_emit_call(bjit_compiler* compiler, size_t index, OPCODE_HANDLE handle)
+{
+    bjit_emitter* out = &compiler->out;
+    bjit_emit_memory(out, 0, 1, 0xC7, 0, BJIT_CPU, offsetof(bcpu, ip));                  // mov qword [rbx+ip], index+1
+    bjit_emit32(out, index + 1);
+    bjit_emit_registers(out, 0, 1, 0x89, BJIT_CPU, BJIT_RDI);                             // mov rdi, rbx
+    bjit_emit_load_immediate(out, BJIT_RSI, (uint64_t)(uintptr_t)&compiler->code->instructions[index]);
+    bjit_emit_load_immediate(out, BJIT_RAX, (uint64_t)(uintptr_t)handle);
+    bjit_emit_bytes(out, (const uint8_t[]){0xFF, 0xD0}, 2);                              // call rax
+
+    bjit_emit_memory(out, 0, 0, 0x80, 7, BJIT_CPU, offsetof(bcpu, kill_triggered));     // cmp byte [rbx+kill_triggered], 0
+    bjit_emit8(out, 0x00);
+    bjit_emit_jump(out, BJIT_CC_NE, compiler->leave);
+}
+
+// offset of a local slot from the first local slot of the function
+static int32_t bjit_local(uint64_t index)
+{
+    return (int32_t)(index * sizeof(bstack_slot));
+}
+
+// cmp byte [base+slot+type], type
+static void bjit_emit_type_compare(bjit_emitter* out, uint8_t base, int32_t slot, uint8_t type)
+{
+    bjit_emit_memory(out, 0, 0, 0x80, 7, base, slot + offsetof(bstack_slot, type));
+    bjit_emit8(out, type);
+}
+
+// goes to the slow path unless the local lies inside of the frame, verified code never leaves its frame
+static void bjit_emit_local_check(bjit_compiler* compiler, size_t index, uint64_t local)
+{
+    if (compiler->code->verified)
+        return;
+
+    bjit_emitter* out = &compiler->out;
+    bjit_emit_memory(out, 0, 1, 0x8B, BJIT_RAX, BJIT_CPU, offsetof(bcpu, locals));       // mov rax, [rbx+locals]
+    bjit_emit_memory(out, 0, 1, 0x8B, BJIT_RAX, BJIT_RAX, offsetof(bstack, count));      // mov rax, [rax+count]
+    bjit_emit_memory(out, 0, 1, 0x2B, BJIT_RAX, BJIT_CPU, offsetof(bcpu, frame));        // sub rax, [rbx+frame]
+    bjit_emit_registers(out, 0, 1, 0x81, 7, BJIT_RAX);                                    // cmp rax, local
+    bjit_emit32(out, local);
+    bjit_emit_jump_to(compiler, BJIT_CC_BE, index, 1);
+}
+
+// goes to the slow path unless the stack holds at least `count` values
+static void bjit_emit_operand_check(bjit_compiler* compiler, size_t index, uint8_t count)
+{
+    bjit_emitter* out = &compiler->out;
+    bjit_emit_registers(out, 0, 1, 0x89, BJIT_TOP, BJIT_RAX);                             // mov rax, r13
+    bjit_emit_memory(out, 0, 1, 0x2B, BJIT_RAX, BJIT_STACK, offsetof(bstack, slots));     // sub rax, [r12+slots]
+    bjit_emit_registers(out, 0, 1, 0x81, 7, BJIT_RAX);                                    // cmp rax, count slots
+    bjit_emit32(out, count * sizeof(bstack_slot));
+    bjit_emit_jump_to(compiler, BJIT_CC_B, index, 1);
+}
+
+// goes to the slow path unless the stack has room for another value
+static void bjit_emit_room_check(bjit_compiler* compiler, size_t index)
+{
+    bjit_emit_registers(&compiler->out, 0, 1, 0x39, BJIT_LIMIT, BJIT_TOP);               // cmp r13, r15
+    bjit_emit_jump_to(compiler, BJIT_CC_AE, index, 1);
+}
+
+// skips to the next instruction unless comparisons are enabled
+static void bjit_emit_compare_enabled(bjit_compiler* compiler, size_t index)
+{
+    bjit_emit_memory(&compiler->out, 0, 0, 0xF6, 0, BJIT_CPU, offsetof(bcpu, flags));    // test byte [rbx+flags], CMP
+    bjit_emit8(&compiler->out, 0x01);
+    bjit_emit_jump_to(compiler, BJIT_CC_E, index + 1, 0);
+}
+
+// condition a signed integer comparison succeeds on, BJIT_CC_ALWAYS for unknown methods
+static uint8_t bjit_integer_condition(uint8_t method)
+{
+    switch (method)
+    {
+        case BARANIUM_CMP_EQUAL:         return BJIT_CC_E;
+        case BARANIUM_CMP_NOTEQUAL:      return BJIT_CC_NE;
+        case BARANIUM_CMP_LESS_THAN:     return BJIT_CC_L;
+        case BARANIUM_CMP_LESS_EQUAL:    return BJIT_CC_LE;
+        case BARANIUM_CMP_GREATER_THAN:  return BJIT_CC_G;
+        case BARANIUM_CMP_GREATER_EQUAL: return BJIT_CC_GE;
+        default:                         return BJIT_CC_ALWAYS;
+    }
+}
+
+// compares two operands, returns the condition the comparison succeeded on
+// floats compare like C does it, every comparison with NaN fails except for NOTEQUAL
+static uint8_t bjit_emit_compare(bjit_emitter* out, uint8_t kind, uint8_t method, uint8_t lhsBase, int32_t lhs, uint8_t rhsBase, int32_t rhs)
+{
+    if (kind != BJIT_F32)
+    {
+        bjit_emit_memory(out, 0, kind == BJIT_I64, 0x8B, BJIT_RAX, lhsBase, lhs);        // mov rax, [lhs]
+        bjit_emit_memory(out, 0, kind == BJIT_I64, 0x3B, BJIT_RAX, rhsBase, rhs);        // cmp rax, [rhs]
+        return bjit_integer_condition(method);
+    }
+
+    bjit_emit_memory(out, 0xF3, 0, 0x0F10, 0, lhsBase, lhs);                             // movss xmm0, [lhs]
+    bjit_emit_memory(out, 0xF3, 0, 0x0F10, 1, rhsBase, rhs);                             // movss xmm1, [rhs]
+    switch (method)
+    {
+        case BARANIUM_CMP_EQUAL:
+        case BARANIUM_CMP_NOTEQUAL:
+        {
+            uint8_t equal = method == BARANIUM_CMP_EQUAL;
+            bjit_emit_registers(out, 0, 0, 0x0F2E, 0, 1);                                // ucomiss xmm0, xmm1
+            bjit_emit_registers(out, 0, 0, equal ? 0x0F94 : 0x0F95, 0, BJIT_RAX);       // sete/setne al
+            bjit_emit_registers(out, 0, 0, equal ? 0x0F9B : 0x0F9A, 0, BJIT_RCX);       // setnp/setp cl
+            bjit_emit_registers(out, 0, 0, equal ? 0x20 : 0x08, BJIT_RCX, BJIT_RAX);    // and/or al, cl
+            return BJIT_CC_NE;
+        }
+        case BARANIUM_CMP_LESS_THAN:
+        case BARANIUM_CMP_LESS_EQUAL:
+            bjit_emit_registers(out, 0, 0, 0x0F2E, 1, 0);                                // ucomiss xmm1, xmm0
+            return method == BARANIUM_CMP_LESS_THAN ? BJIT_CC_A : BJIT_CC_AE;
+        case BARANIUM_CMP_GREATER_THAN:
+        case BARANIUM_CMP_GREATER_EQUAL:
+            bjit_emit_registers(out, 0, 0, 0x0F2E, 0, 1);                                // ucomiss xmm0, xmm1
+            return method == BARANIUM_CMP_GREATER_THAN ? BJIT_CC_A : BJIT_CC_AE;
+        default:
+            return BJIT_CC_ALWAYS;
+    }
+}
+
+// computes `lhs operation rhs` into rax (zero extended for BJIT_I32) or xmm0 (BJIT_F32) with the semantics of the handlers,
+// additions, subtractions and multiplications wrap around and a zero divisor goes to the slow path which reports the error
+static void bjit_emit_arithmetic(bjit_compiler* compiler, size_t index, uint8_t kind, uint8_t operation, uint8_t lhsBase, int32_t lhs,
+                                 uint8_t rhsBase, int32_t rhs, uint8_t immediate, uint64_t value)
+{
+    bjit_emitter* out = &compiler->out;
+    if (kind == BJIT_F32)
+    {
+        static const uint16_t operations[] = {0x0F58, 0x0F5C, 0x0F59, 0x0F5E};           // addss, subss, mulss, divss
+        bjit_emit_memory(out, 0xF3, 0, 0x0F10, 0, lhsBase, lhs);                         // movss xmm0, [lhs]
+        if (immediate)
+        {
+            bjit_emit8(out, 0xB9);                                                        // mov ecx, imm32
+            bjit_emit32(out, (uint32_t)value);
+            bjit_emit_registers(out, 0x66, 0, 0x0F6E, 1, BJIT_RCX);                      // movd xmm1, ecx
+        }
+        else
+            bjit_emit_memory(out, 0xF3, 0, 0x0F10, 1, rhsBase, rhs);                     // movss xmm1, [rhs]
+        bjit_emit_registers(out, 0xF3, 0, operations[operation], 0, 1);                  // op xmm0, xmm1
+        return;
+    }
+
+    uint8_t wide = kind == BJIT_I64;
+    bjit_emit_memory(out, 0, wide, 0x8B, BJIT_RAX, lhsBase, lhs);                        // mov rax, [lhs]
+    if (immediate && wide)
+        bjit_emit_load_immediate(out, BJIT_RCX, value);                                  // mov rcx, imm64
+    else if (immediate)
+    {
+        bjit_emit8(out, 0xB9);                                                            // mov ecx, imm32
+        bjit_emit32(out, (uint32_t)value);
+    }
+    else
+        bjit_emit_memory(out, 0, wide, 0x8B, BJIT_RCX, rhsBase, rhs);                    // mov rcx, [rhs]
+
+    switch (operation)
+    {
+        case BJIT_ADD: bjit_emit_registers(out, 0, wide, 0x01, BJIT_RCX, BJIT_RAX); break;     // add rax, rcx
+        case BJIT_SUB: bjit_emit_registers(out, 0, wide, 0x29, BJIT_RCX, BJIT_RAX); break;     // sub rax, rcx
+        case BJIT_MUL: bjit_emit_registers(out, 0, wide, 0x0FAF, BJIT_RAX, BJIT_RCX); break;   // imul rax, rcx
+        default:
+            bjit_emit_registers(out, 0, wide, 0x85, BJIT_RCX, BJIT_RCX);                 // test rcx, rcx
+            bjit_emit_jump_to(compiler, BJIT_CC_E, index, 1);
+            if (wide)
+                bjit_emit8(out, 0x48);
+            bjit_emit8(out, 0x99);                                                        // cdq/cqo
+            bjit_emit_registers(out, 0, wide, 0xF7, 7, BJIT_RCX);                        // idiv rcx
+            if (operation == BJIT_MOD)
+                bjit_emit_registers(out, 0, wide, 0x89, BJIT_RDX, BJIT_RAX);             // mov rax, rdx
+            break;
+    }
+}
+
+// stores the result of `bjit_emit_arithmetic` as the inline data of a slot
+static void bjit_emit_store_result(bjit_emitter* out, uint8_t kind, uint8_t base, int32_t slot)
+{
+    if (kind == BJIT_F32)
+        bjit_emit_memory(out, 0x66, 0, 0x0FD6, 0, base, slot);                           // movq [slot], xmm0
+    else
+        bjit_emit_memory(out, 0, 1, 0x89, BJIT_RAX, base, slot);                         // mov [slot], rax
+}
+
+// add r13, slots / sub r13, slots
+static void bjit_emit_move_top(bjit_emitter* out, int8_t slots)
+{
+    bjit_emit_registers(out, 0, 1, 0x83, slots < 0 ? 5 : 0, BJIT_TOP);
+    bjit_emit8(out, (slots < 0 ? -slots : slots) * sizeof(bstack_slot));
+}
+
+// emits a native template for the common case of an instruction, anything else goes to its slow path which calls the handler,
+// returns 0 without emitting anything if the instruction has no template
+static uint8_t bjit_emit_inline(bjit_compiler* compiler, size_t index)
+{
+    const bcpu_instruction* instruction = &compiler->code->instructions[index];
+    bjit_emitter* out = &compiler->out;
+    uint8_t opcode = instruction->opcode;
+    uint8_t verified = compiler->code->verified;
+    int32_t local = bjit_local(instruction->operand);
+    const int32_t lhsSlot = -2 * (int32_t)sizeof(bstack_slot);
+    const int32_t rhsSlot = -1 * (int32_t)sizeof(bstack_slot);
+
+    uint8_t localsInline = instruction->operand < BJIT_MAX_INLINE_LOCAL;
+    switch (opcode)
+    {
+        case 0x01: // CCF
+        case 0x02: // SCF
+            bjit_emit_memory(out, 0, 0, 0x80, opcode == 0x01 ? 4 : 1, BJIT_CPU, offsetof(bcpu, flags)); // and/or byte [rbx+flags], CMP
+            bjit_emit8(out, opcode == 0x01 ? 0xFE : 0x01);
+            return 1;
+
+        case 0x03: // CCV
+            bjit_emit_memory(out, 0, 0, 0xC6, 0, BJIT_CPU, offsetof(bcpu, cv));            // mov byte [rbx+cv], 0
+            bjit_emit8(out, 0x00);
+            return 1;
+
+        case 0x0D: // PUSHV
+            if (instruction->type == BARANIUM_VARIABLE_TYPE_STRING)
+                return 0;
+            bjit_emit_room_check(compiler, index);
+            bjit_emit_load_immediate(out, BJIT_RAX, instruction->operand2);
+            bjit_emit_memory(out, 0, 1, 0x89, BJIT_RAX, BJIT_TOP, offsetof(bstack_slot, data));     // mov [r13], rax
+            bjit_emit_memory(out, 0, 0, 0xC7, 0, BJIT_TOP, offsetof(bstack_slot, size));            // mov dword [r13+size], size
+            bjit_emit32(out, (uint32_t)instruction->operand);
+            bjit_emit_memory(out, 0, 0, 0xC7, 0, BJIT_TOP, offsetof(bstack_slot, type));            // mov dword [r13+type], type
+            bjit_emit32(out, instruction->type);
+            bjit_emit_move_top(out, 1);
+            return 1;
+
+        case 0x12: // JMPC
+        case 0x13: // JMPCOFF
+        case 0x1D: // JMPNC
+            bjit_emit_compare_enabled(compiler, index);
+            bjit_emit_memory(out, 0, 0, 0x80, 7, BJIT_CPU, offsetof(bcpu, cv));            // cmp byte [rbx+cv], 0
+            bjit_emit8(out, 0x00);
+            bjit_emit_jump_to(compiler, opcode == 0x1D ? BJIT_CC_E : BJIT_CC_NE, instruction->target, 0);
+            return 1;
+
+        case 0x16: // LOADLOCAL
+            if (!localsInline)
+                return 0;
+            // strings need another reference and locals without a value are errors
+            bjit_emit_local_check(compiler, index, instruction->operand);
+            bjit_emit_memory(out, 0, 0, 0x0FB6, BJIT_RAX, BJIT_FRAME, local + offsetof(bstack_slot, type)); // movzx eax, byte [type]
+            bjit_emit_bytes(out, (const uint8_t[]){0x84, 0xC0}, 2);                         // test al, al
+            bjit_emit_jump_to(compiler, BJIT_CC_E, index, 1);
+            bjit_emit_bytes(out, (const uint8_t[]){0x3C, BARANIUM_VARIABLE_TYPE_STRING}, 2); // cmp al, STRING
+            bjit_emit_jump_to(compiler, BJIT_CC_E, index, 1);
+            bjit_emit_bytes(out, (const uint8_t[]){0x3C, BARANIUM_VARIABLE_TYPE_INVALID}, 2); // cmp al, INVALID
+            bjit_emit_jump_to(compiler, BJIT_CC_E, index, 1);
+            bjit_emit_room_check(compiler, index);
+            bjit_emit_memory(out, 0, 0, 0x0F10, 0, BJIT_FRAME, local);                      // movups xmm0, [local]
+            bjit_emit_memory(out, 0, 0, 0x0F11, 0, BJIT_TOP, 0);                            // movups [r13], xmm0
+            bjit_emit_move_top(out, 1);
+            return 1;
+
+        case 0x17: // STORELOCAL
+            // a value of the type of the local needs no conversion, anything else is converted or rejected by the handler
+            if (!localsInline || instruction->type < BARANIUM_VARIABLE_TYPE_FLOAT || instruction->type > BARANIUM_VARIABLE_TYPE_UINT64)
+                return 0;
+            bjit_emit_local_check(compiler, index, instruction->operand);
+            bjit_emit_memory(out, 0, 1, 0x3B, BJIT_TOP, BJIT_STACK, offsetof(bstack, slots)); // cmp r13, [r12+slots]
+            bjit_emit_jump_to(compiler, BJIT_CC_BE, index, 1);
+            bjit_emit_type_compare(out, BJIT_TOP, rhsSlot, instruction->type);
+            bjit_emit_jump_to(compiler, BJIT_CC_NE, index, 1);
+            bjit_emit_type_compare(out, BJIT_FRAME, local, BARANIUM_VARIABLE_TYPE_STRING);
+            bjit_emit_jump_to(compiler, BJIT_CC_E, index, 1);
+            bjit_emit_memory(out, 0, 0, 0x0F10, 0, BJIT_TOP, rhsSlot);                      // movups xmm0, [r13-slot]
+            bjit_emit_memory(out, 0, 0, 0x0F11, 0, BJIT_FRAME, local);                      // movups [local], xmm0
+            bjit_emit_move_top(out, -1);
+            return 1;
+
+        case 0x18: // INCLOCAL
+        case 0x19: // DECLOCAL
+        case 0x1A: // ADDLOCAL_IMM
+        {
+            if (!localsInline || (opcode == 0x1A && instruction->type != BARANIUM_VARIABLE_TYPE_INT32))
+                return 0;
+            int32_t summand = opcode == 0x18 ? 1 : opcode == 0x19 ? -1 : (int32_t)instruction->operand2;
+            bjit_emit_local_check(compiler, index, instruction->operand);
+            bjit_emit_type_compare(out, BJIT_FRAME, local, BARANIUM_VARIABLE_TYPE_INT32);
+            bjit_emit_jump_to(compiler, BJIT_CC_NE, index, 1);
+            bjit_emit_memory(out, 0, 0, 0x81, 0, BJIT_FRAME, local);                        // add dword [local], summand
+            bjit_emit32(out, (uint32_t)summand);
+            return 1;
+        }
+
+        case 0x1B: // CMPLOCAL_IMM_JMP
+        {
+            uint8_t condition = bjit_integer_condition(instruction->method);
+            if (!localsInline || instruction->type != BARANIUM_VARIABLE_TYPE_INT32 || condition == BJIT_CC_ALWAYS)
+                return 0;
+            bjit_emit_local_check(compiler, index, instruction->operand);
+            bjit_emit_type_compare(out, BJIT_FRAME, local, BARANIUM_VARIABLE_TYPE_INT32);
+            bjit_emit_jump_to(compiler, BJIT_CC_NE, index, 1);
+            bjit_emit_memory(out, 0, 0, 0x80, 1, BJIT_CPU, offsetof(bcpu, flags));         // or byte [rbx+flags], CMP
+            bjit_emit8(out, 0x01);
+            bjit_emit_memory(out, 0, 0, 0x81, 7, BJIT_FRAME, local);                        // cmp dword [local], imm32
+            bjit_emit32(out, (uint32_t)instruction->operand2);
+            bjit_emit_memory(out, 0, 0, 0x0F90 | condition, 0, BJIT_CPU, offsetof(bcpu, cv)); // setcc [rbx+cv]
+            bjit_emit_jump_to(compiler, condition, instruction->target, 0);
+            return 1;
+        }
+
+        case 0x32: case 0x33: case 0x34: case 0x35: case 0x36: case 0x37: // JEQ - JGE
+        {
+            uint8_t condition = bjit_integer_condition(bjit_compare_methods[opcode - 0x32]);
+            bjit_emit_operand_check(compiler, index, 2);
+            bjit_emit_type_compare(out, BJIT_TOP, lhsSlot, BARANIUM_VARIABLE_TYPE_INT32);
+            bjit_emit_jump_to(compiler, BJIT_CC_NE, index, 1);
+            bjit_emit_type_compare(out, BJIT_TOP, rhsSlot, BARANIUM_VARIABLE_TYPE_INT32);
+            bjit_emit_jump_to(compiler, BJIT_CC_NE, index, 1);
+            bjit_emit_memory(out, 0, 0, 0x8B, BJIT_RAX, BJIT_TOP, lhsSlot);                 // mov eax, [lhs]
+            bjit_emit_memory(out, 0, 0, 0x8B, BJIT_RCX, BJIT_TOP, rhsSlot);                 // mov ecx, [rhs]
+            bjit_emit_move_top(out, -2);
+            bjit_emit_registers(out, 0, 0, 0x39, BJIT_RCX, BJIT_RAX);                       // cmp eax, ecx
+            bjit_emit_jump_to(compiler, condition, instruction->target, 0);
+            return 1;
+        }
+
+        default:
+            break;
+    }
+
+    // typed instructions on the two topmost values, the verifier proves verified code pushed both of them
+    if ((opcode >= 0x40 && opcode <= 0x44) || (opcode >= 0x48 && opcode <= 0x4C) || (opcode >= 0x50 && opcode <= 0x53))
+    {
+        uint8_t kind = (opcode - 0x40) >> 3;
+        if (!verified)
+            bjit_emit_operand_check(compiler, index, 2);
+        bjit_emit_arithmetic(compiler, index, kind, opcode & 0x07, BJIT_TOP, lhsSlot, BJIT_TOP, rhsSlot, 0, 0);
+        bjit_emit_store_result(out, kind, BJIT_TOP, lhsSlot);
+        bjit_emit_move_top(out, -1);
+        return 1;
+    }
+
+    if ((opcode >= 0x60 && opcode <= 0x65) || (opcode >= 0x68 && opcode <= 0x6D) || (opcode >= 0x70 && opcode <= 0x75))
+    {
+        uint8_t kind = (opcode - 0x60) >> 3;
+        bjit_emit_compare_enabled(compiler, index);
+        if (!verified)
+            bjit_emit_operand_check(compiler, index, 2);
+        uint8_t condition = bjit_emit_compare(out, kind, bjit_compare_methods[opcode & 0x07], BJIT_TOP, lhsSlot, BJIT_TOP, rhsSlot);
+        bjit_emit_memory(out, 0, 0, 0x0F90 | condition, 0, BJIT_CPU, offsetof(bcpu, cv)); // setcc [rbx+cv]
+        bjit_emit_move_top(out, -2);
+        return 1;
+    }
+
+    // register instructions work on the frame slots, the destination only has to be released if it still holds a string
+    if (opcode >= 0xB0 && opcode <= 0xCB)
+    {
+        static const uint8_t kinds[] = {BJIT_I32, BJIT_I64, BJIT_F32};
+        static const uint8_t types[] = {BARANIUM_VARIABLE_TYPE_INT32, BARANIUM_VARIABLE_TYPE_INT64, BARANIUM_VARIABLE_TYPE_FLOAT};
+        uint8_t immediate = opcode >= 0xBE;
+        uint8_t position = opcode - (immediate ? 0xBE : 0xB0);
+        uint8_t group = position < 5 ? 0 : position < 10 ? 1 : 2;
+        uint8_t operation = position - group * 5;
+        uint8_t kind = kinds[group];
+
+        uint64_t highest = instruction->operand > instruction->target ? instruction->operand : instruction->target;
+        if (!immediate && instruction->operand2 > highest)
+            highest = instruction->operand2;
+        if (highest >= BJIT_MAX_INLINE_LOCAL)
+            return 0;
+
+        int32_t destination = bjit_local(instruction->target);
+        bjit_emit_local_check(compiler, index, highest);
+        bjit_emit_type_compare(out, BJIT_FRAME, destination, BARANIUM_VARIABLE_TYPE_STRING);
+        bjit_emit_jump_to(compiler, BJIT_CC_E, index, 1);
+        bjit_emit_arithmetic(compiler, index, kind, operation, BJIT_FRAME, local, BJIT_FRAME, immediate ? 0 : bjit_local(instruction->operand2),
+                             immediate, instruction->operand2);
+        bjit_emit_store_result(out, kind, BJIT_FRAME, destination);
+        bjit_emit_memory(out, 0, 0, 0xC7, 0, BJIT_FRAME, destination + offsetof(bstack_slot, size)); // mov dword [size], size
+        bjit_emit32(out, baranium_variable_get_size_of_type(types[group]));
+        bjit_emit_memory(out, 0, 0, 0xC7, 0, BJIT_FRAME, destination + offsetof(bstack_slot, type)); // mov dword [type], type
+        bjit_emit32(out, types[group]);
+        return 1;
+    }
+
+    if (opcode >= 0xCC && opcode <= 0xCE) // JCMP_I32_RR - JCMP_F32_RR
+    {
+        uint8_t kind = opcode - 0xCC;
+        uint64_t highest = instruction->operand > instruction->operand2 ? instruction->operand : instruction->operand2;
+        if (highest >= BJIT_MAX_INLINE_LOCAL || bjit_integer_condition(instruction->method) == BJIT_CC_ALWAYS)
+            return 0;
+
+        bjit_emit_local_check(compiler, index, highest);
+        uint8_t condition = bjit_emit_compare(out, kind, instruction->method, BJIT_FRAME, local, BJIT_FRAME, bjit_local(instruction->operand2));
+        bjit_emit_jump_to(compiler, condition, instruction->target, 0);
+        return 1;
+    }
+
+    return 0;
+}
+
+// whether an instruction continues in another function or ends the current one
+static uint8_t bjit_switches_function(uint8_t opcode)
+{
+    return opcode == 0x0E || opcode == 0x0F || opcode == 0x1C; // CALL, RET, TAILCALL
+}
+
+// whether an instruction may set the instruction pointer to something else than the next instruction
+static uint8_t bjit_may_jump(uint8_t opcode)
+{
+    return (opcode >= 0x10 && opcode <= 0x14) || opcode == 0x1B || opcode == 0x1D || (opcode >= 0x32 && opcode <= 0x37) ||
+           (opcode >= 0xCC && opcode <= 0xCE); // JCMP_I32_RR - JCMP_F32_RR
+}
+
+// whether an instruction may rewrite itself through quickening or deoptimization, the native code is stale then
+static uint8_t bjit_may_rewrite(uint8_t opcode)
+{
+    return opcode == 0x07 || (opcode >= 0x20 && opcode <= 0x24) || opcode == 0x30 || // PUSHVAR, MOD - ADD, CMP
+           (opcode >= BCPU_OPCODE_QUICKENED_FIRST && opcode <= BCPU_OPCODE_QUICKENED_LAST);
+}
+
+// emits an instruction that has no template as a call into its handler
+static void bjit_emit_handler(bjit_compiler* compiler, size_t index, OPCODE_HANDLE handle)
+{
+    bjit_emitter* out = &compiler->out;
+    uint8_t opcode = compiler->code->instructions[index].opcode;
+
+    bjit_emit_spill(out);
+    bjit_emit_call(compiler, index, handle);
+
+    if (bjit_may_rewrite(opcode))
+    {
+        // cmp byte [code+jit_stale], 0; jne hand_back
+        bjit_emit_load_immediate(out, BJIT_RAX, (uint64_t)(uintptr_t)compiler->code);
+        bjit_emit_memory(out, 0, 0, 0x80, 7, BJIT_RAX, offsetof(bcode, jit_stale));
+        bjit_emit8(out, 0x00);
+        bjit_emit_jump(out, BJIT_CC_NE, compiler->hand_back);
+    }
+
+    if (bjit_switches_function(opcode))
+    {
+        // calls into callbacks stay in this function and continue natively
+        bjit_emit_memory(out, 0, 1, 0x8B, BJIT_RAX, BJIT_CPU, offsetof(bcpu, ip));         // mov rax, [rbx+ip]
+        bjit_emit_registers(out, 0, 1, 0x81, 7, BJIT_RAX);                                  // cmp rax, index+1
+        bjit_emit32(out, index + 1);
+        bjit_emit_jump(out, BJIT_CC_NE, compiler->leave);
+        bjit_emit_memory(out, 0, 1, 0x8B, BJIT_RAX, BJIT_CPU, offsetof(bcpu, bus));        // mov rax, [rbx+bus]
+        bjit_emit_memory(out, 0, 1, 0x8B, BJIT_RAX, BJIT_RAX, offsetof(bbus, data_holder)); // mov rax, [rax+data_holder]
+        bjit_emit_memory(out, 0, 1, 0x8B, BJIT_RAX, BJIT_RAX, offsetof(baranium_function, code)); // mov rax, [rax+code]
+        bjit_emit_load_immediate(out, BJIT_RCX, (uint64_t)(uintptr_t)compiler->code);
+        bjit_emit_registers(out, 0, 1, 0x39, BJIT_RCX, BJIT_RAX);                           // cmp rax, rcx
+        bjit_emit_jump(out, BJIT_CC_NE, compiler->leave);
+    }
+
+    bjit_emit_reload(out);
+
+    if (!bjit_switches_function(opcode) && bjit_may_jump(opcode))
+    {
+        // continue with the next instruction or wherever the handler jumped to
+        bjit_emit_memory(out, 0, 1, 0x8B, BJIT_RAX, BJIT_CPU, offsetof(bcpu, ip));         // mov rax, [rbx+ip]
+        bjit_emit_registers(out, 0, 1, 0x81, 7, BJIT_RAX);                                  // cmp rax, index+1
+        bjit_emit32(out, index + 1);
+        bjit_emit_jump(out, BJIT_CC_NE, compiler->dispatch);
+    }
+}
+
+// emits the prologue, the dispatch and the exits every function shares
+static void bjit_emit_frame(bjit_compiler* compiler, void** table)
+{
+    bjit_emitter* out = &compiler->out;
+
+    // keep the callee saved registers, the pushes and the padding leave the stack aligned for the handler calls
+    bjit_emit_bytes(out, (const uint8_t[]){
+        0x53,                   // push rbx
+        0x55,                   // push rbp
+        0x41, 0x54,             // push r12
+        0x41, 0x55,             // push r13
+        0x41, 0x56,             // push r14
+        0x41, 0x57,             // push r15
+        0x48, 0x83, 0xEC, 0x08, // sub rsp, 8
+        0x48, 0x89, 0xFB,       // mov rbx, rdi
+    }, 17);
+    bjit_emit_reload(out);
+    bjit_emit_memory(out, 0, 1, 0x8B, BJIT_RAX, BJIT_CPU, offsetof(bcpu, ip));             // mov rax, [rbx+ip]
+
+    // continue at the instruction rax holds the index of
+    compiler->dispatch = out->size;
+    bjit_emit_load_immediate(out, BJIT_RCX, (uint64_t)(uintptr_t)table);
+    bjit_emit_bytes(out, (const uint8_t[]){0xFF, 0x24, 0xC1}, 3);                          // jmp [rcx+rax*8]
+
+    // the cpu left the function or got killed, the interpreter picks up the new function
+    compiler->leave = out->size;
+    bjit_emit_bytes(out, (const uint8_t[]){0xB8, 0x01, 0x00, 0x00, 0x00}, 5);              // mov eax, 1
+    bjit_emit_bytes(out, (const uint8_t[]){0xEB, 0x02}, 2);                                 // jmp epilogue
+
+    // an instruction got rewritten or has no handler, the interpreter continues at the instruction pointer
+    compiler->hand_back = out->size;
+    bjit_emit_bytes(out, (const uint8_t[]){0x31, 0xC0}, 2);                                 // xor eax, eax
+    bjit_emit_bytes(out, (const uint8_t[]){
+        0x48, 0x83, 0xC4, 0x08, // add rsp, 8
+        0x41, 0x5F,             // pop r15
+        0x41, 0x5E,             // pop r14
+        0x41, 0x5D,             // pop r13
+        0x41, 0x5C,             // pop r12
+        0x5D,                   // pop rbp
+        0x5B,                   // pop rbx
+        0xC3,                   // ret
+    }, 15);
+}
+
+uint8_t bjit_compile(bcode* code)
+{
+    if (code == NULL || code->jit != NULL)
+        return code != NULL;
+
+    if (code->jit_failed || code->count > BJIT_MAX_INSTRUCTIONS)
+    {
+        code->jit_failed = 1;
+        return 0;
+    }
+
+    bjit_compiler compiler = {
+        .code = code,
+        .handlers = code->verified ? verified_opcodes : opcodes,
+        .offsets = malloc(sizeof(size_t) * code->count),
+        .stubs = calloc(code->count, sizeof(size_t)),
+    };
+    bjit_code* jit = malloc(sizeof(bjit_code));
+    void** table = malloc(sizeof(void*) * code->count);
+    bjit_emitter* out = &compiler.out;
+    uint8_t* memory = MAP_FAILED;
+    if (jit == NULL || table == NULL || compiler.offsets == NULL || compiler.stubs == NULL || !bjit_reserve(out, BJIT_FRAME_SIZE))
+        goto outOfMemory;
+
+    bjit_emit_frame(&compiler, table);
+
+    // the instructions follow each other, so execution falls through from one to the next
+    for (size_t i = 0; i < code->count && !compiler.failed; i++)
+    {
+        const bcpu_instruction* instruction = &code->instructions[i];
+        OPCODE_HANDLE handle = compiler.handlers[instruction->opcode].handle;
+        if (!bjit_reserve(out, BJIT_MAX_INSTRUCTION_SIZE))
+            goto outOfMemory;
+        compiler.offsets[i] = out->size;
+
+        // opcodes without a handler are left to the interpreter
+        if (handle == NULL || handle == INVALID_OPCODE)
+        {
+            bjit_emit_spill(out);
+            bjit_emit_memory(out, 0, 1, 0xC7, 0, BJIT_CPU, offsetof(bcpu, ip));           // mov qword [rbx+ip], i
+            bjit_emit32(out, i);
+            bjit_emit_jump(out, BJIT_CC_ALWAYS, compiler.hand_back);
+            continue;
+        }
+
+        bjit_emit_registers(out, 0, 1, 0xFF, 0, BJIT_TICKS);                                // inc rbp
+
+        // plain jumps don't need their handler
+        if (instruction->opcode == 0x10 || instruction->opcode == 0x11) // JMP, JMPOFF
+        {
+            bjit_emit_jump_to(&compiler, BJIT_CC_ALWAYS, instruction->target, 0);
+            continue;
+        }
+
+        if (bjit_emit_inline(&compiler, i))
+            compiler.inlined++;
+        else
+            bjit_emit_handler(&compiler, i, handle);
+    }
+
+    // the code always ends with a RET, which never falls through, but the interpreter takes over if it does
+    if (!bjit_reserve(out, BJIT_MAX_INSTRUCTION_SIZE))
+        goto outOfMemory;
+    bjit_emit_spill(out);
+    bjit_emit_jump(out, BJIT_CC_ALWAYS, compiler.leave);
+
+    // the slow paths of the templates sit behind the code, they call the handler and continue wherever it left the cpu
+    for (size_t i = 0; i < code->count && !compiler.failed; i++)
+    {
+        if (!compiler.stubs[i])
+            continue;
+
+        if (!bjit_reserve(out, BJIT_MAX_INSTRUCTION_SIZE))
+            goto outOfMemory;
+        compiler.stubs[i] = out->size;
+        bjit_emit_spill(out);
+        bjit_emit_call(&compiler, i, compiler.handlers[code->instructions[i].opcode].handle);
+        bjit_emit_reload(out);
+        bjit_emit_redispatch(&compiler);
+    }
+
+    if (compiler.failed)
+        goto outOfMemory;
+
+    for (size_t i = 0; i < compiler.fixup_count; i++)
+    {
+        bjit_fixup* fixup = &compiler.fixups[i];
+        bjit_patch(out->data, fixup->position, fixup->slow ? compiler.stubs[fixup->target] : compiler.offsets[fixup->target]);
+    }
+
+    // the mapping is never writable and executable at the same time
+    memory = mmap(NULL, out->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+        goto outOfMemory;
+    memcpy(memory, out->data, out->size);
+    if (mprotect(memory, out->size, PROT_READ | PROT_EXEC) != 0)
+    {
+        LOGERROR("Could not make native code executable");
+        munmap(memory, out->size);
+        memory = MAP_FAILED;
+        goto failed;
+    }
+
+    for (size_t i = 0; i < code->count; i++)
+        table[i] = memory + compiler.offsets[i];
+
+    *jit = (bjit_code){.memory = memory, .size = out->size, .table = table, .active = 0};
+    code->jit = jit;
+
+    LOGDEBUG("Compiled %zu instructions into %zu bytes of native code, %zu of them inline", code->count, out->size, compiler.inlined);
+
+    free(out->data);
+    free(compiler.offsets);
+    free(compiler.stubs);
+    free(compiler.fixups);
+    return 1;
+
+outOfMemory:
+    LOGERROR("Could not compile function, out of memory");
+failed:
+    free(out->data);
+    free(compiler.offsets);
+    free(compiler.stubs);
+    free(compiler.fixups);
+    free(table);
+    free(jit);
+    code->jit_failed = 1;
+    return 0;
+}
+
+uint8_t bjit_run(bcpu* cpu, bcode* code)
+{
+    bjit_code* jit = code->jit;
+    bjit_entry entry = (bjit_entry)(void*)jit->memory;
+
+    jit->active++;
+    uint8_t finished = entry(cpu);
+    jit->active--;
+
+    return finished;
+}
+
+void bjit_drop_stale(bcode* code)
+{
+    if (code == NULL || code->jit == NULL || !code->jit_stale || code->jit->active > 0)
+        return;
+
+    LOGDEBUG("Dropping native code of %zu instructions, instructions got rewritten since it was compiled", code->count);
+
+    bjit_dispose(code->jit);
+    code->jit = NULL;
+    code->jit_stale = 0;
+}
+
+void bjit_dispose(bjit_code* jit)
+{
+    if (jit == NULL)
+        return;
+
+    munmap(jit->memory, jit->size);
+    free(jit->table);
+    free(jit);
+}
+
+#else
+
+uint8_t bjit_compile(bcode* code)
+{
+    if (code != NULL)
+        code->jit_failed = 1;
+
+    return 0;
+}
+
+uint8_t bjit_run(bcpu* cpu, bcode* code)
+{
+    return 0;
+}
+
+void bjit_drop_stale(bcode* code)
+{
+}
+
+void bjit_dispose(bjit_code* jit)
+{
+}
+
+#endif
@@ -1,4 +1,6 @@
+#include <baranium/backend/bstring.h>
 #include <baranium/cpu/bstack.h>
+#include <baranium/variable.h>
 #include <memory.h>
 #include <stdlib.h>
 
@@ -8,14 +10,14 @@ bstack* bstack_init(void)
     if (obj == NULL) return NULL;
 
     memset(obj, 0, sizeof(bstack));
-    obj->stackptr = malloc(sizeof(uint64_t)*INITIAL_STACK_SIZE);
-    if (obj->stackptr == NULL)
+    obj->slots = malloc(sizeof(bstack_slot)*INITIAL_STACK_SIZE);
+    if (obj->slots == NULL)
     {
         free(obj);
         return NULL;
     }
-    memset(obj->stackptr, 0, INITIAL_STACK_SIZE);
-    obj->buffer_size = INITIAL_STACK_SIZE;
+    memset(obj->slots, 0, sizeof(bstack_slot)*INITIAL_STACK_SIZE);
+    obj->capacity = INITIAL_STACK_SIZE;
     obj->count = 0;
 
     return obj;
@@ -25,40 +27,84 @@ void bstack_dispose(bstack* obj)
 {
     if (!obj) return;
 
-    free(obj->stackptr);
+    bstack_clear(obj);
+    free(obj->slots);
     free(obj);
 }
 
 void bstack_clear(bstack* obj)
 {
     if (obj == NULL) return;
-    if (obj->stackptr == NULL) return;
-    memset(obj->stackptr, 0, obj->buffer_size);
+    if (obj->slots == NULL) return;
+
+    for (size_t i = 0; i < obj->count; i++)
+        if (obj->slots[i].type == BARANIUM_VARIABLE_TYPE_STRING)
+            bstring_release((char*)obj->slots[i].data);
+
+    memset(obj->slots, 0, sizeof(bstack_slot)*obj->capacity);
     obj->count = 0;
 }
 
-void bstack_push(bstack* obj, uint64_t data)
+uint8_t bstack_reserve(bstack* obj, size_t count)
 {
     if (obj == NULL)
+        return 0;
+
+    if (obj->count + count <= obj->capacity)
+        return 1;
+
+    size_t capacity = obj->capacity ? obj->capacity : INITIAL_STACK_SIZE;
+    while (obj->count + count > capacity)
+        capacity *= 2;
+
+    bstack_slot* slots = realloc(obj->slots, sizeof(bstack_slot)*capacity);
+    if (slots == NULL)
+        return 0;
+
+    obj->slots = slots;
+    obj->capacity = capacity;
+    return 1;
+}
+
+void bstack_truncate(bstack* obj, size_t count)
+{
+    if (obj == NULL || count >= obj->count)
         return;
 
-    if (obj->count * sizeof(uint64_t) == obj->buffer_size)
-    {
-        obj->buffer_size += INITIAL_STACK_SIZE;
-        obj->stackptr = realloc(obj->stackptr, obj->buffer_size);
-    }
-    obj->stackptr[obj->count] = data;
-    obj->count++;
+    for (size_t i = count; i < obj->count; i++)
+        if (obj->slots[i].type == BARANIUM_VARIABLE_TYPE_STRING)
+            bstring_release((char*)obj->slots[i].data);
+
+    obj->count = count;
+}
+
+void bstack_push(bstack* obj, uint64_t data)
+{
+    bstack_push_slot(obj, (bstack_slot){.data = data, .size = sizeof(uint64_t), .type = BSTACK_SLOT_TYPE_RAW});
 }
 
 uint64_t bstack_pop(bstack* obj)
+{
+    return bstack_pop_slot(obj).data;
+}
+
+void bstack_push_slot(bstack* obj, bstack_slot slot)
 {
     if (obj == NULL)
-        return 0;
+        return;
 
-    if (obj->count == 0)
-        return 0;
+    if (obj->count == obj->capacity && !bstack_reserve(obj, 1))
+        return;
+
+    obj->slots[obj->count] = slot;
+    obj->count++;
+}
+
+bstack_slot bstack_pop_slot(bstack* obj)
+{
+    if (obj == NULL || obj->count == 0)
+        return (bstack_slot){0};
 
     obj->count--;
-    return obj->stackptr[obj->count];
+    return obj->slots[obj->count];
 }
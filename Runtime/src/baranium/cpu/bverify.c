@@ -0,0 +1,327 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_CPU
+
+#include <baranium/cpu/bverify.h>
+#include <baranium/logging.h>
+#include <stdlib.h>
+
+// how the execution continues after an instruction
+#define BVERIFY_FLOW_INVALID 0  // not an instruction
+#define BVERIFY_FLOW_NEXT    1  // the next instruction
+#define BVERIFY_FLOW_BRANCH  2  // the next instruction or the target
+#define BVERIFY_FLOW_JUMP    3  // the target
+#define BVERIFY_FLOW_CALL    4  // the next instruction once the callee returned, callees and callbacks may leave anything on the stack
+#define BVERIFY_FLOW_END     5  // the function is left
+
+// points the depth of the stack is counted from, the entry of the function, the return of a call
+// or a join of paths that were counted from different points
+#define BVERIFY_BASE_ENTRY        0
+#define BVERIFY_BASE_CALL(index) ((uint64_t)(index) * 2 + 1)
+#define BVERIFY_BASE_JOIN(index) ((uint64_t)(index) * 2 + 2)
+
+// what is known about the stack before an instruction
+typedef struct bverify_state
+{
+    uint64_t base;      // point the depth is counted from, see BVERIFY_BASE_ENTRY
+    int64_t depth;      // values pushed since the base, negative if more were popped
+    uint64_t proven;    // values that are on the stack on every path, calls are not looked into so they reset it
+    uint8_t visited;
+    uint8_t queued;
+} bverify_state;
+
+// gets the flow of an instruction and how many values it pops and pushes
+static uint8_t bverify_effect(const bcpu_instruction* instruction, uint64_t* pops, uint64_t* pushes)
+{
+    *pops = 0;
+    *pushes = 0;
+
+    uint8_t opcode = instruction->opcode;
+    switch (opcode)
+    {
+        case 0x00: // NOP
+        case 0x01: // CCF
+        case 0x02: // SCF
+        case 0x03: // CCV
+        case 0x04: // ICV
+        case 0x0A: // INCVAR
+        case 0x0B: // DECVAR
+        case 0x0C: // ADDVAR_IMM
+        case 0x15: // ENTER
+        case 0x18: // INCLOCAL
+        case 0x19: // DECLOCAL
+        case 0x1A: // ADDLOCAL_IMM
+        case 0x80: // MEM
+        case 0x81: // FEM
+        case 0x82: // SET
+            return BVERIFY_FLOW_NEXT;
+
+        case 0x05: // PUSHCV
+        case 0x07: // PUSHVAR
+        case 0x09: // PUSH
+        case 0x0D: // PUSHV
+        case 0x16: // LOADLOCAL
+            *pushes = 1;
+            return BVERIFY_FLOW_NEXT;
+
+        case 0x06: // POPCV
+        case 0x08: // POPVAR
+        case 0x17: // STORELOCAL
+        case 0xD0: // INSTANTIATE
+        case 0xD1: // DELETE
+        case 0xD2: // ATTACH
+        case 0xD3: // DETACH
+            *pops = 1;
+            return BVERIFY_FLOW_NEXT;
+
+        case 0x0E: // CALL
+            return BVERIFY_FLOW_CALL;
+
+        case 0x0F: // RET
+        case 0x1C: // TAILCALL
+        case 0xFF: // KILL
+            return BVERIFY_FLOW_END;
+
+        case 0x10: // JMP
+        case 0x11: // JMPOFF
+            return BVERIFY_FLOW_JUMP;
+
+        case 0x12: // JMPC
+        case 0x13: // JMPCOFF
+        case 0x14: // CMPVAR_IMM_JMP
+        case 0x1B: // CMPLOCAL_IMM_JMP
+        case 0x1D: // JMPNC
+            return BVERIFY_FLOW_BRANCH;
+
+        case 0x2A: // CONCATN
+            *pops = instruction->operand;
+            *pushes = 1;
+            return BVERIFY_FLOW_NEXT;
+
+        case 0x30: // CMP
+        case 0x31: // CMPC
+            *pops = 2;
+            return BVERIFY_FLOW_NEXT;
+
+        default:
+            break;
+    }
+
+    // MOD - SHFTR, ADD_I32 - DIV_F32
+    if ((opcode >= 0x20 && opcode <= 0x29) || (opcode >= 0x40 && opcode <= 0x44) ||
+        (opcode >= 0x48 && opcode <= 0x4C) || (opcode >= 0x50 && opcode <= 0x53))
+    {
+        *pops = 2;
+        *pushes = 1;
+        return BVERIFY_FLOW_NEXT;
+    }
+
+    // CMP_EQ_I32 - CMP_GE_F32
+    if ((opcode >= 0x60 && opcode <= 0x65) || (opcode >= 0x68 && opcode <= 0x6D) || (opcode >= 0x70 && opcode <= 0x75))
+    {
+        *pops = 2;
+        return BVERIFY_FLOW_NEXT;
+    }
+
+    // JEQ - JGE
+    if (opcode >= 0x32 && opcode <= 0x37)
+    {
+        *pops = 2;
+        return BVERIFY_FLOW_BRANCH;
+    }
+
+    // ADD_I32_RR - DIV_F32_RI, JCMP_I32_RR - JCMP_F32_RR
+    if (opcode >= BCPU_OPCODE_REGISTER_FIRST && opcode <= 0xCB)
+        return BVERIFY_FLOW_NEXT;
+    if (opcode >= 0xCC && opcode <= 0xCE)
+        return BVERIFY_FLOW_BRANCH;
+
+    return BVERIFY_FLOW_INVALID;
+}
+
+// whether an instruction takes its operands from the stack without checking that they are there, ADD_I32 - CMP_GE_F32
+static uint8_t bverify_is_typed(uint8_t opcode)
+{
+    return opcode >= 0x40 && opcode <= 0x75;
+}
+
+// whether every local and register slot an instruction accesses lies inside of a frame of `locals` slots
+static uint8_t bverify_locals_fit(const bcpu_instruction* instruction, uint64_t locals)
+{
+    uint8_t opcode = instruction->opcode;
+
+    // LOADLOCAL - CMPLOCAL_IMM_JMP
+    if (opcode >= 0x16 && opcode <= 0x1B)
+        return instruction->operand < locals;
+
+    // ADD_I32_RR - DIV_F32_RR
+    if (opcode >= BCPU_OPCODE_REGISTER_FIRST && opcode <= 0xBD)
+        return instruction->target < locals && instruction->operand < locals && instruction->operand2 < locals;
+
+    // ADD_I32_RI - DIV_F32_RI, the right operand is an immediate
+    if (opcode >= 0xBE && opcode <= 0xCB)
+        return instruction->target < locals && instruction->operand < locals;
+
+    // JCMP_I32_RR - JCMP_F32_RR, the target is the jump target
+    if (opcode >= 0xCC && opcode <= 0xCE)
+        return instruction->operand < locals && instruction->operand2 < locals;
+
+    return 1;
+}
+
+// merges the state an instruction leaves into the state before one of its successors,
+// returns 0 if both are counted from the same point but their depths differ
+static uint8_t bverify_merge(bverify_state* states, size_t* worklist, size_t* pending, size_t index, bverify_state state)
+{
+    bverify_state* known = &states[index];
+    if (!known->visited)
+    {
+        *known = state;
+        known->visited = 1;
+    }
+    else
+    {
+        uint8_t changed = 0;
+        if (known->base == state.base && known->depth != state.depth)
+            return 0;
+
+        // callees can leave any number of values behind, so paths through different calls only keep the larger depth
+        if (known->base != state.base)
+        {
+            if (state.depth > known->depth)
+            {
+                known->depth = state.depth;
+                changed = 1;
+            }
+            if (known->base != BVERIFY_BASE_JOIN(index))
+            {
+                known->base = BVERIFY_BASE_JOIN(index);
+                changed = 1;
+            }
+        }
+
+        if (state.proven < known->proven)
+        {
+            known->proven = state.proven;
+            changed = 1;
+        }
+
+        if (!changed)
+            return 1;
+    }
+
+    if (!known->queued)
+    {
+        known->queued = 1;
+        worklist[(*pending)++] = index;
+    }
+
+    return 1;
+}
+
+// walks every path through the code, `states` and `worklist` have an entry per instruction
+static uint8_t bverify_walk(bcode* code, bverify_state* states, size_t* worklist)
+{
+    // the frame of a function is made by an ENTER at its start and keeps its size until the function is left
+    uint64_t locals = code->instructions[0].opcode == 0x15 ? code->instructions[0].operand : 0;
+
+    size_t pending = 0;
+    bverify_merge(states, worklist, &pending, 0, (bverify_state){.base = BVERIFY_BASE_ENTRY});
+
+    while (pending > 0)
+    {
+        size_t index = worklist[--pending];
+        states[index].queued = 0;
+
+        const bcpu_instruction* instruction = &code->instructions[index];
+        bverify_state state = states[index];
+        uint64_t pops = 0;
+        uint64_t pushes = 0;
+        uint8_t flow = bverify_effect(instruction, &pops, &pushes);
+
+        if (flow == BVERIFY_FLOW_INVALID)
+        {
+            LOGDEBUG("Not verified: invalid opcode 0x%2.2x at instruction %zu", instruction->opcode, index);
+            return 0;
+        }
+
+        if (instruction->opcode == 0x15 && index != 0)
+        {
+            LOGDEBUG("Not verified: ENTER at instruction %zu is not at the start of the function", index);
+            return 0;
+        }
+
+        if (!bverify_locals_fit(instruction, locals))
+        {
+            LOGDEBUG("Not verified: instruction %zu accesses a local outside of the %llu slots of the frame", index, (unsigned long long)locals);
+            return 0;
+        }
+
+        if (bverify_is_typed(instruction->opcode) && state.proven < 2)
+        {
+            LOGDEBUG("Not verified: the operands of instruction %zu are not pushed on every path", index);
+            return 0;
+        }
+
+        state.depth += (int64_t)pushes - (int64_t)pops;
+        state.proven = (state.proven > pops ? state.proven - pops : 0) + pushes;
+
+        // without a loop no path pushes more values than there are instructions, more means a loop keeps pushing
+        if (state.depth > (int64_t)code->count)
+        {
+            LOGDEBUG("Not verified: the stack keeps growing in a loop through instruction %zu", index);
+            return 0;
+        }
+
+        if (state.depth > 0 && (size_t)state.depth > code->max_stack)
+            code->max_stack = state.depth;
+
+        if (flow == BVERIFY_FLOW_CALL)
+            state = (bverify_state){.base = BVERIFY_BASE_CALL(index)};
+
+        // every path ends in a RET, KILL or TAILCALL, the decoder terminates the code with a RET
+        uint8_t merged = 1;
+        if (flow == BVERIFY_FLOW_NEXT || flow == BVERIFY_FLOW_BRANCH || flow == BVERIFY_FLOW_CALL)
+            merged = index + 1 < code->count && bverify_merge(states, worklist, &pending, index + 1, state);
+        if (merged && (flow == BVERIFY_FLOW_BRANCH || flow == BVERIFY_FLOW_JUMP))
+            merged = instruction->target < code->count && bverify_merge(states, worklist, &pending, instruction->target, state);
+
+        if (!merged)
+        {
+            LOGDEBUG("Not verified: the stack depth after instruction %zu differs between the paths that join", index);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+uint8_t bverify_code(bcode* code)
+{
+    if (code == NULL)
+        return 0;
+
+    code->verified = 0;
+    code->max_stack = 0;
+
+    if (code->malformed || code->count == 0)
+    {
+        LOGDEBUG("Not verified: the code is malformed");
+        return 0;
+    }
+
+    bverify_state* states = calloc(code->count, sizeof(bverify_state));
+    size_t* worklist = malloc(sizeof(size_t) * code->count);
+    if (states == NULL || worklist == NULL)
+    {
+        free(states);
+        free(worklist);
+        return 0;
+    }
+
+    code->verified = bverify_walk(code, states, worklist);
+    if (!code->verified)
+        code->max_stack = 0;
+
+    free(states);
+    free(worklist);
+    return code->verified;
+}
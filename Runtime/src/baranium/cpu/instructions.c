@@ -1,5 +1,6 @@
 #include "baranium/function.h"
-#include <baranium/backend/bfuncmgr.h>
+#include <baranium/backend/bfunccache.h>
+#include <baranium/backend/bstring.h>
 #include <baranium/backend/bvarmgr.h>
 #include <baranium/backend/varmath.h>
 #include <baranium/backend/errors.h>
@@ -8,9 +9,13 @@
 #include <baranium/runtime.h>
 #include <baranium/logging.h>
 #include <baranium/defines.h>
+#include <baranium/cpu/bcode.h>
+#include <baranium/cpu/bjit.h>
 #include <baranium/bcpu.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
 
@@ -24,57 +29,132 @@
 #define CMP_AND 0
 #define CMP_OR  1
 
-void INVALID_OPCODE(bcpu* cpu)
+static void bcpu_compare(bcpu* cpu, baranium_compiled_variable* val0, baranium_compiled_variable* val1, uint8_t operation);
+
+// executions with the same operand type after which a generic instruction is rewritten into its specialized variant
+#define BCPU_QUICKEN_THRESHOLD 0x10
+
+// feedback of an instruction whose specialized variant saw another type, it stays generic from then on
+#define BCPU_FEEDBACK_GENERIC 0xFF
+
+// native code has the handlers of the instructions built in, so it is dropped and compiled again
+// once an instruction of the current function gets rewritten, see `bjit_drop_stale`
+static void bcpu_invalidate_native(bcpu* cpu)
 {
-    if (!cpu) return;
+    bcode* code = cpu->bus->data_holder->code;
+    if (code->jit != NULL)
+        code->jit_stale = 1;
+}
 
-    cpu->kill_triggered = 1;
-    LOGERROR("invalid opcode, quitting...");
+// records the operand type a generic instruction saw and rewrites it into `quickened` once it saw the same type
+// often enough in a row, a quickened opcode of 0 means there is no specialized variant for what the instruction saw
+static void bcpu_quicken(bcpu* cpu, const bcpu_instruction* instruction, baranium_variable_type_t type, uint8_t quickened)
+{
+    // the decoded code belongs to the function, handlers only get a const view of it
+    bcpu_instruction* generic = (bcpu_instruction*)instruction;
+    if (generic->feedback == BCPU_FEEDBACK_GENERIC)
+        return;
+
+    if (quickened == 0 || generic->type != type)
+    {
+        generic->type = type;
+        generic->feedback = quickened != 0;
+        return;
+    }
+
+    if (++generic->feedback < BCPU_QUICKEN_THRESHOLD)
+        return;
+
+    LOGDEBUG("Specializing '%s' into '%s'", opcodes[generic->opcode].name, opcodes[quickened].name);
+    generic->opcode = quickened;
+    bcpu_invalidate_native(cpu);
 }
 
-void NOP(bcpu* cpu)
+// the guard of a specialized instruction failed, it goes back to the generic opcode for good
+static void bcpu_deoptimize(bcpu* cpu, const bcpu_instruction* instruction, uint8_t generic)
 {
-    if(!cpu)
+    bcpu_instruction* quickened = (bcpu_instruction*)instruction;
+
+    LOGDEBUG("Deoptimizing '%s' back to '%s'", opcodes[quickened->opcode].name, opcodes[generic].name);
+    quickened->opcode = generic;
+    quickened->feedback = BCPU_FEEDBACK_GENERIC;
+    bcpu_invalidate_native(cpu);
+}
+
+// the specialized variant of a generic arithmetic or compare instruction for two operands of the given type, 0 if there is none
+static uint8_t bcpu_quickened_opcode(uint8_t opcode, baranium_variable_type_t type)
+{
+    int variant = -1;
+    if (type == BARANIUM_VARIABLE_TYPE_INT32)
+        variant = 0;
+    else if (type == BARANIUM_VARIABLE_TYPE_INT64)
+        variant = 1;
+    else if (type == BARANIUM_VARIABLE_TYPE_FLOAT)
+        variant = 2;
+    else
+        return 0;
+
+    switch (opcode)
+    {
+        case 0x20: return (const uint8_t[]){0x95, 0x9A, 0x00}[variant]; // MOD
+        case 0x21: return (const uint8_t[]){0x94, 0x99, 0x9E}[variant]; // DIV
+        case 0x22: return (const uint8_t[]){0x93, 0x98, 0x9D}[variant]; // MUL
+        case 0x23: return (const uint8_t[]){0x92, 0x97, 0x9C}[variant]; // SUB
+        case 0x24: return (const uint8_t[]){0x91, 0x96, 0x9B}[variant]; // ADD
+        case 0x30: return (const uint8_t[]){0x9F, 0xA0, 0xA1}[variant]; // CMP
+        default:   return 0;
+    }
+}
+
+// feeds the types of the two topmost values into the feedback of a generic arithmetic or compare instruction
+static void bcpu_observe_operands(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    bstack_slot* top = cpu->stack->slots + cpu->stack->count;
+    if (cpu->stack->count < 2 || top[-2].type != top[-1].type)
+    {
+        bcpu_quicken(cpu, instruction, BARANIUM_VARIABLE_TYPE_INVALID, 0);
         return;
+    }
 
-    LOGWARNING("NOP Call detected");
+    bcpu_quicken(cpu, instruction, top[-1].type, bcpu_quickened_opcode(instruction->opcode, top[-1].type));
 }
 
-void CCF(bcpu* cpu)
+void INVALID_OPCODE(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
+    cpu->kill_triggered = 1;
+    LOGERROR("invalid opcode, quitting...");
+}
 
-    cpu->flags.CMP = 0;
+void NOP(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    LOGWARNING("NOP Call detected");
 }
 
-void SCF(bcpu* cpu)
+void CCF(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
+    cpu->flags.CMP = 0;
+}
 
+void SCF(bcpu* cpu, const bcpu_instruction* instruction)
+{
     cpu->flags.CMP = 1;
 }
 
-void CCV(bcpu* cpu)
+void CCV(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
     cpu->cv = 0;
 }
 
-void ICV(bcpu* cpu)
+void ICV(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
     if (cpu->cv)
         cpu->cv = 0;
     else
         cpu->cv = 1;
 }
 
-void PUSHCV(bcpu* cpu)
+void PUSHCV(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
     baranium_compiled_variable var;
     var.size = sizeof(uint8_t);
     var.type = BARANIUM_VARIABLE_TYPE_BOOL;
@@ -82,22 +162,20 @@ void PUSHCV(bcpu* cpu)
     baranium_compiled_variable_push_to_stack(cpu, &var);
 }
 
-void POPCV(bcpu* cpu)
+void POPCV(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
     baranium_compiled_variable var = {0,{0},0};
     baranium_compiled_variable_pop_from_stack_into_variable(cpu, &var);
     cpu->cv = var.value.num8;
+    if (var.type == BARANIUM_VARIABLE_TYPE_STRING)
+        bstring_release(var.value.ptr);
 }
 
-void PUSHVAR(bcpu* cpu)
+void PUSHVAR(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
-    index_t id = (index_t)cpu->fetch(cpu, 64);
     bvarmgr* varmgr = cpu->runtime->varmgr;
-    bvarmgr_n* var = bvarmgr_get(varmgr, id);
+    index_t id = varmgr->slots[instruction->operand].id;
+    bvarmgr_n* var = bvarmgr_get_slot(varmgr, instruction->operand);
     if (var == NULL)
     {
         LOGERROR("Variable/Field with ID '%d' not found", id);
@@ -132,47 +210,21 @@ void PUSHVAR(bcpu* cpu)
         return;
     }
 
-    void* basevalue = &value.num64;
-    if (type == BARANIUM_VARIABLE_TYPE_STRING)
-        basevalue = value.ptr;
-
-    uint64_t data = 0;
-    if (size <= 8)
-    {
-        memcpy(&data, basevalue, size);
-        bstack_push(cpu->stack, data);
-    }
+    // only plain variables without strings have a specialized variant
+    if (var->isVariable && type != BARANIUM_VARIABLE_TYPE_STRING)
+        bcpu_quicken(cpu, instruction, type, 0x90);
     else
-    {
-        size_t leftOverSize = size;
-        size_t index = 0;
-        void* valPtr;
-        for (index = 0; index * 8 < size; index++)
-        {
-            if (leftOverSize < 8)
-                break;
-            valPtr = (void*)((uint64_t)basevalue + index*8);
-            memcpy(&data, valPtr, 8);
-            leftOverSize -= 8;
-            bstack_push(cpu->stack, data);
-        }
-        valPtr = (void*)((uint64_t)basevalue + index*8);
-        data = 0;
-        memcpy(&data, valPtr, leftOverSize);
-        bstack_push(cpu->stack, data);
-    }
+        bcpu_quicken(cpu, instruction, type, 0);
 
-    bstack_push(cpu->stack, (uint64_t)size);
-    bstack_push(cpu->stack, (uint64_t)type);
+    baranium_compiled_variable pushed = {.type=type, .value=value, .size=size};
+    baranium_compiled_variable_push_reference_to_stack(cpu, &pushed);
 }
 
-void POPVAR(bcpu* cpu)
+void POPVAR(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
-    index_t id = (index_t)cpu->fetch(cpu, 64);
     bvarmgr* varmgr = cpu->runtime->varmgr;
-    bvarmgr_n* var = bvarmgr_get(varmgr, id);
+    index_t id = varmgr->slots[instruction->operand].id;
+    bvarmgr_n* var = bvarmgr_get_slot(varmgr, instruction->operand);
     if (var == NULL)
     {
         LOGERROR("Variable/Field with ID '%d' not found", id);
@@ -214,13 +266,17 @@ void POPVAR(bcpu* cpu)
         LOGERROR("Variable/Field with ID '%d' cannot be assigned: Non-matching types of variable and assign value", id);
         bstack_push(cpu->stack, BARANIUM_ERROR_VAR_INVALID_TYPE);
         if (newvar.type == BARANIUM_VARIABLE_TYPE_STRING)
-            free(newvar.value.ptr);
+            bstring_release(newvar.value.ptr);
         cpu->flags.FORCED_KILL = 1;
         cpu->kill_triggered = 1;
         return;
     }
     baranium_compiled_variable_convert_to_type(&newvar, type);
 
+    // the reference of the popped value moves into the variable, so the previous string is released
+    if (type == BARANIUM_VARIABLE_TYPE_STRING && value.ptr != newvar.value.ptr)
+        bstring_release(value.ptr);
+
     // assign new size and value pointers for the variable/field
     if (var->isVariable)
     {
@@ -234,27 +290,215 @@ void POPVAR(bcpu* cpu)
     }
 }
 
-void PUSH(bcpu* cpu)
+void PUSH(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    bstack_push(cpu->stack, instruction->operand);
+}
+
+void PUSHV(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    // string literals are created once when the code is decoded, pushing them only takes another reference
+    bstack_slot slot = {.data = instruction->operand2, .size = instruction->operand, .type = instruction->type};
+    if (slot.type == BARANIUM_VARIABLE_TYPE_STRING)
+        bstring_retain((char*)slot.data);
+
+    bstack_push_slot(cpu->stack, slot);
+}
+
+// applies an operation with an immediate operand to a value in place, the result keeps the type of the value
+static void bcpu_apply_immediate(baranium_compiled_variable* target, baranium_compiled_variable* operand, uint8_t operation)
+{
+    // the common case of counting an int up or down
+    if (target->type == BARANIUM_VARIABLE_TYPE_INT32 && operand->type == BARANIUM_VARIABLE_TYPE_INT32 && operation == BARANIUM_VARIABLE_OPERATION_ADD)
+    {
+        target->value.snum32 += operand->value.snum32;
+        return;
+    }
+
+    baranium_variable_type_t type = target->type;
+    baranium_compiled_variable_combine(target, operand, operation, type);
+    baranium_compiled_variable_convert_to_type(target, type);
+}
+
+// applies an operation with an immediate operand to a variable/field in place, the result keeps the type of the variable
+static void bcpu_variable_apply_immediate(bcpu* cpu, uint64_t slot, baranium_compiled_variable* operand, uint8_t operation)
+{
+    index_t id = cpu->runtime->varmgr->slots[slot].id;
+    bvarmgr_n* var = bvarmgr_get_slot(cpu->runtime->varmgr, slot);
+    if (var == NULL)
+    {
+        LOGERROR("Variable/Field with ID '%d' not found", id);
+        bstack_push(cpu->stack, BARANIUM_ERROR_VAR_NOT_FOUND);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return;
+    }
+
+    baranium_variable_type_t type = var->isVariable ? var->variable->type : var->field->type;
+    baranium_value_t* value = var->isVariable ? &var->variable->value : &var->field->value;
+    size_t* size = var->isVariable ? &var->variable->size : &var->field->size;
+
+    if (type == BARANIUM_VARIABLE_TYPE_VOID || type == BARANIUM_VARIABLE_TYPE_INVALID)
+    {
+        LOGERROR("Variable/Field with ID '%d' cannot be assigned: Invalid type", id);
+        bstack_push(cpu->stack, BARANIUM_ERROR_VAR_INVALID_TYPE);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return;
+    }
+
+    baranium_compiled_variable result = {.type=type, .value=*value, .size=*size};
+    bcpu_apply_immediate(&result, operand, operation);
+
+    *value = result.value;
+    *size = result.size;
+}
+
+// gets the slot of a local of the current function, kills the cpu if there is no such local
+static bstack_slot* bcpu_get_local(bcpu* cpu, uint64_t index)
+{
+    if (index >= cpu->locals->count - cpu->frame)
+    {
+        LOGERROR("Local with index '%lld' not found", index);
+        bstack_push(cpu->stack, BARANIUM_ERROR_VAR_NOT_FOUND);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return NULL;
+    }
+
+    return &cpu->locals->slots[cpu->frame + index];
+}
+
+// gets the slot of a local, verified code only refers to locals inside of its frame so the index isn't checked for it
+static inline bstack_slot* bcpu_local(bcpu* cpu, uint64_t index, uint8_t verified)
+{
+    if (verified)
+        return &cpu->locals->slots[cpu->frame + index];
+
+    return bcpu_get_local(cpu, index);
+}
+
+// instructions whose checks the verifier makes redundant get a second handler `name##_V` that only runs verified code,
+// both share a body that gets whether the code is verified as a constant, see `bverify_code`
+#define BCPU_VERIFIED_VARIANTS(name, body)                                  \
+void name(bcpu* cpu, const bcpu_instruction* instruction)                   \
+{                                                                           \
+    body(cpu, instruction, 0);                                              \
+}                                                                           \
+void name##_V(bcpu* cpu, const bcpu_instruction* instruction)               \
+{                                                                           \
+    body(cpu, instruction, 1);                                              \
+}
+
+// applies an operation with an immediate operand to a local in place, the result keeps the type of the local
+static inline void bcpu_local_apply_immediate(bcpu* cpu, uint64_t index, baranium_compiled_variable* operand, uint8_t operation, uint8_t verified)
+{
+    bstack_slot* slot = bcpu_local(cpu, index, verified);
+    if (slot == NULL)
+        return;
+
+    if (slot->type == BARANIUM_VARIABLE_TYPE_VOID || slot->type == BARANIUM_VARIABLE_TYPE_INVALID)
+    {
+        LOGERROR("Local with index '%lld' cannot be assigned: Invalid type", index);
+        bstack_push(cpu->stack, BARANIUM_ERROR_VAR_INVALID_TYPE);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return;
+    }
+
+    baranium_compiled_variable result = {.type=slot->type, .value={.num64=slot->data}, .size=slot->size};
+    bcpu_apply_immediate(&result, operand, operation);
+
+    slot->data = result.value.num64;
+    slot->size = result.size;
+}
+
+void INCVAR(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
+    baranium_compiled_variable one = {.type=BARANIUM_VARIABLE_TYPE_INT32, .value={.snum32=1}, .size=sizeof(int32_t)};
+    bcpu_variable_apply_immediate(cpu, instruction->operand, &one, BARANIUM_VARIABLE_OPERATION_ADD);
+}
 
-    uint64_t value = cpu->fetch(cpu, 64);
-    bstack_push(cpu->stack, value);
+void DECVAR(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    baranium_compiled_variable one = {.type=BARANIUM_VARIABLE_TYPE_INT32, .value={.snum32=-1}, .size=sizeof(int32_t)};
+    bcpu_variable_apply_immediate(cpu, instruction->operand, &one, BARANIUM_VARIABLE_OPERATION_ADD);
 }
 
-void CALL(bcpu* cpu)
+void ADDVAR_IMM(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
+    baranium_compiled_variable summand = {.type=instruction->type, .value={.num64=instruction->operand2}, .size=baranium_variable_get_size_of_type(instruction->type)};
+    bcpu_variable_apply_immediate(cpu, instruction->operand, &summand, BARANIUM_VARIABLE_OPERATION_ADD);
+}
 
-    uint64_t id = cpu->fetch(cpu, 64);
-    bstack_push(cpu->ip_stack, cpu->ip);
+// the arguments of stack callbacks are handed over as the stack slots themselves
+_Static_assert(sizeof(baranium_callback_argument_t) == sizeof(bstack_slot), "callback arguments have to match the stack slots");
+_Static_assert(offsetof(baranium_callback_argument_t, size) == offsetof(bstack_slot, size), "callback arguments have to match the stack slots");
+_Static_assert(offsetof(baranium_callback_argument_t, type) == offsetof(bstack_slot, type), "callback arguments have to match the stack slots");
+
+// calls a callback with a view of its arguments on the stack, only arguments that don't have the type of the signature get converted
+static void bcpu_call_stack_callback(bcpu* cpu, baranium_callback_list_entry* callback)
+{
+    size_t count = callback->parameter_count;
+    if (cpu->stack->count < count)
+    {
+        LOGERROR("Callback with ID '%lld' expects %zu arguments but only %zu are on the stack", callback->id, count, cpu->stack->count);
+        bstack_push(cpu->stack, BARANIUM_ERROR_VAR_NOT_FOUND);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return;
+    }
+
+    size_t base = cpu->stack->count - count;
+    bstack_slot* slots = cpu->stack->slots + base;
+    for (size_t i = 0; callback->signature != NULL && i < count; i++)
+    {
+        baranium_variable_type_t type = callback->signature[i];
+        if (type == BARANIUM_VARIABLE_TYPE_INVALID || type == BARANIUM_VARIABLE_TYPE_VOID || slots[i].type == type)
+            continue;
+
+        baranium_compiled_variable var = {.type=slots[i].type, .value={.num64=slots[i].data}, .size=slots[i].size};
+        baranium_compiled_variable_convert_to_type(&var, type);
+        slots[i] = (bstack_slot){.data=var.value.num64, .size=var.size, .type=var.type};
+        if (var.type != type)
+        {
+            LOGERROR("Argument %zu of callback with ID '%lld' cannot be converted to the type of the parameter", i, callback->id);
+            bstack_truncate(cpu->stack, base);
+            bstack_push(cpu->stack, BARANIUM_ERROR_VAR_INVALID_TYPE);
+            cpu->flags.FORCED_KILL = 1;
+            cpu->kill_triggered = 1;
+            return;
+        }
+    }
+
+    baranium_callback_stack_view_t args = {.arguments = (const baranium_callback_argument_t*)slots, .count = (int)count};
+    baranium_compiled_variable result = {.type=BARANIUM_VARIABLE_TYPE_VOID, .value={0}, .size=0};
+    callback->stack_callback(&args, &result);
+
+    bstack_truncate(cpu->stack, base);
+    if (result.type != BARANIUM_VARIABLE_TYPE_VOID && result.type != BARANIUM_VARIABLE_TYPE_INVALID)
+        baranium_compiled_variable_push_to_stack(cpu, &result);
+}
+
+void CALL(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    baranium_runtime* runtime = cpu->runtime;
+    uint64_t id = runtime->function_cache->slots[instruction->operand].id;
 
     LOGDEBUG("calling function with id '%lld' (current IP: %lld)", id, cpu->ip);
 
-    baranium_runtime* runtime = baranium_get_runtime();
-    baranium_callback_list_entry* callback = baranium_callback_find_by_id( id);
+    // the cache entry can move while a callback runs, so only the resolved pointers are kept
+    baranium_function_cache_entry* target = baranium_function_cache_get_slot(runtime->function_cache, instruction->operand);
+    baranium_callback_list_entry* callback = target ? target->callback : NULL;
+    baranium_function* func = target ? target->function : NULL;
     LOGDEBUG("callback id: %lld callback ptr: 0x%16.16x", id, (uint64_t)callback);
-    baranium_function* func = baranium_function_manager_get(runtime->function_manager, id);
+
+    if (callback != NULL && callback->stack_callback != NULL)
+    {
+        bcpu_call_stack_callback(cpu, callback);
+        LOGDEBUG("finished calling function with id '%lld' (current IP: %lld)", id, cpu->ip);
+        return;
+    }
 
     if (callback != NULL)
     {
@@ -266,7 +510,7 @@ void CALL(bcpu* cpu)
         if (data.count > 0 && data.count != -1)
         {
             data.data = malloc(sizeof(baranium_value_t)*data.count);
-            data.types = malloc(sizeof(baranium_variable_type_t));
+            data.types = malloc(sizeof(baranium_variable_type_t)*data.count);
 
             baranium_compiled_variable tmp;
             for (int i = 0; i < data.count; i++)
@@ -283,292 +527,506 @@ void CALL(bcpu* cpu)
         {
             for (int i = 0; i < data.count; i++)
                 if (data.types[i] == BARANIUM_VARIABLE_TYPE_STRING)
-                    free(data.data[i].ptr);
+                    bstring_release(data.data[i].ptr);
             free(data.data);
             free(data.types);
         }
+        LOGDEBUG("finished calling function with id '%lld' (current IP: %lld)", id, cpu->ip);
+        return;
     }
-    else
-        baranium_function_call(func, (baranium_function_call_data_t){.count=-1});
 
-    baranium_function_dispose(func);
+    if (func == NULL || func->code == NULL)
+    {
+        LOGERROR("Could not find neither callback nor function for id '%lld'", id);
+        return;
+    }
 
-    cpu->ip = bstack_pop(cpu->ip_stack);
-    LOGDEBUG("finished calling function with id '%lld' (current IP: %lld)", id, cpu->ip);
+    // the callee runs in this same dispatch loop, RET continues with the caller
+    if (!bcpu_push_frame(cpu))
+    {
+        bstack_push(cpu->stack, BARANIUM_ERROR_OUT_OF_MEMORY);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return;
+    }
 
-    if (!func && !callback)
-        LOGERROR("Could not find neither callback nor function for id '%lld'", id);
+    cpu->frame = cpu->locals->count;
+    bcpu_enter_function(cpu, func);
 }
 
-void RET(bcpu* cpu)
+void RET(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
+    if (cpu->kill_triggered)
+        return;
+
+    if (cpu->frame_count > cpu->frame_base)
+    {
+        bcpu_pop_frame(cpu);
+        return;
+    }
 
     cpu->kill_triggered = 1;
 }
 
-void JMP(bcpu* cpu)
+void TAILCALL(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
+    baranium_function_cache_entry* target = baranium_function_cache_get_slot(cpu->runtime->function_cache, instruction->operand);
+    if (target == NULL || target->function == NULL || target->function->code == NULL)
+    {
+        // callbacks don't have a frame that could be reused
+        CALL(cpu, instruction);
+        RET(cpu, instruction);
+        return;
+    }
 
-    uint64_t addr = cpu->fetch(cpu, 64);
-    cpu->ip = addr;
+    // the callee takes over the frame of the current function, its arguments are already on the stack
+    bstack_truncate(cpu->locals, cpu->frame);
+    bcpu_enter_function(cpu, target->function);
 }
 
-void JMPOFF(bcpu* cpu)
+void JMP(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
+    cpu->ip = instruction->target;
+}
 
-    int16_t offset = cpu->fetch(cpu, 16);
-    cpu->ip += offset;
+void JMPOFF(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    cpu->ip = instruction->target;
 }
 
-void JMPC(bcpu* cpu)
+void JMPC(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-    
-    uint64_t addr = cpu->fetch(cpu, 64);
     if (!cpu->flags.CMP) return;
     if (cpu->cv == 0)
         return;
 
-    cpu->ip = addr;
+    cpu->ip = instruction->target;
 }
 
-void JMPCOFF(bcpu* cpu)
+void JMPCOFF(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-    
-    uint16_t offset = cpu->fetch(cpu, 16);
     if (!cpu->flags.CMP) return;
     if (cpu->cv == 0)
         return;
 
-    cpu->ip += offset;
+    cpu->ip = instruction->target;
 }
 
-void MOD(bcpu* cpu)
+void JMPNC(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
+    if (!cpu->flags.CMP) return;
+    if (cpu->cv != 0)
+        return;
 
-    baranium_compiled_variable divisor = {0,{0},0};
-    baranium_compiled_variable divident = {0,{0},0};
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &divisor);
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &divident);
+    cpu->ip = instruction->target;
+}
 
-    baranium_compiled_variable_combine(&divisor, &divident, BARANIUM_VARIABLE_OPERATION_MOD, divisor.type);
+// compares a value with the immediate of a CMPVAR_IMM_JMP/CMPLOCAL_IMM_JMP instruction and jumps if the comparison succeeds
+static void bcpu_compare_immediate_jump(bcpu* cpu, baranium_compiled_variable* val0, const bcpu_instruction* instruction)
+{
+    // leave the flags in the same state as SCF, CCV, PUSHVAR, PUSH, CMP would
+    cpu->flags.CMP = 1;
 
-    baranium_compiled_variable_push_to_stack(cpu, &divisor);
-    if (divident.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(divident.value.ptr);
-    if (divisor.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(divisor.value.ptr);
+    if (val0->type == BARANIUM_VARIABLE_TYPE_INT32 && instruction->type == BARANIUM_VARIABLE_TYPE_INT32)
+    {
+        int32_t value0 = val0->value.snum32;
+        int32_t value1 = (int32_t)instruction->operand2;
+        switch (instruction->method)
+        {
+            case CMP_EQUAL:         cpu->cv = value0 == value1; break;
+            case CMP_NOTEQUAL:      cpu->cv = value0 != value1; break;
+            case CMP_LESS_THAN:     cpu->cv = value0 < value1; break;
+            case CMP_LESS_EQUAL:    cpu->cv = value0 <= value1; break;
+            case CMP_GREATER_THAN:  cpu->cv = value0 > value1; break;
+            case CMP_GREATER_EQUAL: cpu->cv = value0 >= value1; break;
+            default:                cpu->cv = 0; break;
+        }
+    }
+    else
+    {
+        // only the immediate gets converted here, so the variable's own value stays untouched
+        baranium_compiled_variable val1 = {.type=instruction->type, .value={.num64=instruction->operand2}, .size=baranium_variable_get_size_of_type(instruction->type)};
+        cpu->cv = 0;
+        bcpu_compare(cpu, val0, &val1, instruction->method);
+
+        if (val1.type == BARANIUM_VARIABLE_TYPE_STRING)
+            bstring_release(val1.value.ptr);
+    }
+
+    if (cpu->cv)
+        cpu->ip = instruction->target;
 }
 
-void DIV(bcpu* cpu)
+void CMPVAR_IMM_JMP(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
+    index_t id = cpu->runtime->varmgr->slots[instruction->operand].id;
+    bvarmgr_n* var = bvarmgr_get_slot(cpu->runtime->varmgr, instruction->operand);
+    if (var == NULL)
+    {
+        LOGERROR("Variable/Field with ID '%d' not found", id);
+        bstack_push(cpu->stack, BARANIUM_ERROR_VAR_NOT_FOUND);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return;
+    }
 
-    baranium_compiled_variable divisor = {0,{0},0};
-    baranium_compiled_variable divident = {0,{0},0};
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &divisor);
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &divident);
+    baranium_compiled_variable val0 = {0,{0}, 0};
+    if (var->isVariable)
+        val0 = (baranium_compiled_variable){.type=var->variable->type, .value=var->variable->value, .size=var->variable->size};
+    else
+        val0 = (baranium_compiled_variable){.type=var->field->type, .value=var->field->value, .size=var->field->size};
 
-    baranium_compiled_variable_combine(&divisor, &divident, BARANIUM_VARIABLE_OPERATION_DIV, divisor.type);
+    if (val0.type == BARANIUM_VARIABLE_TYPE_VOID || val0.type == BARANIUM_VARIABLE_TYPE_INVALID)
+    {
+        LOGERROR("Variable/Field with ID '%d' cannot be compared: Invalid type", id);
+        bstack_push(cpu->stack, BARANIUM_ERROR_VAR_INVALID_TYPE);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return;
+    }
 
-    baranium_compiled_variable_push_to_stack(cpu, &divisor);
-    if (divident.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(divident.value.ptr);
-    if (divisor.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(divisor.value.ptr);
+    bcpu_compare_immediate_jump(cpu, &val0, instruction);
 }
 
-void MUL(bcpu* cpu)
+void ENTER(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
+    size_t count = instruction->operand;
+    if (!bstack_reserve(cpu->locals, count))
+    {
+        bstack_push(cpu->stack, BARANIUM_ERROR_OUT_OF_MEMORY);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return;
+    }
 
-    baranium_compiled_variable val0 = {0,{0},0};
-    baranium_compiled_variable val1 = {0,{0},0};
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val0);
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val1);
+    memset(cpu->locals->slots + cpu->locals->count, 0, sizeof(bstack_slot)*count);
+    cpu->locals->count += count;
+}
 
-    baranium_compiled_variable_combine(&val0, &val1, BARANIUM_VARIABLE_OPERATION_MUL, val0.type);
+static inline void bcpu_load_local(bcpu* cpu, const bcpu_instruction* instruction, uint8_t verified)
+{
+    bstack_slot* slot = bcpu_local(cpu, instruction->operand, verified);
+    if (slot == NULL)
+        return;
 
-    baranium_compiled_variable_push_to_stack(cpu, &val0);
-    if (val1.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val1.value.ptr);
-    if (val0.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val0.value.ptr);
+    if (slot->type == BARANIUM_VARIABLE_TYPE_VOID || slot->type == BARANIUM_VARIABLE_TYPE_INVALID)
+    {
+        LOGERROR("Local with index '%lld' cannot be pushed: Invalid type", instruction->operand);
+        bstack_push(cpu->stack, BARANIUM_ERROR_VAR_INVALID_TYPE);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return;
+    }
+
+    // strings are shared between the local and the stack
+    if (slot->type == BARANIUM_VARIABLE_TYPE_STRING)
+        bstring_retain((char*)slot->data);
+
+    bstack_push_slot(cpu->stack, *slot);
 }
 
-void SUB(bcpu* cpu)
+static inline void bcpu_store_local(bcpu* cpu, const bcpu_instruction* instruction, uint8_t verified)
 {
-    if (!cpu) return;
+    bstack_slot* slot = bcpu_local(cpu, instruction->operand, verified);
+    if (slot == NULL)
+        return;
 
-    baranium_compiled_variable val0 = {0,{0},0};
-    baranium_compiled_variable val1 = {0,{0},0};
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val0);
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val1);
+    baranium_variable_type_t type = instruction->type;
+    baranium_compiled_variable newvar = {0,{0},0};
+    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &newvar);
+    if (!baranium_variable_type_size_interchangable(type, newvar.type))
+    {
+        LOGERROR("Local with index '%lld' cannot be assigned: Non-matching types of local and assign value", instruction->operand);
+        bstack_push(cpu->stack, BARANIUM_ERROR_VAR_INVALID_TYPE);
+        if (newvar.type == BARANIUM_VARIABLE_TYPE_STRING)
+            bstring_release(newvar.value.ptr);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return;
+    }
+    baranium_compiled_variable_convert_to_type(&newvar, type);
 
-    baranium_compiled_variable_combine(&val0, &val1, BARANIUM_VARIABLE_OPERATION_SUB, val0.type);
+    if (slot->type == BARANIUM_VARIABLE_TYPE_STRING)
+        bstring_release((char*)slot->data);
 
-    baranium_compiled_variable_push_to_stack(cpu, &val0);
-    if (val1.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val1.value.ptr);
-    if (val0.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val0.value.ptr);
+    *slot = (bstack_slot){.data = newvar.value.num64, .size = newvar.size, .type = newvar.type};
 }
 
-void ADD(bcpu* cpu)
+static inline void bcpu_increment_local(bcpu* cpu, const bcpu_instruction* instruction, uint8_t verified)
 {
-    if (!cpu) return;
-
-    baranium_compiled_variable summand2 = {0,{0},0};
-    baranium_compiled_variable summand1 = {0,{0},0};
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &summand2);
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &summand1);
+    baranium_compiled_variable one = {.type=BARANIUM_VARIABLE_TYPE_INT32, .value={.snum32=1}, .size=sizeof(int32_t)};
+    bcpu_local_apply_immediate(cpu, instruction->operand, &one, BARANIUM_VARIABLE_OPERATION_ADD, verified);
+}
 
-    baranium_compiled_variable_combine(&summand2, &summand1, BARANIUM_VARIABLE_OPERATION_ADD, summand2.type);
+static inline void bcpu_decrement_local(bcpu* cpu, const bcpu_instruction* instruction, uint8_t verified)
+{
+    baranium_compiled_variable one = {.type=BARANIUM_VARIABLE_TYPE_INT32, .value={.snum32=-1}, .size=sizeof(int32_t)};
+    bcpu_local_apply_immediate(cpu, instruction->operand, &one, BARANIUM_VARIABLE_OPERATION_ADD, verified);
+}
 
-    baranium_compiled_variable_push_to_stack(cpu, &summand2);
-    if (summand1.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(summand1.value.ptr);
-    if (summand2.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(summand2.value.ptr);
+static inline void bcpu_add_local_immediate(bcpu* cpu, const bcpu_instruction* instruction, uint8_t verified)
+{
+    baranium_compiled_variable summand = {.type=instruction->type, .value={.num64=instruction->operand2}, .size=baranium_variable_get_size_of_type(instruction->type)};
+    bcpu_local_apply_immediate(cpu, instruction->operand, &summand, BARANIUM_VARIABLE_OPERATION_ADD, verified);
 }
 
-void AND(bcpu* cpu)
+static inline void bcpu_compare_local_immediate_jump(bcpu* cpu, const bcpu_instruction* instruction, uint8_t verified)
 {
-    if (!cpu) return;
+    bstack_slot* slot = bcpu_local(cpu, instruction->operand, verified);
+    if (slot == NULL)
+        return;
 
-    baranium_compiled_variable val0 = {0,{0},0};
-    baranium_compiled_variable val1 = {0,{0},0};
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val0);
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val1);
+    if (slot->type == BARANIUM_VARIABLE_TYPE_VOID || slot->type == BARANIUM_VARIABLE_TYPE_INVALID)
+    {
+        LOGERROR("Local with index '%lld' cannot be compared: Invalid type", instruction->operand);
+        bstack_push(cpu->stack, BARANIUM_ERROR_VAR_INVALID_TYPE);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return;
+    }
 
-    baranium_compiled_variable_combine(&val0, &val1, BARANIUM_VARIABLE_OPERATION_AND, val0.type);
+    baranium_compiled_variable val0 = {.type=slot->type, .value={.num64=slot->data}, .size=slot->size};
+    bcpu_compare_immediate_jump(cpu, &val0, instruction);
+}
 
-    baranium_compiled_variable_push_to_stack(cpu, &val0);
-    if (val1.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val1.value.ptr);
-    if (val0.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val0.value.ptr);
+BCPU_VERIFIED_VARIANTS(LOADLOCAL, bcpu_load_local)
+BCPU_VERIFIED_VARIANTS(STORELOCAL, bcpu_store_local)
+BCPU_VERIFIED_VARIANTS(INCLOCAL, bcpu_increment_local)
+BCPU_VERIFIED_VARIANTS(DECLOCAL, bcpu_decrement_local)
+BCPU_VERIFIED_VARIANTS(ADDLOCAL_IMM, bcpu_add_local_immediate)
+BCPU_VERIFIED_VARIANTS(CMPLOCAL_IMM_JMP, bcpu_compare_local_immediate_jump)
+
+static uint8_t bcpu_is_integer_type(baranium_variable_type_t type)
+{
+    return type == BARANIUM_VARIABLE_TYPE_INT32 || type == BARANIUM_VARIABLE_TYPE_UINT32 ||
+           type == BARANIUM_VARIABLE_TYPE_INT8  || type == BARANIUM_VARIABLE_TYPE_UINT8  ||
+           type == BARANIUM_VARIABLE_TYPE_INT16 || type == BARANIUM_VARIABLE_TYPE_UINT16 ||
+           type == BARANIUM_VARIABLE_TYPE_INT64 || type == BARANIUM_VARIABLE_TYPE_UINT64;
 }
 
-void OR(bcpu* cpu)
+// pops the right and then the left operand and pushes `left <operation> right`
+static void bcpu_binary_operation(bcpu* cpu, const bcpu_instruction* instruction, uint8_t operation)
 {
-    if (!cpu) return;
+    bcpu_observe_operands(cpu, instruction);
 
-    baranium_compiled_variable val0 = {0,{0},0};
-    baranium_compiled_variable val1 = {0,{0},0};
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val0);
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val1);
+    baranium_compiled_variable rhs = {0,{0},0};
+    baranium_compiled_variable lhs = {0,{0},0};
+    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &rhs);
+    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &lhs);
 
-    baranium_compiled_variable_combine(&val0, &val1, BARANIUM_VARIABLE_OPERATION_OR, val0.type);
+    // the left operand decides the type, except for integers combined with floating point numbers
+    baranium_variable_type_t type = lhs.type;
+    if ((rhs.type == BARANIUM_VARIABLE_TYPE_FLOAT || rhs.type == BARANIUM_VARIABLE_TYPE_DOUBLE) && bcpu_is_integer_type(lhs.type))
+    {
+        type = rhs.type;
+        baranium_compiled_variable_convert_to_type(&lhs, type);
+    }
 
-    baranium_compiled_variable_push_to_stack(cpu, &val0);
-    if (val1.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val1.value.ptr);
-    if (val0.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val0.value.ptr);
+    baranium_compiled_variable_combine(&lhs, &rhs, operation, type);
+
+    // the result is moved onto the stack, so only the string of the right operand is released
+    bstack_push_slot(cpu->stack, (bstack_slot){.data = lhs.value.num64, .size = lhs.size, .type = lhs.type});
+    if (rhs.type == BARANIUM_VARIABLE_TYPE_STRING)
+        bstring_release(rhs.value.ptr);
 }
 
-void XOR(bcpu* cpu)
+void MOD(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
-    baranium_compiled_variable val0 = {0,{0},0};
-    baranium_compiled_variable val1 = {0,{0},0};
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val0);
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val1);
+    bcpu_binary_operation(cpu, instruction, BARANIUM_VARIABLE_OPERATION_MOD);
+}
 
-    baranium_compiled_variable_combine(&val0, &val1, BARANIUM_VARIABLE_OPERATION_XOR, val0.type);
+void DIV(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    bcpu_binary_operation(cpu, instruction, BARANIUM_VARIABLE_OPERATION_DIV);
+}
 
-    baranium_compiled_variable_push_to_stack(cpu, &val0);
-    if (val1.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val1.value.ptr);
-    if (val0.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val0.value.ptr);
+void MUL(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    bcpu_binary_operation(cpu, instruction, BARANIUM_VARIABLE_OPERATION_MUL);
 }
 
-void SHFTL(bcpu* cpu)
+void SUB(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
+    bcpu_binary_operation(cpu, instruction, BARANIUM_VARIABLE_OPERATION_SUB);
+}
 
-    baranium_compiled_variable val0 = {0,{0},0};
-    baranium_compiled_variable val1 = {0,{0},0};
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val0);
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val1);
+void ADD(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    bcpu_binary_operation(cpu, instruction, BARANIUM_VARIABLE_OPERATION_ADD);
+}
 
-    baranium_compiled_variable_combine(&val0, &val1, BARANIUM_VARIABLE_OPERATION_SHFTL, val0.type);
+void AND(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    bcpu_binary_operation(cpu, instruction, BARANIUM_VARIABLE_OPERATION_AND);
+}
 
-    baranium_compiled_variable_push_to_stack(cpu, &val0);
-    if (val1.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val1.value.ptr);
-    if (val0.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val0.value.ptr);
+void OR(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    bcpu_binary_operation(cpu, instruction, BARANIUM_VARIABLE_OPERATION_OR);
 }
 
-void SHFTR(bcpu* cpu)
+void XOR(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
+    bcpu_binary_operation(cpu, instruction, BARANIUM_VARIABLE_OPERATION_XOR);
+}
 
-    baranium_compiled_variable val0 = {0,{0},0};
-    baranium_compiled_variable val1 = {0,{0},0};
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val0);
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val1);
+void SHFTL(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    bcpu_binary_operation(cpu, instruction, BARANIUM_VARIABLE_OPERATION_SHFTL);
+}
 
-    baranium_compiled_variable_combine(&val0, &val1, BARANIUM_VARIABLE_OPERATION_SHFTR, val0.type);
+void SHFTR(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    bcpu_binary_operation(cpu, instruction, BARANIUM_VARIABLE_OPERATION_SHFTR);
+}
 
-    baranium_compiled_variable_push_to_stack(cpu, &val0);
-    if (val1.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val1.value.ptr);
-    if (val0.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val0.value.ptr);
+// formats a value that isn't a string the same way `baranium_variable_stringify` does, returns the length of the text
+static int bcpu_format_value(char* buffer, size_t size, baranium_variable_type_t type, baranium_value_t value)
+{
+    switch (type)
+    {
+        case BARANIUM_VARIABLE_TYPE_BOOL:   return snprintf(buffer, size, "%s", value.num8 ? "true" : "false");
+        case BARANIUM_VARIABLE_TYPE_OBJECT: return snprintf(buffer, size, "%lld", (long long)value.num64);
+        case BARANIUM_VARIABLE_TYPE_FLOAT:  return snprintf(buffer, size, "%f", value.numfloat);
+        case BARANIUM_VARIABLE_TYPE_DOUBLE: return snprintf(buffer, size, "%f", value.numdouble);
+        case BARANIUM_VARIABLE_TYPE_INT32:  return snprintf(buffer, size, "%d", value.snum32);
+        case BARANIUM_VARIABLE_TYPE_UINT32: return snprintf(buffer, size, "%u", value.num32);
+        case BARANIUM_VARIABLE_TYPE_INT8:   return snprintf(buffer, size, "%d", value.snum8);
+        case BARANIUM_VARIABLE_TYPE_UINT8:  return snprintf(buffer, size, "%u", value.num8);
+        case BARANIUM_VARIABLE_TYPE_INT16:  return snprintf(buffer, size, "%d", value.snum16);
+        case BARANIUM_VARIABLE_TYPE_UINT16: return snprintf(buffer, size, "%u", value.num16);
+        case BARANIUM_VARIABLE_TYPE_INT64:  return snprintf(buffer, size, "%lld", (long long)value.snum64);
+        case BARANIUM_VARIABLE_TYPE_UINT64: return snprintf(buffer, size, "%llu", (unsigned long long)value.num64);
+        default:                            return snprintf(buffer, size, "%s", "");
+    }
 }
 
-void CMP(bcpu* cpu)
+void CONCATN(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-    if (!cpu->flags.CMP) return;
+    size_t count = instruction->operand;
+    if (cpu->stack->count < count)
+    {
+        bstack_push(cpu->stack, BARANIUM_ERROR_VAR_INVALID_TYPE);
+        cpu->flags.FORCED_KILL = 1;
+        cpu->kill_triggered = 1;
+        return;
+    }
 
-    uint8_t operation = cpu->fetch(cpu, 8);
+    // the parts stay on the stack until the result is done, the first part is the deepest one
+    size_t base = cpu->stack->count - count;
+    bstack_slot* parts = cpu->stack->slots + base;
+
+    // everything that isn't a string is formatted into one scratch buffer, one after another and zero terminated
+    char localScratch[0x100];
+    char* scratch = localScratch;
+    size_t scratchCapacity = sizeof(localScratch);
+    size_t scratchSize = 0;
+    size_t length = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (parts[i].type == BARANIUM_VARIABLE_TYPE_STRING)
+        {
+            length += bstring_length((const char*)parts[i].data);
+            continue;
+        }
 
-    baranium_compiled_variable val1 = {0,{0}, 0};
-    baranium_compiled_variable val0 = {0,{0}, 0};
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val1);
-    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val0);
+        baranium_value_t value = {.num64 = parts[i].data};
+        size_t written = bcpu_format_value(scratch + scratchSize, scratchCapacity - scratchSize, parts[i].type, value);
+        if (scratchSize + written >= scratchCapacity)
+        {
+            scratchCapacity = (scratchSize + written + 1) * 2;
+            char* grown = scratch == localScratch ? malloc(scratchCapacity) : realloc(scratch, scratchCapacity);
+            if (grown == NULL)
+                goto outOfMemory;
+            if (scratch == localScratch)
+                memcpy(grown, localScratch, scratchSize);
+            scratch = grown;
+            bcpu_format_value(scratch + scratchSize, scratchCapacity - scratchSize, parts[i].type, value);
+        }
+
+        scratchSize += written + 1;
+        length += written;
+    }
+
+    // the result is sized once and every part is copied into it
+    char* result = bstring_alloc(length);
+    if (result == NULL)
+        goto outOfMemory;
+
+    size_t offset = 0;
+    const char* formatted = scratch;
+    for (size_t i = 0; i < count; i++)
+    {
+        const char* text = formatted;
+        size_t textLength = 0;
+        if (parts[i].type == BARANIUM_VARIABLE_TYPE_STRING)
+        {
+            text = (const char*)parts[i].data;
+            textLength = bstring_length(text);
+        }
+        else
+        {
+            textLength = strlen(formatted);
+            formatted += textLength + 1;
+        }
+
+        memcpy(result + offset, text, textLength);
+        offset += textLength;
+    }
+
+    if (scratch != localScratch)
+        free(scratch);
+
+    bstack_truncate(cpu->stack, base);
+    bstack_push_slot(cpu->stack, (bstack_slot){.data = (uint64_t)result, .size = length, .type = BARANIUM_VARIABLE_TYPE_STRING});
+    return;
 
+outOfMemory:
+    if (scratch != localScratch)
+        free(scratch);
+
+    bstack_push(cpu->stack, BARANIUM_ERROR_OUT_OF_MEMORY);
+    cpu->flags.FORCED_KILL = 1;
+    cpu->kill_triggered = 1;
+}
+
+// compares two values and stores the result in the compare value
+static void bcpu_compare(bcpu* cpu, baranium_compiled_variable* val0, baranium_compiled_variable* val1, uint8_t operation)
+{
     // yes this is a somewhat lazy way but hey, it's somewhat logical as well so shut up
-    if (val1.type == BARANIUM_VARIABLE_TYPE_STRING || val0.type == BARANIUM_VARIABLE_TYPE_STRING)
+    if (val1->type == BARANIUM_VARIABLE_TYPE_STRING || val0->type == BARANIUM_VARIABLE_TYPE_STRING)
     {
-        baranium_compiled_variable_convert_to_type(&val0, BARANIUM_VARIABLE_TYPE_STRING);
-        char* value0 = (char*)val0.value.ptr;
-        baranium_compiled_variable_convert_to_type(&val1, BARANIUM_VARIABLE_TYPE_STRING);
-        char* value1 = (char*)val1.value.ptr;
+        baranium_compiled_variable_convert_to_type(val0, BARANIUM_VARIABLE_TYPE_STRING);
+        char* value0 = (char*)val0->value.ptr;
+        baranium_compiled_variable_convert_to_type(val1, BARANIUM_VARIABLE_TYPE_STRING);
+        char* value1 = (char*)val1->value.ptr;
 
-        if (operation != CMP_EQUAL || operation == CMP_NOTEQUAL)
+        if (operation != CMP_EQUAL && operation != CMP_NOTEQUAL)
         {
-            LOGWARNING("comparing '%s' and '%s' for something that is not == or !=, WTF ARE YOU DOING, ima just default to result 0 just for the operation to still succeed but i highly suggest checking your code please" );
+            LOGWARNING("comparing '%s' and '%s' for something that is not == or !=, WTF ARE YOU DOING, ima just default to result 0 just for the operation to still succeed but i highly suggest checking your code please", value0, value1);
         }
 
+        // shared strings and strings of different lengths are decided without looking at the characters
+        size_t length = bstring_length(value0);
+        uint8_t equal = value0 == value1 || (length == bstring_length(value1) && memcmp(value0, value1, length) == 0);
+
         if (operation == CMP_EQUAL)
         {
-            cpu->cv = (strcmp(value0, value1) == 0) ? 1 : 0;
+            cpu->cv = equal;
             LOGDEBUG("comparing '%s' and '%s' for CMP_EQUAL", value0, value1);
         }
         if (operation == CMP_NOTEQUAL)
         {
-            cpu->cv = (strcmp(value0, value1) == 0) ? 1 : 0;
+            cpu->cv = !equal;
             LOGDEBUG("comparing '%s' and '%s' for CMP_NOTEQUAL", value0, value1);
         }
     }
-    else if (val1.type == BARANIUM_VARIABLE_TYPE_FLOAT || val0.type == BARANIUM_VARIABLE_TYPE_FLOAT)
+    else if (val1->type == BARANIUM_VARIABLE_TYPE_FLOAT || val0->type == BARANIUM_VARIABLE_TYPE_FLOAT)
     {
-        baranium_compiled_variable_convert_to_type(&val0, BARANIUM_VARIABLE_TYPE_FLOAT);
-        float value0 = val0.value.numfloat;
-        baranium_compiled_variable_convert_to_type(&val1, BARANIUM_VARIABLE_TYPE_FLOAT);
-        float value1 = val1.value.numfloat;
+        baranium_compiled_variable_convert_to_type(val0, BARANIUM_VARIABLE_TYPE_FLOAT);
+        float value0 = val0->value.numfloat;
+        baranium_compiled_variable_convert_to_type(val1, BARANIUM_VARIABLE_TYPE_FLOAT);
+        float value1 = val1->value.numfloat;
 
         if (operation == CMP_EQUAL)
         {
@@ -604,10 +1062,10 @@ void CMP(bcpu* cpu)
     else
     {
         ///FIXME: do actual type comparisons and decide which type to use depending on whether one is signed or not
-        baranium_compiled_variable_convert_to_type(&val0, BARANIUM_VARIABLE_TYPE_OBJECT);
-        int64_t value0 = val0.value.snum64;
-        baranium_compiled_variable_convert_to_type(&val1, BARANIUM_VARIABLE_TYPE_OBJECT);
-        int64_t value1 = val1.value.snum64;
+        baranium_compiled_variable_convert_to_type(val0, BARANIUM_VARIABLE_TYPE_OBJECT);
+        int64_t value0 = val0->value.snum64;
+        baranium_compiled_variable_convert_to_type(val1, BARANIUM_VARIABLE_TYPE_OBJECT);
+        int64_t value1 = val1->value.snum64;
 
         if (operation == CMP_EQUAL)
         {
@@ -642,23 +1100,37 @@ void CMP(bcpu* cpu)
     }
 
     LOGDEBUG("comparison result: %u", cpu->cv);
+}
+
+void CMP(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    if (!cpu->flags.CMP) return;
+
+    bcpu_observe_operands(cpu, instruction);
+    uint8_t operation = instruction->method;
+
+    baranium_compiled_variable val1 = {0,{0}, 0};
+    baranium_compiled_variable val0 = {0,{0}, 0};
+    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val1);
+    baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val0);
+
+    bcpu_compare(cpu, &val0, &val1, operation);
 
     if (val1.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val1.value.ptr);
+        bstring_release(val1.value.ptr);
     if (val0.type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(val0.value.ptr);
+        bstring_release(val0.value.ptr);
 }
 
-void CMPC(bcpu* cpu)
+void CMPC(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
     if (!cpu->flags.CMP) return;
 
-    uint8_t operation = cpu->fetch(cpu, 8);
+    uint8_t operation = instruction->method;
 
-    POPCV(cpu);
+    POPCV(cpu, instruction);
     uint8_t val0 = cpu->cv;
-    POPCV(cpu);
+    POPCV(cpu, instruction);
     uint8_t val1 = cpu->cv;
 
     LOGDEBUG("comparing CV{%d} and CV{%d} using %s", val0, val1, operation == CMP_AND ? "CMP_AND" : "CMP_OR");
@@ -671,37 +1143,357 @@ void CMPC(bcpu* cpu)
         cpu->cv = 0;
 }
 
-void MEM(bcpu* cpu)
+// compares the two topmost values and jumps if the comparison succeeds, the compare value is left untouched
+static void bcpu_compare_jump(bcpu* cpu, const bcpu_instruction* instruction, uint8_t operation)
 {
-    if (!cpu) return;
+    uint8_t result = 0;
+    bstack_slot* top = cpu->stack->slots + cpu->stack->count;
+    if (cpu->stack->count >= 2 && top[-2].type == BARANIUM_VARIABLE_TYPE_INT32 && top[-1].type == BARANIUM_VARIABLE_TYPE_INT32)
+    {
+        int32_t value0 = ((baranium_value_t){.num64 = top[-2].data}).snum32;
+        int32_t value1 = ((baranium_value_t){.num64 = top[-1].data}).snum32;
+        switch (operation)
+        {
+            case CMP_EQUAL:         result = value0 == value1; break;
+            case CMP_NOTEQUAL:      result = value0 != value1; break;
+            case CMP_LESS_THAN:     result = value0 < value1; break;
+            case CMP_LESS_EQUAL:    result = value0 <= value1; break;
+            case CMP_GREATER_THAN:  result = value0 > value1; break;
+            case CMP_GREATER_EQUAL: result = value0 >= value1; break;
+            default: break;
+        }
+        cpu->stack->count -= 2;
+    }
+    else
+    {
+        baranium_compiled_variable val1 = {0,{0}, 0};
+        baranium_compiled_variable val0 = {0,{0}, 0};
+        baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val1);
+        baranium_compiled_variable_pop_from_stack_into_variable(cpu, &val0);
+
+        uint8_t cv = cpu->cv;
+        cpu->cv = 0;
+        bcpu_compare(cpu, &val0, &val1, operation);
+        result = cpu->cv;
+        cpu->cv = cv;
+
+        if (val1.type == BARANIUM_VARIABLE_TYPE_STRING)
+            bstring_release(val1.value.ptr);
+        if (val0.type == BARANIUM_VARIABLE_TYPE_STRING)
+            bstring_release(val0.value.ptr);
+    }
 
+    if (result)
+        cpu->ip = instruction->target;
+}
+
+void JEQ(bcpu* cpu, const bcpu_instruction* instruction) { bcpu_compare_jump(cpu, instruction, CMP_EQUAL); }
+void JNE(bcpu* cpu, const bcpu_instruction* instruction) { bcpu_compare_jump(cpu, instruction, CMP_NOTEQUAL); }
+void JLT(bcpu* cpu, const bcpu_instruction* instruction) { bcpu_compare_jump(cpu, instruction, CMP_LESS_THAN); }
+void JLE(bcpu* cpu, const bcpu_instruction* instruction) { bcpu_compare_jump(cpu, instruction, CMP_LESS_EQUAL); }
+void JGT(bcpu* cpu, const bcpu_instruction* instruction) { bcpu_compare_jump(cpu, instruction, CMP_GREATER_THAN); }
+void JGE(bcpu* cpu, const bcpu_instruction* instruction) { bcpu_compare_jump(cpu, instruction, CMP_GREATER_EQUAL); }
+
+// the typed instructions are only emitted when the compiler knows both operands have the type, so they
+// work directly on the inline data of the two topmost slots and keep the type of the left one,
+// the verifier proves that verified code pushed both operands so their presence is only checked otherwise
+#define BCPU_TYPED_OPERANDS(lhs, rhs, verified)                         \
+    if (!(verified) && cpu->stack->count < 2)                           \
+    {                                                                   \
+        bstack_push(cpu->stack, BARANIUM_ERROR_VAR_INVALID_TYPE);       \
+        cpu->flags.FORCED_KILL = 1;                                     \
+        cpu->kill_triggered = 1;                                        \
+        return;                                                         \
+    }                                                                   \
+    bstack_slot* top = cpu->stack->slots + cpu->stack->count;           \
+    baranium_value_t lhs = {.num64 = top[-2].data};                     \
+    baranium_value_t rhs = {.num64 = top[-1].data}
+
+#define BCPU_TYPED_ARITHMETIC_HANDLER(name, verified, field, operator, checkZero) \
+void name(bcpu* cpu, const bcpu_instruction* instruction)               \
+{                                                                       \
+    BCPU_TYPED_OPERANDS(lhs, rhs, verified);                            \
+    if (checkZero && rhs.field == 0)                                    \
+    {                                                                   \
+        bstack_push(cpu->stack, BARANIUM_ERROR_DIV_BY_ZERO);            \
+        cpu->flags.FORCED_KILL = 1;                                     \
+        cpu->kill_triggered = 1;                                        \
+        return;                                                         \
+    }                                                                   \
+    baranium_value_t result = {0};                                      \
+    result.field = lhs.field operator rhs.field;                        \
+    top[-2].data = result.num64;                                        \
+    cpu->stack->count--;                                                \
+}
+
+#define BCPU_TYPED_COMPARE_HANDLER(name, verified, field, operator)     \
+void name(bcpu* cpu, const bcpu_instruction* instruction)               \
+{                                                                       \
+    if (!cpu->flags.CMP) return;                                        \
+    BCPU_TYPED_OPERANDS(lhs, rhs, verified);                            \
+    cpu->cv = lhs.field operator rhs.field;                             \
+    cpu->stack->count -= 2;                                             \
+}
+
+#define BCPU_TYPED_ARITHMETIC(name, field, operator, checkZero)         \
+    BCPU_TYPED_ARITHMETIC_HANDLER(name, 0, field, operator, checkZero)  \
+    BCPU_TYPED_ARITHMETIC_HANDLER(name##_V, 1, field, operator, checkZero)
+
+#define BCPU_TYPED_COMPARE(name, field, operator)                       \
+    BCPU_TYPED_COMPARE_HANDLER(name, 0, field, operator)                \
+    BCPU_TYPED_COMPARE_HANDLER(name##_V, 1, field, operator)
+
+// additions, subtractions and multiplications are done unsigned so overflows wrap around instead of being undefined
+BCPU_TYPED_ARITHMETIC(ADD_I32, num32, +, 0)
+BCPU_TYPED_ARITHMETIC(SUB_I32, num32, -, 0)
+BCPU_TYPED_ARITHMETIC(MUL_I32, num32, *, 0)
+BCPU_TYPED_ARITHMETIC(DIV_I32, snum32, /, 1)
+BCPU_TYPED_ARITHMETIC(MOD_I32, snum32, %, 1)
+
+BCPU_TYPED_ARITHMETIC(ADD_I64, num64, +, 0)
+BCPU_TYPED_ARITHMETIC(SUB_I64, num64, -, 0)
+BCPU_TYPED_ARITHMETIC(MUL_I64, num64, *, 0)
+BCPU_TYPED_ARITHMETIC(DIV_I64, snum64, /, 1)
+BCPU_TYPED_ARITHMETIC(MOD_I64, snum64, %, 1)
+
+BCPU_TYPED_ARITHMETIC(ADD_F32, numfloat, +, 0)
+BCPU_TYPED_ARITHMETIC(SUB_F32, numfloat, -, 0)
+BCPU_TYPED_ARITHMETIC(MUL_F32, numfloat, *, 0)
+BCPU_TYPED_ARITHMETIC(DIV_F32, numfloat, /, 0)
+
+BCPU_TYPED_COMPARE(CMP_EQ_I32, snum32, ==)
+BCPU_TYPED_COMPARE(CMP_NE_I32, snum32, !=)
+BCPU_TYPED_COMPARE(CMP_LT_I32, snum32, <)
+BCPU_TYPED_COMPARE(CMP_LE_I32, snum32, <=)
+BCPU_TYPED_COMPARE(CMP_GT_I32, snum32, >)
+BCPU_TYPED_COMPARE(CMP_GE_I32, snum32, >=)
+
+BCPU_TYPED_COMPARE(CMP_EQ_I64, snum64, ==)
+BCPU_TYPED_COMPARE(CMP_NE_I64, snum64, !=)
+BCPU_TYPED_COMPARE(CMP_LT_I64, snum64, <)
+BCPU_TYPED_COMPARE(CMP_LE_I64, snum64, <=)
+BCPU_TYPED_COMPARE(CMP_GT_I64, snum64, >)
+BCPU_TYPED_COMPARE(CMP_GE_I64, snum64, >=)
+
+BCPU_TYPED_COMPARE(CMP_EQ_F32, numfloat, ==)
+BCPU_TYPED_COMPARE(CMP_NE_F32, numfloat, !=)
+BCPU_TYPED_COMPARE(CMP_LT_F32, numfloat, <)
+BCPU_TYPED_COMPARE(CMP_LE_F32, numfloat, <=)
+BCPU_TYPED_COMPARE(CMP_GT_F32, numfloat, >)
+BCPU_TYPED_COMPARE(CMP_GE_F32, numfloat, >=)
+
+// the register instructions are only emitted when the compiler knows the type of every operand, they work directly on
+// the inline data of the frame slots, `operand` and `operand2` are the operands and `target` is the destination slot
+#define BCPU_REGISTER_SLOT(name, index, verified)                       \
+    bstack_slot* name = bcpu_local(cpu, index, verified);               \
+    if (name == NULL)                                                   \
+        return
+
+#define BCPU_REGISTER_ARITHMETIC_HANDLER(name, verified, resultType, field, operator, checkZero, immediate) \
+void name(bcpu* cpu, const bcpu_instruction* instruction)               \
+{                                                                       \
+    BCPU_REGISTER_SLOT(lhsSlot, instruction->operand, verified);        \
+    baranium_value_t lhs = {.num64 = lhsSlot->data};                    \
+    baranium_value_t rhs = {.num64 = instruction->operand2};            \
+    if (!immediate)                                                     \
+    {                                                                   \
+        BCPU_REGISTER_SLOT(rhsSlot, instruction->operand2, verified);   \
+        rhs.num64 = rhsSlot->data;                                      \
+    }                                                                   \
+    BCPU_REGISTER_SLOT(destination, instruction->target, verified);     \
+    if (checkZero && rhs.field == 0)                                    \
+    {                                                                   \
+        bstack_push(cpu->stack, BARANIUM_ERROR_DIV_BY_ZERO);            \
+        cpu->flags.FORCED_KILL = 1;                                     \
+        cpu->kill_triggered = 1;                                        \
+        return;                                                         \
+    }                                                                   \
+    baranium_value_t result = {0};                                      \
+    result.field = lhs.field operator rhs.field;                        \
+    /* temporaries share their slots with locals of other scopes */     \
+    if (destination->type == BARANIUM_VARIABLE_TYPE_STRING)             \
+        bstring_release((char*)destination->data);                      \
+    *destination = (bstack_slot){.data = result.num64, .size = baranium_variable_get_size_of_type(resultType), .type = resultType}; \
+}
+
+// compares two slots and jumps if the comparison succeeds, the compare value is left untouched like JEQ - JGE do
+#define BCPU_REGISTER_COMPARE_JUMP_HANDLER(name, verified, field)       \
+void name(bcpu* cpu, const bcpu_instruction* instruction)               \
+{                                                                       \
+    BCPU_REGISTER_SLOT(lhsSlot, instruction->operand, verified);        \
+    BCPU_REGISTER_SLOT(rhsSlot, instruction->operand2, verified);       \
+    baranium_value_t lhs = {.num64 = lhsSlot->data};                    \
+    baranium_value_t rhs = {.num64 = rhsSlot->data};                    \
+    uint8_t result = 0;                                                 \
+    switch (instruction->method)                                        \
+    {                                                                   \
+        case CMP_EQUAL:         result = lhs.field == rhs.field; break; \
+        case CMP_NOTEQUAL:      result = lhs.field != rhs.field; break; \
+        case CMP_LESS_THAN:     result = lhs.field < rhs.field; break;  \
+        case CMP_LESS_EQUAL:    result = lhs.field <= rhs.field; break; \
+        case CMP_GREATER_THAN:  result = lhs.field > rhs.field; break;  \
+        case CMP_GREATER_EQUAL: result = lhs.field >= rhs.field; break; \
+        default: break;                                                 \
+    }                                                                   \
+    if (result)                                                         \
+        cpu->ip = instruction->target;                                  \
+}
+
+#define BCPU_REGISTER_ARITHMETIC(name, resultType, field, operator, checkZero, immediate)                 \
+    BCPU_REGISTER_ARITHMETIC_HANDLER(name, 0, resultType, field, operator, checkZero, immediate)        \
+    BCPU_REGISTER_ARITHMETIC_HANDLER(name##_V, 1, resultType, field, operator, checkZero, immediate)
+
+#define BCPU_REGISTER_COMPARE_JUMP(name, field)                         \
+    BCPU_REGISTER_COMPARE_JUMP_HANDLER(name, 0, field)                  \
+    BCPU_REGISTER_COMPARE_JUMP_HANDLER(name##_V, 1, field)
+
+BCPU_REGISTER_ARITHMETIC(ADD_I32_RR, BARANIUM_VARIABLE_TYPE_INT32, num32, +, 0, 0)
+BCPU_REGISTER_ARITHMETIC(SUB_I32_RR, BARANIUM_VARIABLE_TYPE_INT32, num32, -, 0, 0)
+BCPU_REGISTER_ARITHMETIC(MUL_I32_RR, BARANIUM_VARIABLE_TYPE_INT32, num32, *, 0, 0)
+BCPU_REGISTER_ARITHMETIC(DIV_I32_RR, BARANIUM_VARIABLE_TYPE_INT32, snum32, /, 1, 0)
+BCPU_REGISTER_ARITHMETIC(MOD_I32_RR, BARANIUM_VARIABLE_TYPE_INT32, snum32, %, 1, 0)
+
+BCPU_REGISTER_ARITHMETIC(ADD_I64_RR, BARANIUM_VARIABLE_TYPE_INT64, num64, +, 0, 0)
+BCPU_REGISTER_ARITHMETIC(SUB_I64_RR, BARANIUM_VARIABLE_TYPE_INT64, num64, -, 0, 0)
+BCPU_REGISTER_ARITHMETIC(MUL_I64_RR, BARANIUM_VARIABLE_TYPE_INT64, num64, *, 0, 0)
+BCPU_REGISTER_ARITHMETIC(DIV_I64_RR, BARANIUM_VARIABLE_TYPE_INT64, snum64, /, 1, 0)
+BCPU_REGISTER_ARITHMETIC(MOD_I64_RR, BARANIUM_VARIABLE_TYPE_INT64, snum64, %, 1, 0)
+
+BCPU_REGISTER_ARITHMETIC(ADD_F32_RR, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat, +, 0, 0)
+BCPU_REGISTER_ARITHMETIC(SUB_F32_RR, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat, -, 0, 0)
+BCPU_REGISTER_ARITHMETIC(MUL_F32_RR, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat, *, 0, 0)
+BCPU_REGISTER_ARITHMETIC(DIV_F32_RR, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat, /, 0, 0)
+
+BCPU_REGISTER_ARITHMETIC(ADD_I32_RI, BARANIUM_VARIABLE_TYPE_INT32, num32, +, 0, 1)
+BCPU_REGISTER_ARITHMETIC(SUB_I32_RI, BARANIUM_VARIABLE_TYPE_INT32, num32, -, 0, 1)
+BCPU_REGISTER_ARITHMETIC(MUL_I32_RI, BARANIUM_VARIABLE_TYPE_INT32, num32, *, 0, 1)
+BCPU_REGISTER_ARITHMETIC(DIV_I32_RI, BARANIUM_VARIABLE_TYPE_INT32, snum32, /, 1, 1)
+BCPU_REGISTER_ARITHMETIC(MOD_I32_RI, BARANIUM_VARIABLE_TYPE_INT32, snum32, %, 1, 1)
+
+BCPU_REGISTER_ARITHMETIC(ADD_I64_RI, BARANIUM_VARIABLE_TYPE_INT64, num64, +, 0, 1)
+BCPU_REGISTER_ARITHMETIC(SUB_I64_RI, BARANIUM_VARIABLE_TYPE_INT64, num64, -, 0, 1)
+BCPU_REGISTER_ARITHMETIC(MUL_I64_RI, BARANIUM_VARIABLE_TYPE_INT64, num64, *, 0, 1)
+BCPU_REGISTER_ARITHMETIC(DIV_I64_RI, BARANIUM_VARIABLE_TYPE_INT64, snum64, /, 1, 1)
+BCPU_REGISTER_ARITHMETIC(MOD_I64_RI, BARANIUM_VARIABLE_TYPE_INT64, snum64, %, 1, 1)
+
+BCPU_REGISTER_ARITHMETIC(ADD_F32_RI, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat, +, 0, 1)
+BCPU_REGISTER_ARITHMETIC(SUB_F32_RI, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat, -, 0, 1)
+BCPU_REGISTER_ARITHMETIC(MUL_F32_RI, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat, *, 0, 1)
+BCPU_REGISTER_ARITHMETIC(DIV_F32_RI, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat, /, 0, 1)
+
+BCPU_REGISTER_COMPARE_JUMP(JCMP_I32_RR, snum32)
+BCPU_REGISTER_COMPARE_JUMP(JCMP_I64_RR, snum64)
+BCPU_REGISTER_COMPARE_JUMP(JCMP_F32_RR, numfloat)
+
+// the quickened instructions are generic instructions the interpreter specialized after they only saw one operand type,
+// they guard that type and go back to the generic instruction for good once another type shows up
+void PUSHVAR_Q(bcpu* cpu, const bcpu_instruction* instruction)
+{
+    bvarmgr_n* var = bvarmgr_get_slot(cpu->runtime->varmgr, instruction->operand);
+    if (var == NULL || !var->isVariable || var->variable->type != instruction->type)
+    {
+        bcpu_deoptimize(cpu, instruction, 0x07);
+        PUSHVAR(cpu, instruction);
+        return;
+    }
+
+    bstack_slot slot = {.data = 0, .size = var->variable->size, .type = instruction->type};
+    memcpy(&slot.data, &var->variable->value.num64, slot.size < sizeof(uint64_t) ? slot.size : sizeof(uint64_t));
+    bstack_push_slot(cpu->stack, slot);
+}
+
+#define BCPU_QUICKENED_OPERANDS(lhs, rhs, operandType, generic, fallback)  \
+    bstack_slot* top = cpu->stack->slots + cpu->stack->count;               \
+    if (cpu->stack->count < 2 || top[-2].type != operandType ||             \
+        top[-1].type != operandType)                                        \
+    {                                                                       \
+        bcpu_deoptimize(cpu, instruction, generic);                         \
+        fallback(cpu, instruction);                                         \
+        return;                                                             \
+    }                                                                       \
+    baranium_value_t lhs = {.num64 = top[-2].data};                         \
+    baranium_value_t rhs = {.num64 = top[-1].data}
+
+// a division by zero is left to the generic instruction, which reports it
+#define BCPU_QUICKENED_ARITHMETIC(name, generic, fallback, operandType, field, operator, checkZero) \
+void name(bcpu* cpu, const bcpu_instruction* instruction)                   \
+{                                                                           \
+    BCPU_QUICKENED_OPERANDS(lhs, rhs, operandType, generic, fallback);      \
+    if (checkZero && rhs.field == 0)                                        \
+    {                                                                       \
+        fallback(cpu, instruction);                                         \
+        return;                                                             \
+    }                                                                       \
+    baranium_value_t result = {0};                                          \
+    result.field = lhs.field operator rhs.field;                            \
+    top[-2].data = result.num64;                                            \
+    cpu->stack->count--;                                                    \
+}
+
+#define BCPU_QUICKENED_COMPARE(name, operandType, field)                    \
+void name(bcpu* cpu, const bcpu_instruction* instruction)                   \
+{                                                                           \
+    if (!cpu->flags.CMP) return;                                            \
+    BCPU_QUICKENED_OPERANDS(lhs, rhs, operandType, 0x30, CMP);              \
+    switch (instruction->method)                                            \
+    {                                                                       \
+        case CMP_EQUAL:         cpu->cv = lhs.field == rhs.field; break;    \
+        case CMP_NOTEQUAL:      cpu->cv = lhs.field != rhs.field; break;    \
+        case CMP_LESS_THAN:     cpu->cv = lhs.field < rhs.field; break;     \
+        case CMP_LESS_EQUAL:    cpu->cv = lhs.field <= rhs.field; break;    \
+        case CMP_GREATER_THAN:  cpu->cv = lhs.field > rhs.field; break;     \
+        case CMP_GREATER_EQUAL: cpu->cv = lhs.field >= rhs.field; break;    \
+        default: break;                                                     \
+    }                                                                       \
+    cpu->stack->count -= 2;                                                 \
+}
+
+BCPU_QUICKENED_ARITHMETIC(ADD_I32_Q, 0x24, ADD, BARANIUM_VARIABLE_TYPE_INT32, num32, +, 0)
+BCPU_QUICKENED_ARITHMETIC(SUB_I32_Q, 0x23, SUB, BARANIUM_VARIABLE_TYPE_INT32, num32, -, 0)
+BCPU_QUICKENED_ARITHMETIC(MUL_I32_Q, 0x22, MUL, BARANIUM_VARIABLE_TYPE_INT32, num32, *, 0)
+BCPU_QUICKENED_ARITHMETIC(DIV_I32_Q, 0x21, DIV, BARANIUM_VARIABLE_TYPE_INT32, snum32, /, 1)
+BCPU_QUICKENED_ARITHMETIC(MOD_I32_Q, 0x20, MOD, BARANIUM_VARIABLE_TYPE_INT32, snum32, %, 1)
+
+BCPU_QUICKENED_ARITHMETIC(ADD_I64_Q, 0x24, ADD, BARANIUM_VARIABLE_TYPE_INT64, num64, +, 0)
+BCPU_QUICKENED_ARITHMETIC(SUB_I64_Q, 0x23, SUB, BARANIUM_VARIABLE_TYPE_INT64, num64, -, 0)
+BCPU_QUICKENED_ARITHMETIC(MUL_I64_Q, 0x22, MUL, BARANIUM_VARIABLE_TYPE_INT64, num64, *, 0)
+BCPU_QUICKENED_ARITHMETIC(DIV_I64_Q, 0x21, DIV, BARANIUM_VARIABLE_TYPE_INT64, snum64, /, 1)
+BCPU_QUICKENED_ARITHMETIC(MOD_I64_Q, 0x20, MOD, BARANIUM_VARIABLE_TYPE_INT64, snum64, %, 1)
+
+BCPU_QUICKENED_ARITHMETIC(ADD_F32_Q, 0x24, ADD, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat, +, 0)
+BCPU_QUICKENED_ARITHMETIC(SUB_F32_Q, 0x23, SUB, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat, -, 0)
+BCPU_QUICKENED_ARITHMETIC(MUL_F32_Q, 0x22, MUL, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat, *, 0)
+BCPU_QUICKENED_ARITHMETIC(DIV_F32_Q, 0x21, DIV, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat, /, 0)
+
+BCPU_QUICKENED_COMPARE(CMP_I32_Q, BARANIUM_VARIABLE_TYPE_INT32, snum32)
+BCPU_QUICKENED_COMPARE(CMP_I64_Q, BARANIUM_VARIABLE_TYPE_INT64, snum64)
+BCPU_QUICKENED_COMPARE(CMP_F32_Q, BARANIUM_VARIABLE_TYPE_FLOAT, numfloat)
+
+void MEM(bcpu* cpu, const bcpu_instruction* instruction)
+{
     bvarmgr* varmgr = cpu->runtime->varmgr;
 
-    size_t size = cpu->fetch(cpu, 64);
-    baranium_variable_type_t type = cpu->fetch(cpu, 8);
-    index_t id = cpu->fetch(cpu, 64);
+    size_t size = instruction->operand;
+    baranium_variable_type_t type = instruction->type;
+    index_t id = instruction->operand2;
 
     bvarmgr_alloc(varmgr, type, id, size, 0);
 }
 
-void FEM(bcpu* cpu)
+void FEM(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
     bvarmgr* varmgr = cpu->runtime->varmgr;
 
-    index_t id = cpu->fetch(cpu, 64);
+    index_t id = instruction->operand;
     bvarmgr_dealloc(varmgr, id);
 }
 
-void SET(bcpu* cpu)
+void SET(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
     bvarmgr* varmgr = cpu->runtime->varmgr;
 
-    index_t id = cpu->fetch(cpu, 64);
-    size_t size = cpu->fetch(cpu, 64);
+    index_t id = instruction->operand;
+    size_t size = instruction->operand2;
 
     bvarmgr_n* entry = bvarmgr_get(varmgr, id);
     if (!entry)
@@ -721,16 +1513,24 @@ void SET(bcpu* cpu)
         return;
     }
 
-    uint8_t* varData = (uint8_t*)&var->value.num64;
+    // runtime strings may be shared, so a string variable gets a new one instead of being written to
     if (var->type == BARANIUM_VARIABLE_TYPE_STRING)
-        varData = var->value.ptr;
-
-    for (size_t i = 0; i < size; i++)
     {
-        uint8_t fetched = cpu->fetch(cpu, 8);
-        *varData = fetched;
-        varData++;
+        char* str = bstring_create((const char*)cpu->bus->data_holder->data + instruction->target, size);
+        if (str == NULL)
+        {
+            bstack_push(cpu->stack, BARANIUM_ERROR_OUT_OF_MEMORY);
+            cpu->flags.FORCED_KILL = 1;
+            cpu->kill_triggered = 1;
+            return;
+        }
+
+        bstring_release(var->value.ptr);
+        var->value.ptr = str;
+        return;
     }
+
+    memcpy(&var->value.num64, (uint8_t*)cpu->bus->data_holder->data + instruction->target, size);
 }
 
 extern internal_operation_t instantiate_callback;
@@ -738,48 +1538,422 @@ extern internal_operation_t delete_callback;
 extern internal_operation_t attach_callback;
 extern internal_operation_t detach_callback;
 
-void INSTANTIATE(bcpu* cpu)
+void INSTANTIATE(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
     index_t id = bstack_pop(cpu->stack);
     if (instantiate_callback) instantiate_callback(id);
     LOGDEBUG("Object with id '%ld' instantiated", id);
 }
 
-void DELETE(bcpu* cpu)
+void DELETE(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
     index_t id = bstack_pop(cpu->stack);
     if (delete_callback) delete_callback(id);
     LOGDEBUG("Object with id '%ld' deleted", id);
 }
 
-void ATTACH(bcpu* cpu)
+void ATTACH(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
     index_t id = bstack_pop(cpu->stack);
     if (attach_callback) attach_callback(id);
     LOGDEBUG("Attached to object with id '%ld'", id);
 }
 
-void DETACH(bcpu* cpu)
+void DETACH(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
     index_t id = bstack_pop(cpu->stack);
     if (detach_callback) detach_callback(id);
     LOGDEBUG("Detached from object with id '%ld'", id);
 }
 
-void KILL(bcpu* cpu)
+void KILL(bcpu* cpu, const bcpu_instruction* instruction)
 {
-    if (!cpu) return;
-
-    int64_t errorCode = cpu->fetch(cpu, 64);
+    int64_t errorCode = instruction->operand;
     bstack_push(cpu->stack, errorCode);
     cpu->flags.FORCED_KILL = 1;
     cpu->kill_triggered = 1;
 }
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(BARANIUM_NO_THREADED_DISPATCH)
+#   define BCPU_THREADED_DISPATCH 1
+#else
+#   define BCPU_THREADED_DISPATCH 0
+#endif
+
+// opcode, handler, whether the handler can end the execution of the current function
+// (CALL, TAILCALL and RET switch between functions, see BCPU_SWITCHES_FUNCTION)
+#define BCPU_INSTRUCTION_LIST(X) \
+    X(0x00, NOP, 0)              \
+    X(0x01, CCF, 0)              \
+    X(0x02, SCF, 0)              \
+    X(0x03, CCV, 0)              \
+    X(0x04, ICV, 0)              \
+    X(0x05, PUSHCV, 0)           \
+    X(0x06, POPCV, 1)            \
+    X(0x07, PUSHVAR, 1)          \
+    X(0x08, POPVAR, 1)           \
+    X(0x09, PUSH, 0)             \
+    X(0x0A, INCVAR, 1)           \
+    X(0x0B, DECVAR, 1)           \
+    X(0x0C, ADDVAR_IMM, 1)       \
+    X(0x0D, PUSHV, 1)            \
+    X(0x0E, CALL, 1)             \
+    X(0x0F, RET, 1)              \
+    X(0x10, JMP, 0)              \
+    X(0x11, JMPOFF, 0)           \
+    X(0x12, JMPC, 0)             \
+    X(0x13, JMPCOFF, 0)          \
+    X(0x14, CMPVAR_IMM_JMP, 1)   \
+    X(0x15, ENTER, 1)            \
+    X(0x16, LOADLOCAL, 1)        \
+    X(0x17, STORELOCAL, 1)       \
+    X(0x18, INCLOCAL, 1)         \
+    X(0x19, DECLOCAL, 1)         \
+    X(0x1A, ADDLOCAL_IMM, 1)     \
+    X(0x1B, CMPLOCAL_IMM_JMP, 1) \
+    X(0x1C, TAILCALL, 1)         \
+    X(0x1D, JMPNC, 0)            \
+    X(0x20, MOD, 1)              \
+    X(0x21, DIV, 1)              \
+    X(0x22, MUL, 1)              \
+    X(0x23, SUB, 1)              \
+    X(0x24, ADD, 1)              \
+    X(0x25, AND, 1)              \
+    X(0x26, OR, 1)               \
+    X(0x27, XOR, 1)              \
+    X(0x28, SHFTL, 1)            \
+    X(0x29, SHFTR, 1)            \
+    X(0x2A, CONCATN, 1)          \
+    X(0x30, CMP, 1)              \
+    X(0x31, CMPC, 1)             \
+    X(0x32, JEQ, 1)              \
+    X(0x33, JNE, 1)              \
+    X(0x34, JLT, 1)              \
+    X(0x35, JLE, 1)              \
+    X(0x36, JGT, 1)              \
+    X(0x37, JGE, 1)              \
+    X(0x40, ADD_I32, 1)          \
+    X(0x41, SUB_I32, 1)          \
+    X(0x42, MUL_I32, 1)          \
+    X(0x43, DIV_I32, 1)          \
+    X(0x44, MOD_I32, 1)          \
+    X(0x48, ADD_I64, 1)          \
+    X(0x49, SUB_I64, 1)          \
+    X(0x4A, MUL_I64, 1)          \
+    X(0x4B, DIV_I64, 1)          \
+    X(0x4C, MOD_I64, 1)          \
+    X(0x50, ADD_F32, 1)          \
+    X(0x51, SUB_F32, 1)          \
+    X(0x52, MUL_F32, 1)          \
+    X(0x53, DIV_F32, 1)          \
+    X(0x60, CMP_EQ_I32, 1)       \
+    X(0x61, CMP_NE_I32, 1)       \
+    X(0x62, CMP_LT_I32, 1)       \
+    X(0x63, CMP_LE_I32, 1)       \
+    X(0x64, CMP_GT_I32, 1)       \
+    X(0x65, CMP_GE_I32, 1)       \
+    X(0x68, CMP_EQ_I64, 1)       \
+    X(0x69, CMP_NE_I64, 1)       \
+    X(0x6A, CMP_LT_I64, 1)       \
+    X(0x6B, CMP_LE_I64, 1)       \
+    X(0x6C, CMP_GT_I64, 1)       \
+    X(0x6D, CMP_GE_I64, 1)       \
+    X(0x70, CMP_EQ_F32, 1)       \
+    X(0x71, CMP_NE_F32, 1)       \
+    X(0x72, CMP_LT_F32, 1)       \
+    X(0x73, CMP_LE_F32, 1)       \
+    X(0x74, CMP_GT_F32, 1)       \
+    X(0x75, CMP_GE_F32, 1)       \
+    X(0x80, MEM, 1)              \
+    X(0x81, FEM, 1)              \
+    X(0x82, SET, 1)              \
+    X(0x90, PUSHVAR_Q, 1)        \
+    X(0x91, ADD_I32_Q, 1)        \
+    X(0x92, SUB_I32_Q, 1)        \
+    X(0x93, MUL_I32_Q, 1)        \
+    X(0x94, DIV_I32_Q, 1)        \
+    X(0x95, MOD_I32_Q, 1)        \
+    X(0x96, ADD_I64_Q, 1)        \
+    X(0x97, SUB_I64_Q, 1)        \
+    X(0x98, MUL_I64_Q, 1)        \
+    X(0x99, DIV_I64_Q, 1)        \
+    X(0x9A, MOD_I64_Q, 1)        \
+    X(0x9B, ADD_F32_Q, 1)        \
+    X(0x9C, SUB_F32_Q, 1)        \
+    X(0x9D, MUL_F32_Q, 1)        \
+    X(0x9E, DIV_F32_Q, 1)        \
+    X(0x9F, CMP_I32_Q, 1)        \
+    X(0xA0, CMP_I64_Q, 1)        \
+    X(0xA1, CMP_F32_Q, 1)        \
+    X(0xB0, ADD_I32_RR, 1)       \
+    X(0xB1, SUB_I32_RR, 1)       \
+    X(0xB2, MUL_I32_RR, 1)       \
+    X(0xB3, DIV_I32_RR, 1)       \
+    X(0xB4, MOD_I32_RR, 1)       \
+    X(0xB5, ADD_I64_RR, 1)       \
+    X(0xB6, SUB_I64_RR, 1)       \
+    X(0xB7, MUL_I64_RR, 1)       \
+    X(0xB8, DIV_I64_RR, 1)       \
+    X(0xB9, MOD_I64_RR, 1)       \
+    X(0xBA, ADD_F32_RR, 1)       \
+    X(0xBB, SUB_F32_RR, 1)       \
+    X(0xBC, MUL_F32_RR, 1)       \
+    X(0xBD, DIV_F32_RR, 1)       \
+    X(0xBE, ADD_I32_RI, 1)       \
+    X(0xBF, SUB_I32_RI, 1)       \
+    X(0xC0, MUL_I32_RI, 1)       \
+    X(0xC1, DIV_I32_RI, 1)       \
+    X(0xC2, MOD_I32_RI, 1)       \
+    X(0xC3, ADD_I64_RI, 1)       \
+    X(0xC4, SUB_I64_RI, 1)       \
+    X(0xC5, MUL_I64_RI, 1)       \
+    X(0xC6, DIV_I64_RI, 1)       \
+    X(0xC7, MOD_I64_RI, 1)       \
+    X(0xC8, ADD_F32_RI, 1)       \
+    X(0xC9, SUB_F32_RI, 1)       \
+    X(0xCA, MUL_F32_RI, 1)       \
+    X(0xCB, DIV_F32_RI, 1)       \
+    X(0xCC, JCMP_I32_RR, 1)      \
+    X(0xCD, JCMP_I64_RR, 1)      \
+    X(0xCE, JCMP_F32_RR, 1)      \
+    X(0xD0, INSTANTIATE, 1)      \
+    X(0xD1, DELETE, 1)           \
+    X(0xD2, ATTACH, 1)           \
+    X(0xD3, DETACH, 1)           \
+    X(0xFF, KILL, 1)
+
+// handlers that replace the ones of BCPU_INSTRUCTION_LIST for verified code, see BCPU_VERIFIED_VARIANTS
+#define BCPU_VERIFIED_INSTRUCTION_LIST(X) \
+    X(0x16, LOADLOCAL_V, 1)        \
+    X(0x17, STORELOCAL_V, 1)       \
+    X(0x18, INCLOCAL_V, 1)         \
+    X(0x19, DECLOCAL_V, 1)         \
+    X(0x1A, ADDLOCAL_IMM_V, 1)     \
+    X(0x1B, CMPLOCAL_IMM_JMP_V, 1) \
+    X(0x40, ADD_I32_V, 1)          \
+    X(0x41, SUB_I32_V, 1)          \
+    X(0x42, MUL_I32_V, 1)          \
+    X(0x43, DIV_I32_V, 1)          \
+    X(0x44, MOD_I32_V, 1)          \
+    X(0x48, ADD_I64_V, 1)          \
+    X(0x49, SUB_I64_V, 1)          \
+    X(0x4A, MUL_I64_V, 1)          \
+    X(0x4B, DIV_I64_V, 1)          \
+    X(0x4C, MOD_I64_V, 1)          \
+    X(0x50, ADD_F32_V, 1)          \
+    X(0x51, SUB_F32_V, 1)          \
+    X(0x52, MUL_F32_V, 1)          \
+    X(0x53, DIV_F32_V, 1)          \
+    X(0x60, CMP_EQ_I32_V, 1)       \
+    X(0x61, CMP_NE_I32_V, 1)       \
+    X(0x62, CMP_LT_I32_V, 1)       \
+    X(0x63, CMP_LE_I32_V, 1)       \
+    X(0x64, CMP_GT_I32_V, 1)       \
+    X(0x65, CMP_GE_I32_V, 1)       \
+    X(0x68, CMP_EQ_I64_V, 1)       \
+    X(0x69, CMP_NE_I64_V, 1)       \
+    X(0x6A, CMP_LT_I64_V, 1)       \
+    X(0x6B, CMP_LE_I64_V, 1)       \
+    X(0x6C, CMP_GT_I64_V, 1)       \
+    X(0x6D, CMP_GE_I64_V, 1)       \
+    X(0x70, CMP_EQ_F32_V, 1)       \
+    X(0x71, CMP_NE_F32_V, 1)       \
+    X(0x72, CMP_LT_F32_V, 1)       \
+    X(0x73, CMP_LE_F32_V, 1)       \
+    X(0x74, CMP_GT_F32_V, 1)       \
+    X(0x75, CMP_GE_F32_V, 1)       \
+    X(0xB0, ADD_I32_RR_V, 1)       \
+    X(0xB1, SUB_I32_RR_V, 1)       \
+    X(0xB2, MUL_I32_RR_V, 1)       \
+    X(0xB3, DIV_I32_RR_V, 1)       \
+    X(0xB4, MOD_I32_RR_V, 1)       \
+    X(0xB5, ADD_I64_RR_V, 1)       \
+    X(0xB6, SUB_I64_RR_V, 1)       \
+    X(0xB7, MUL_I64_RR_V, 1)       \
+    X(0xB8, DIV_I64_RR_V, 1)       \
+    X(0xB9, MOD_I64_RR_V, 1)       \
+    X(0xBA, ADD_F32_RR_V, 1)       \
+    X(0xBB, SUB_F32_RR_V, 1)       \
+    X(0xBC, MUL_F32_RR_V, 1)       \
+    X(0xBD, DIV_F32_RR_V, 1)       \
+    X(0xBE, ADD_I32_RI_V, 1)       \
+    X(0xBF, SUB_I32_RI_V, 1)       \
+    X(0xC0, MUL_I32_RI_V, 1)       \
+    X(0xC1, DIV_I32_RI_V, 1)       \
+    X(0xC2, MOD_I32_RI_V, 1)       \
+    X(0xC3, ADD_I64_RI_V, 1)       \
+    X(0xC4, SUB_I64_RI_V, 1)       \
+    X(0xC5, MUL_I64_RI_V, 1)       \
+    X(0xC6, DIV_I64_RI_V, 1)       \
+    X(0xC7, MOD_I64_RI_V, 1)       \
+    X(0xC8, ADD_F32_RI_V, 1)       \
+    X(0xC9, SUB_F32_RI_V, 1)       \
+    X(0xCA, MUL_F32_RI_V, 1)       \
+    X(0xCB, DIV_F32_RI_V, 1)       \
+    X(0xCC, JCMP_I32_RR_V, 1)      \
+    X(0xCD, JCMP_I64_RR_V, 1)      \
+    X(0xCE, JCMP_F32_RR_V, 1)
+
+// whether an instruction can continue in another function, the loop has to pick up the new code after it
+#define BCPU_SWITCHES_FUNCTION(opcode) ((opcode) == 0x0E || (opcode) == 0x0F || (opcode) == 0x1C)
+#define BCPU_LOAD_CODE()                                    \
+    {                                                       \
+        code = cpu->bus->data_holder->code->instructions;   \
+        verified = cpu->bus->data_holder->code->verified;   \
+    }
+
+// whether an instruction can set the instruction pointer, a jump backwards counts towards the hotness of the function
+#define BCPU_JUMPS(opcode) (((opcode) >= 0x10 && (opcode) <= 0x14) || (opcode) == 0x1B || (opcode) == 0x1D || ((opcode) >= 0x32 && (opcode) <= 0x37) || ((opcode) >= 0xCC && (opcode) <= 0xCE))
+
+#define BCPU_JUMPED_BACK() (cpu->ip <= (uint64_t)(instruction - code))
+
+// runs the current function as native code if its library was compiled ahead of time or it got hot,
+// returns 1 if the cpu got killed in the meantime
+static uint8_t bcpu_run_native(bcpu* cpu)
+{
+    while (1)
+    {
+        bcode* current = cpu->bus->data_holder->code;
+        uint8_t finished = 0;
+#if BJIT_AVAILABLE
+        bjit_drop_stale(current);
+#endif
+        if (current->aot != NULL)
+            finished = current->aot(cpu, current->instructions, current->verified ? verified_opcodes : opcodes);
+#if BJIT_AVAILABLE
+        else if (current->jit != NULL || (!current->jit_failed && ++current->hotness >= BJIT_HOT_THRESHOLD && bjit_compile(current)))
+            finished = bjit_run(cpu, current);
+#endif
+
+        if (!finished)
+            return 0;
+
+        if (cpu->kill_triggered)
+            return 1;
+    }
+}
+
+#define BCPU_ENTER_NATIVE()             \
+    {                                   \
+        if (bcpu_run_native(cpu))       \
+            return;                     \
+        BCPU_LOAD_CODE();               \
+    }
+
+#define BCPU_TRACE_INSTRUCTION() \
+    LOGDEBUG("IP: 0x%2.16x | Ticks (total): 0x%2.16x | Opcode: 0x%2.2x | Instruction: '%s'", \
+               cpu->ip-1, cpu->ticks, cpu->opcode, opcodes[cpu->opcode].name)
+
+// runs the function attached to the bus until it returns or the cpu gets killed,
+// the caller (`bcpu_run`) has already made sure that there is decoded code to run and
+// every decoded function is terminated by a RET, so there are no checks left inside the loop,
+// verified code runs with the handlers of BCPU_VERIFIED_INSTRUCTION_LIST that leave out the checks of locals and operands
+void bcpu_opcodes_execute(bcpu* cpu)
+{
+    const bcpu_instruction* code = NULL;
+    const bcpu_instruction* instruction = NULL;
+    uint8_t verified = 0;
+    BCPU_LOAD_CODE();
+    BCPU_ENTER_NATIVE();
+
+#if BCPU_THREADED_DISPATCH
+    // the second table is used for verified code
+    static void* dispatch_table[2][MAX_OPCODE_AMOUNT];
+    static bool dispatch_table_initialized = false;
+
+    if (!dispatch_table_initialized)
+    {
+        for (int i = 0; i < MAX_OPCODE_AMOUNT; i++)
+            dispatch_table[0][i] = &&op_INVALID_OPCODE;
+
+#       define X(opcode, name, can_stop) dispatch_table[0][opcode] = &&op_##name;
+        BCPU_INSTRUCTION_LIST(X)
+#       undef X
+
+        memcpy(dispatch_table[1], dispatch_table[0], sizeof(dispatch_table[0]));
+
+#       define X(opcode, name, can_stop) dispatch_table[1][opcode] = &&op_##name;
+        BCPU_VERIFIED_INSTRUCTION_LIST(X)
+#       undef X
+
+        dispatch_table_initialized = true;
+    }
+
+#   define BCPU_DISPATCH()                          \
+    {                                               \
+        instruction = &code[cpu->ip++];             \
+        cpu->opcode = instruction->opcode;          \
+        BCPU_TRACE_INSTRUCTION();                   \
+        goto *dispatch_table[verified][cpu->opcode];\
+    }
+
+    BCPU_DISPATCH();
+
+#   define X(opcode, name, can_stop)                \
+    op_##name:                                      \
+        name(cpu, instruction);                     \
+        cpu->ticks++;                               \
+        if (can_stop && cpu->kill_triggered)        \
+            return;                                 \
+        if (BCPU_SWITCHES_FUNCTION(opcode))         \
+        {                                           \
+            BCPU_LOAD_CODE();                       \
+            BCPU_ENTER_NATIVE();                    \
+        }                                           \
+        else if (BJIT_AVAILABLE && BCPU_JUMPS(opcode) && BCPU_JUMPED_BACK()) \
+            BCPU_ENTER_NATIVE();                    \
+        BCPU_DISPATCH();
+    BCPU_INSTRUCTION_LIST(X)
+    BCPU_VERIFIED_INSTRUCTION_LIST(X)
+#   undef X
+
+op_INVALID_OPCODE:
+    INVALID_OPCODE(cpu, instruction);
+    cpu->ticks++;
+
+#   undef BCPU_DISPATCH
+#else
+    while (!cpu->kill_triggered)
+    {
+        instruction = &code[cpu->ip++];
+        cpu->opcode = instruction->opcode;
+        BCPU_TRACE_INSTRUCTION();
+
+        uint8_t handled = 0;
+        if (verified)
+        {
+            handled = 1;
+            switch (cpu->opcode)
+            {
+#               define X(opcode, name, can_stop) case opcode: name(cpu, instruction); break;
+                BCPU_VERIFIED_INSTRUCTION_LIST(X)
+#               undef X
+                default: handled = 0; break;
+            }
+        }
+
+        if (!handled)
+        {
+            switch (cpu->opcode)
+            {
+#               define X(opcode, name, can_stop) case opcode: name(cpu, instruction); break;
+                BCPU_INSTRUCTION_LIST(X)
+#               undef X
+                default: INVALID_OPCODE(cpu, instruction); break;
+            }
+        }
+
+        cpu->ticks++;
+        if (cpu->kill_triggered)
+            break;
+
+        if (BCPU_SWITCHES_FUNCTION(cpu->opcode))
+        {
+            BCPU_LOAD_CODE();
+            BCPU_ENTER_NATIVE();
+        }
+        else if (BJIT_AVAILABLE && BCPU_JUMPS(cpu->opcode) && BCPU_JUMPED_BACK())
+            BCPU_ENTER_NATIVE();
+    }
+#endif
+}
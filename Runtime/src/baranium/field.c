@@ -1,7 +1,9 @@
 #include <baranium/backend/varmath.h>
+#include <baranium/backend/bstring.h>
 #include <baranium/variable.h>
 #include <baranium/field.h>
 #include <assert.h>
+#include <string.h>
 #include <memory.h>
 #include <stdlib.h>
 
@@ -10,30 +12,25 @@ void baranium_field_set_value(baranium_field* field, baranium_value_t value, bar
     if (field == NULL || type == BARANIUM_VARIABLE_TYPE_INVALID || type == BARANIUM_VARIABLE_TYPE_VOID)
         return;
 
-    size_t size = baranium_variable_get_size_of_type(type);
-    if (type == BARANIUM_VARIABLE_TYPE_STRING)
-        size = strlen(value.str) + 1;
-
     baranium_compiled_variable compiled;
-    compiled.size = size;
+    compiled.size = baranium_variable_get_size_of_type(type);
     compiled.type = type;
     if (type == BARANIUM_VARIABLE_TYPE_STRING)
     {
-        compiled.value.ptr = malloc(size);
-            if (compiled.value.ptr == NULL)
-                return;
+        // the given string belongs to the caller, the field keeps a runtime string of its own
+        compiled.value.ptr = bstring_create(value.str, strlen(value.str));
+        if (compiled.value.ptr == NULL)
+            return;
+        compiled.size = bstring_length(compiled.value.ptr);
     }
-
-    if (type == BARANIUM_VARIABLE_TYPE_STRING)
-        memcpy(compiled.value.ptr, value.ptr, size);
     else
-        memcpy(&compiled.value.num64, &value.num64, size);
+        memcpy(&compiled.value.num64, &value.num64, compiled.size);
 
     if (type != field->type)
         baranium_compiled_variable_convert_to_type(&compiled, field->type);
 
     if (field->type == BARANIUM_VARIABLE_TYPE_STRING)
-        free(field->value.ptr);
+        bstring_release(field->value.ptr);
     field->size = compiled.size;
     field->type = compiled.type;
     field->value = compiled.value;
@@ -50,18 +47,11 @@ baranium_value_t baranium_field_get_value(baranium_field* field, baranium_variab
     baranium_compiled_variable compiled;
     compiled.size = field->size;
     compiled.type = field->type;
+    compiled.value = field->value;
 
-    if (outputType == BARANIUM_VARIABLE_TYPE_STRING)
-    {
-        compiled.value.ptr = malloc(field->size);
-        if (compiled.value.ptr == NULL)
-            return (baranium_value_t){0};
-    }
-
+    // converting away from a string releases it, the field itself still holds on to its string
     if (field->type == BARANIUM_VARIABLE_TYPE_STRING)
-        memcpy(compiled.value.ptr, field->value.ptr, field->size);
-    else
-        compiled.value = field->value;
+        bstring_retain(compiled.value.ptr);
 
     baranium_compiled_variable_convert_to_type(&compiled, outputType);
 
@@ -73,8 +63,8 @@ void baranium_field_dispose(baranium_field* field)
     if (field == NULL)
         return;
 
-    if (field->type == BARANIUM_VARIABLE_TYPE_STRING && field->value.ptr != NULL)
-        free(field->value.ptr);
+    if (field->type == BARANIUM_VARIABLE_TYPE_STRING)
+        bstring_release(field->value.ptr);
 
     free(field);
 }
@@ -1,6 +1,8 @@
 #include <baranium/backend/varmath.h>
+#include <baranium/backend/bstring.h>
 #include <baranium/backend/errors.h>
 #include <baranium/cpu/bstack.h>
+#include <baranium/cpu/bcode.h>
 #include <baranium/function.h>
 #include <baranium/variable.h>
 #include <baranium/defines.h>
@@ -17,11 +19,10 @@ void baranium_function_dispose(baranium_function* function)
     if (function == NULL)
         return;
 
-    if (function->return_data.type == BARANIUM_VARIABLE_TYPE_STRING && function->return_data.value.ptr != NULL)
-        free(function->return_data.value.ptr);
+    if (function->return_data.type == BARANIUM_VARIABLE_TYPE_STRING)
+        bstring_release(function->return_data.value.ptr);
 
-    if (function->data)
-        free(function->data);
+    bcode_dispose(function->code);
 
     free(function);
 }
@@ -32,19 +33,27 @@ void baranium_function_call(baranium_function* function, baranium_function_call_
 
     if (!runtime || !function)
         return;
-    
-    if (runtime->cpu->kill_triggered)
+
+    bcpu* cpu = runtime->cpu;
+    if (cpu->kill_triggered)
         return;
 
     if (function->parameter_count != data.count && data.count != -1)
         return;
 
-    bstack_push(runtime->function_stack, (uint64_t)runtime->cpu->bus->data_holder);
-    bstack_push(runtime->cpu->ip_stack, runtime->cpu->ip);
+    // calls between script functions stay inside of the cpu, only calls into the runtime save the state here,
+    // the caller gets a frame like any other one so that the function cache knows that its code is still needed
+    size_t callerFrameBase = cpu->frame_base;
+    if (!bcpu_push_frame(cpu))
+    {
+        LOGERROR("Could not call function with id %ld, out of memory", function->id);
+        return;
+    }
+    cpu->frame_base = cpu->frame_count;
 
-    runtime->cpu->bus->data_holder = function;
-    runtime->cpu->kill_triggered = 0;
-    runtime->cpu->ip = 0;
+    // the locals of the function are placed in a new frame on top of the caller's one
+    cpu->frame = cpu->locals->count;
+    size_t entryFrame = cpu->frame;
 
     // only works if data.count is greater zero anyways
     baranium_compiled_variable temp = {BARANIUM_VARIABLE_TYPE_INVALID, {0}, 0};
@@ -58,45 +67,46 @@ void baranium_function_call(baranium_function* function, baranium_function_call_
         if (temp.size == (size_t)-1)
             temp.size = strlen((const char*)temp.value.ptr);
 
-        baranium_compiled_variable_push_to_stack(runtime->cpu, &temp);
+        baranium_compiled_variable_push_to_stack(cpu, &temp);
     }
     memset(&temp, 0, sizeof(baranium_compiled_variable));
 
-    while (!runtime->cpu->kill_triggered)
-        bcpu_tick(runtime->cpu);
+    bcpu_enter_function(cpu, function);
+    bcpu_run(cpu);
 
-    if (function->return_data.type != BARANIUM_VARIABLE_TYPE_VOID && function->return_data.type != BARANIUM_VARIABLE_TYPE_INVALID)
+    if (cpu->flags.FORCED_KILL)
     {
-        baranium_compiled_variable* returnValue = baranium_compiled_variable_pop_from_stack(runtime->cpu);
-        if (data.count == -1)
-            baranium_compiled_variable_push_to_stack(runtime->cpu, returnValue);
-
-        function->return_data.value = returnValue->value;
-        function->return_data.type = returnValue->type;
+        uint64_t err = bstack_pop(cpu->stack);
+        LOGERROR("Stack trace:");
+        LOGERROR("\tin function %lld at %lld", cpu->bus->data_holder->id, cpu->ip - 1);
+        for (size_t i = cpu->frame_count; i > cpu->frame_base; --i)
+            LOGERROR("\tcalled from function %lld at %lld", cpu->frames[i-1].function->id, cpu->frames[i-1].ip - 1);
 
-        baranium_compiled_variable_dispose(returnValue);
+        LOGERROR("Exited with code %ld: %s", err, BARANIUM_ERROR_TO_STRING(err));
     }
-
-    if (runtime->cpu->flags.FORCED_KILL)
+    else
     {
-        uint64_t err = bstack_pop(runtime->cpu->stack);
-        LOGERROR("Stack trace:");
-        for (size_t i = runtime->cpu->ip_stack->count; i >= 0; --i)
+        cpu->kill_triggered = 0;
+
+        if (function->return_data.type != BARANIUM_VARIABLE_TYPE_VOID && function->return_data.type != BARANIUM_VARIABLE_TYPE_INVALID)
         {
-            if (i == runtime->cpu->ip_stack->count-1)
-            {
-                LOGERROR("\t%current function called from %lld", runtime->cpu->ip_stack->stackptr[i]);
-                continue;
-            }
+            baranium_compiled_variable returnValue = {BARANIUM_VARIABLE_TYPE_INVALID, {0}, 0};
+            baranium_compiled_variable_pop_from_stack_into_variable(cpu, &returnValue);
+            if (data.count == -1)
+                baranium_compiled_variable_push_reference_to_stack(cpu, &returnValue);
 
-            LOGERROR("%lld called from %lld", runtime->cpu->ip_stack->stackptr[i+1], runtime->cpu->ip_stack->stackptr[i]);
-        }
+            // functions are reused across calls, so the string of the previous call has to go
+            if (function->return_data.type == BARANIUM_VARIABLE_TYPE_STRING)
+                bstring_release(function->return_data.value.ptr);
 
-        LOGERROR("Exited with code %ld: %s", err, BARANIUM_ERROR_TO_STRING(err));
+            function->return_data.value = returnValue.value;
+            function->return_data.type = returnValue.type;
+        }
     }
-    else
-        runtime->cpu->kill_triggered = 0;
 
-    runtime->cpu->ip = bstack_pop(runtime->cpu->ip_stack);
-    runtime->cpu->bus->data_holder = (baranium_function*)bstack_pop(runtime->function_stack);
+    // a kill can leave callees behind, their frames and locals are dropped together with this call
+    cpu->frame_count = cpu->frame_base;
+    cpu->frame = entryFrame;
+    cpu->frame_base = callerFrameBase;
+    bcpu_pop_frame(cpu);
 }
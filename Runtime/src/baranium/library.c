@@ -1,6 +1,14 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_LOADER
+
 #include <baranium/compiler/compiler_context.h>
+#include <baranium/cpu/bcode.h>
+#include <baranium/cpu/baot.h>
+#include <baranium/backend/bfunccache.h>
+#include <baranium/backend/bfilemap.h>
+#include <baranium/backend/bindex.h>
 #include <baranium/backend/bfuncmgr.h>
 #include <baranium/backend/bvarmgr.h>
+#include <baranium/backend/bstring.h>
 #include <baranium/backend/varmath.h>
 #include <baranium/callback.h>
 #include <baranium/variable.h>
@@ -8,6 +16,8 @@
 #include <baranium/logging.h>
 #include <baranium/runtime.h>
 #include <baranium/script.h>
+#include <baranium/version.h>
+#include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
@@ -35,26 +45,32 @@ void baranium_library_dynadd_var_or_field(baranium_library_section* section)
         return;
     }
 
-    baranium_value_t val = {0};
-    void* dataPtr = NULL;
-    if (isField)
-        val = entry->field->value;
-    else
-        val = entry->variable->value;
-
+    // initial strings are stored with their terminating zero, the runtime string only keeps the characters
     if (type == BARANIUM_VARIABLE_TYPE_STRING)
-        dataPtr = val.ptr;
-    else
-        dataPtr = &val.num64;
+    {
+        char* str = bstring_create(data, strnlen(data, size));
+        if (str != NULL)
+        {
+            baranium_value_t* value = isField ? &entry->field->value : &entry->variable->value;
+            bstring_release(value->ptr);
+            value->ptr = str;
+            if (isField)
+                entry->field->size = bstring_length(str);
+            else
+                entry->variable->size = bstring_length(str);
+            return;
+        }
+    }
 
-    if (!dataPtr)
+    baranium_value_t* value = isField ? &entry->field->value : &entry->variable->value;
+    if (type == BARANIUM_VARIABLE_TYPE_STRING || size > sizeof(baranium_value_t))
     {
         LOGERROR("Could not allocate memory for %s with id %ld", isField ? "field" : "variable", id);
         bvarmgr_dealloc(varmgr, id);
         return;
     }
 
-    memcpy(dataPtr, data, size);
+    memcpy(&value->num64, data, size);
 }
 
 void baranium_library_load_section(baranium_library* lib, uint64_t index, baranium_library_section* section)
@@ -76,6 +92,38 @@ void baranium_library_load_section(baranium_library* lib, uint64_t index, barani
 
 void baranium_library_install_callbacks(baranium_library* lib);
 
+// loads every function of the library into the function cache, so that each one is decoded and linked once
+// and callees or globals that don't exist are reported now instead of when they are reached
+void baranium_library_link(baranium_library* lib)
+{
+    baranium_runtime* runtime = baranium_get_runtime();
+    if (runtime == NULL)
+        return;
+
+    // with a code budget functions are only loaded once they are called
+    if (runtime->function_cache->budget != 0)
+        return;
+
+    size_t unresolved = 0;
+    for (uint64_t i = 0; i < lib->libheader.section_count; i++)
+    {
+        baranium_library_section* section = &lib->sections[i];
+        if (section->type != BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS || section->data_size == 0)
+            continue;
+
+        // reporting resolves further slots, so only the function is kept
+        baranium_function_cache_entry* entry = baranium_function_cache_get(runtime->function_cache, section->id);
+        baranium_function* function = entry ? entry->function : NULL;
+        if (function == NULL || function->library != lib)
+            continue;
+
+        unresolved += bcode_report_unresolved(function->code, section->id);
+    }
+
+    if (unresolved != 0)
+        LOGWARNING("Library '%s' has %ld unresolved symbols", lib->name, unresolved);
+}
+
 baranium_library* baranium_library_load(const char* path)
 {
     if (path == NULL)
@@ -121,13 +169,29 @@ baranium_library* baranium_library_load(const char* path)
     }
     LOGDEBUG("library path: '%s'", library->path);
 
-    fread(&library->libheader, 1, sizeof(baranium_library_header), file);
+    // the library is parsed straight out of the image, section data and function code keep pointing into it
+    if (!bfilemap_open(&library->image, file))
+    {
+        LOGERROR("Could not read library '%s'", library->name);
+        free((void*)library->name);
+        free((void*)library->path);
+        free(library);
+        fclose(file);
+        return NULL;
+    }
+
+    const bfilemap* image = &library->image;
+    size_t offset = 0;
+    uint8_t valid = bfilemap_read(image, &offset, &library->libheader, sizeof(baranium_library_header));
 
     LOGDEBUG("read library header");
 
-    if (memcmp(library->libheader.magic, BARANIUM_LIBRARY_HEADER_MAGIC, 4*sizeof(uint8_t)) != 0)
+    if (!valid || memcmp(library->libheader.magic, BARANIUM_LIBRARY_HEADER_MAGIC, 4*sizeof(uint8_t)) != 0)
     {
         LOGERROR("Invalid library header");
+        bfilemap_close(&library->image);
+        free((void*)library->name);
+        free((void*)library->path);
         free(library);
         fclose(file);
         return NULL;
@@ -137,58 +201,83 @@ baranium_library* baranium_library_load(const char* path)
     if (library->libheader.version != BARANIUM_VERSION_CURRENT)
         LOGWARNING("Library '%s' may be out of date, be sure to update your compiler and recompile the library", library->name);
 
-    library->exports = realloc(library->exports, sizeof(baranium_library_export)*library->libheader.exports_count);
+    // every export and section takes at least a few bytes, so larger counts can only come from a broken file
+    if (library->libheader.exports_count > image->size || library->libheader.section_count > image->size)
+    {
+        LOGERROR("Library '%s' is truncated", library->name);
+        library->libheader.exports_count = 0;
+        library->libheader.section_count = 0;
+    }
+
+    // indexed libraries locate their sections and dependencies through the index, older ones are one stream of records
+    uint8_t indexed = library->libheader.version >= BARANIUM_VERSION_INDEXED_FORMAT;
+    if (indexed && (!bfilemap_read(image, &offset, &library->index, sizeof(baranium_binary_index)) ||
+                    !bindex_validate(image, &library->index, library->libheader.section_count)))
+    {
+        LOGERROR("Library '%s' has a broken section directory", library->name);
+        library->libheader.exports_count = 0;
+        library->libheader.section_count = 0;
+        library->index = (baranium_binary_index){.directory_offset=0,.name_table_offset=0,.name_bucket_count=0,.dependency_offset=image->size,.flags=0};
+    }
+
+    library->exports = calloc(library->libheader.exports_count, sizeof(baranium_library_export));
     LOGDEBUG("library has %d exports", library->libheader.exports_count);
-    for (uint64_t i = 0; i < library->libheader.exports_count; i++)
+    for (uint64_t i = 0; library->exports != NULL && i < library->libheader.exports_count; i++)
     {
         baranium_library_export* export = &library->exports[i];
-        fread(&export->type, sizeof(baranium_script_section_type_t), 1, file);
-        fread(&export->id, sizeof(index_t), 1, file);
-        fread(&export->num_params, sizeof(int), 1, file);
-        fread(&export->return_type, sizeof(baranium_variable_type_t), 1, file);
-        fread(&export->symnamelen, sizeof(size_t), 1, file);
+        if (!bfilemap_read(image, &offset, &export->type, sizeof(baranium_script_section_type_t)) ||
+            !bfilemap_read(image, &offset, &export->id, sizeof(index_t)) ||
+            !bfilemap_read(image, &offset, &export->num_params, sizeof(int)) ||
+            !bfilemap_read(image, &offset, &export->return_type, sizeof(baranium_variable_type_t)) ||
+            !bfilemap_read(image, &offset, &export->symnamelen, sizeof(size_t)))
+        {
+            LOGERROR("Library '%s' is truncated", library->name);
+            export->symnamelen = 0;
+            break;
+        }
+
         if (export->symnamelen > 0)
         {
-            export->symname = malloc(export->symnamelen+1);
-            ((char*)export->symname)[export->symnamelen] = 0;
-            fread((void*)export->symname, sizeof(char), export->symnamelen, file);
+            // export names are looked up as strings, so they get the terminating zero the file doesn't store
+            const char* symname = (const char*)bfilemap_view(image, &offset, export->symnamelen);
+            if (symname == NULL)
+            {
+                LOGERROR("Library '%s' is truncated", library->name);
+                export->symnamelen = 0;
+                break;
+            }
+
+            char* name = malloc(export->symnamelen+1);
+            if (name == NULL)
+            {
+                export->symnamelen = 0;
+                continue;
+            }
+
+            memcpy(name, symname, export->symnamelen);
+            name[export->symnamelen] = 0;
+            export->symname = name;
         }
     }
 
     baranium_library_section section;
-    library->sections = realloc(library->sections, sizeof(baranium_library_section)*library->libheader.section_count);
+    library->sections = calloc(library->libheader.section_count, sizeof(baranium_library_section));
     LOGDEBUG("library has %d sections", library->libheader.section_count);
     int runtime_present = baranium_get_runtime() ? 1 : 0;
-    for (uint64_t i = 0; i < library->libheader.section_count; i++)
+    for (uint64_t i = 0; library->sections != NULL && i < library->libheader.section_count; i++)
     {
-        section = (baranium_library_section){.type=0,.id=0,.data_size=0,.data_location=0,.data=NULL};
+        if (!bindex_read_section(image, indexed ? &library->index : NULL, i, &offset, &section))
+        {
+            LOGERROR("Library '%s' is truncated, only %ld of %ld sections were loaded", library->name, i, library->libheader.section_count);
+            break;
+        }
 
-        fread(&section.type, sizeof(uint8_t), 1, file);
-        fread(&section.id, sizeof(index_t), 1, file);
-        fread(&section.data_size, sizeof(uint64_t), 1, file);
         if (section.data_size == 0)
         {
             LOGDEBUG("found a section with a size of 0 (id[0x%x/%lld] type[0x%x/%lld])",section.id,section.id,section.type);
+            library->sections[i] = section;
             continue;
         }
-        if (section.type != BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS)
-        {
-            section.data = malloc(section.data_size);
-            if (!section.data)
-            {
-                fseek(file, section.data_size, SEEK_CUR);
-            }
-            else
-            {
-                memset(section.data, 0, section.data_size);
-                fread(section.data, sizeof(uint8_t), section.data_size, file);
-            }
-        }
-        else
-        {
-            section.data_location = ftell(file);
-            fseek(file, section.data_size, SEEK_CUR);
-        }
 
         library->sections[i] = section;
 
@@ -198,16 +287,27 @@ baranium_library* baranium_library_load(const char* path)
         LOGDEBUG("loaded section %d with id 0x%x and data size 0x%x", i, section.id, section.data_size);
     }
 
+    // sections are looked up by a binary search over their ids
+    if (!indexed)
+        bindex_sort_sections(library->sections, library->libheader.section_count);
+    else
+        offset = library->index.dependency_offset;
+
     size_t dependency_count = 0;
-    fread(&dependency_count, sizeof(size_t), 1, file);
+    bfilemap_read(image, &offset, &dependency_count, sizeof(size_t));
     LOGDEBUG("library has %d dependencies", dependency_count);
     for (size_t i = 0; i < dependency_count; i++)
     {
-        size_t dependencylen = BARANIUM_INVALID_INDEX;
-        char* dependency = NULL;
-        fread(&dependencylen, sizeof(size_t), 1, file);
-        dependency = malloc(dependencylen+1);
-        fread(dependency, sizeof(char), dependencylen, file);
+        size_t dependencylen = 0;
+        if (!bfilemap_read(image, &offset, &dependencylen, sizeof(size_t)))
+            break;
+
+        const char* name = (const char*)bfilemap_view(image, &offset, dependencylen);
+        char* dependency = name ? malloc(dependencylen+1) : NULL;
+        if (dependency == NULL)
+            break;
+
+        memcpy(dependency, name, dependencylen);
         dependency[dependencylen] = 0;
 
         // usually, we won't have both a compiler and a runtime running at the same time, therefore we can just add the library to "both"
@@ -220,6 +320,7 @@ baranium_library* baranium_library_load(const char* path)
 
     // again, only works if a runtime is active
     baranium_library_install_callbacks(library);
+    baranium_library_link(library);
 
     return library;
 }
@@ -260,15 +361,17 @@ void baranium_library_dispose(baranium_library* lib)
         {
             baranium_library_section current = lib->sections[i];
             if (current.type == BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS && baranium_get_runtime())
+            {
                 baranium_function_manager_remove(baranium_get_runtime()->function_manager, current.id);
-
-            if (current.data)
-                free(current.data);
+                baranium_function_cache_remove(baranium_get_runtime()->function_cache, current.id);
+            }
         }
 
         free(lib->sections);
     }
 
+    bfilemap_close(&lib->image);
+
     if (lib->file)
         fclose(lib->file);
 
@@ -280,13 +383,7 @@ baranium_library_section* baranium_library_get_section_by_id_and_type(baranium_l
     if (library == NULL || type == BARANIUM_SCRIPT_SECTION_TYPE_INVALID || id == BARANIUM_INVALID_INDEX)
         return NULL;
 
-    for (uint64_t i = 0; i < library->libheader.section_count; i++)
-    {
-        baranium_library_section current = library->sections[i];
-        if (current.id == id && current.type == type)
-            return library->sections + i;
-    }
-    return NULL;
+    return bindex_find_section(library->sections, library->libheader.section_count, id, type);
 }
 
 index_t baranium_library_get_id_of(baranium_library* library, const char* name)
@@ -294,12 +391,12 @@ index_t baranium_library_get_id_of(baranium_library* library, const char* name)
     if (library == NULL || name == NULL)
         return BARANIUM_INVALID_INDEX;
 
+    if (library->libheader.version >= BARANIUM_VERSION_INDEXED_FORMAT)
+        return bindex_find_name(&library->image, &library->index, name);
+
     index_t id = baranium_get_id_of_name(name);
-    for (uint64_t i = 0; i < library->libheader.section_count; i++)
-    {
-        if (library->sections[i].id == id)
-            return id;
-    }
+    if (bindex_find_section(library->sections, library->libheader.section_count, id, BARANIUM_SCRIPT_SECTION_TYPE_INVALID) != NULL)
+        return id;
 
     return BARANIUM_INVALID_INDEX;
 }
@@ -348,6 +445,30 @@ baranium_field* baranium_library_get_field_by_id(baranium_library* lib, index_t
     return result;
 }
 
+// finds the native body of a function in the dynamic library, bodies generated from other bytecode are ignored
+static bcode_native_entry baranium_library_find_native_body(baranium_library* lib, index_t functionID, const uint8_t* data, size_t size, size_t count)
+{
+    if (lib->aot_table == NULL)
+        return NULL;
+
+    for (uint64_t i = 0; i < lib->aot_table->count; i++)
+    {
+        const baranium_aot_function* function = &lib->aot_table->functions[i];
+        if (function->id != functionID)
+            continue;
+
+        if (function->count != count || function->checksum != bcode_checksum(data, size))
+        {
+            LOGWARNING("Native code of function with id %ld in library '%s' is out of date, interpreting it instead", functionID, lib->name);
+            return NULL;
+        }
+
+        return function->entry;
+    }
+
+    return NULL;
+}
+
 baranium_function* baranium_library_get_function(baranium_library* lib, const char* name)
 {
     index_t id = baranium_library_get_id_of(lib, name);
@@ -361,21 +482,29 @@ baranium_function* baranium_library_get_function_by_id(baranium_library* lib, in
 
     baranium_function* result = NULL;
     baranium_library_section* foundSection = baranium_library_get_section_by_id_and_type(lib, functionID, BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS);
-    if (foundSection == NULL)
+    if (foundSection == NULL || foundSection->data_size < 2)
         return NULL;
 
     result = malloc(sizeof(baranium_function));
     if (!result)
         return NULL;
 
+    // parameter count and return type come before the code, the code itself is decoded right out of the image
+    const uint8_t* data = lib->image.data + foundSection->data_location;
     memset(result, 0, sizeof(baranium_function));
     result->data_size = foundSection->data_size-2;
-    result->data = malloc(foundSection->data_size);
-    memset(result->data, 0, result->data_size);
-    fseek(lib->file, foundSection->data_location, SEEK_SET);
-    fread(&result->parameter_count, sizeof(uint8_t), 1, lib->file);
-    fread(&result->return_data.type, sizeof(uint8_t), 1, lib->file);
-    fread(result->data, 1, result->data_size, lib->file);
+    result->parameter_count = data[0];
+    result->return_data.type = data[1];
+    result->data = (void*)(data + 2);
+    result->code = bcode_decode(result->data, result->data_size, (lib->index.flags & BARANIUM_BINARY_FLAG_REGISTER_CODE) != 0);
+    if (result->code != NULL && !bcode_link(result->code))
+    {
+        LOGERROR("Could not link function with id %ld, out of memory", functionID);
+        bcode_dispose(result->code);
+        result->code = NULL;
+    }
+    if (result->code != NULL)
+        result->code->aot = baranium_library_find_native_body(lib, functionID, result->data, result->data_size, result->code->count);
     result->id = functionID;
     result->library = lib;
 
@@ -398,6 +527,16 @@ void baranium_library_install_callbacks(baranium_library* lib)
     };
     lib->dynlib = baranium_dynlib_load(stringf("%s%s", lib->path, BARANIUM_DYNLIB_EXTENSION), &data);
 
+    // functions that were compiled to C ahead of time, the table has to match the layout this runtime was built with
+    const baranium_aot_table* table = baranium_dynlib_symbol(lib->dynlib, BARANIUM_AOT_TABLE_SYMBOL);
+    if (table != NULL && table->version != BARANIUM_AOT_VERSION)
+        LOGWARNING("Native code of library '%s' was generated for another runtime version, interpreting it instead", lib->name);
+    else if (table != NULL)
+    {
+        lib->aot_table = table;
+        LOGINFO("Library '%s' has native code for %ld functions", lib->name, table->count);
+    }
+
     for (size_t i = 0; i < lib->libheader.exports_count; i++)
     {
         baranium_library_export export = lib->exports[i];
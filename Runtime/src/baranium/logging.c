@@ -23,6 +23,12 @@ static const char* LOG_COLORS[] = {
 // off by default
 static uint8_t logging_debug_messages_enabled = 0;
 
+// every subsystem by default
+static logsubsystem_t logging_debug_subsystems = LOGSUBSYSTEM_ALL;
+
+// effective mask checked by `LOGDEBUG` before formatting anything
+logsubsystem_t logging_debug_mask = 0;
+
 // on by default
 static uint8_t logging_stdout_messages_enabled = 1;
 
@@ -65,9 +71,16 @@ uint8_t log_enable_debug_msgs(uint8_t val)
     if (val != (uint8_t)-1)
         logging_debug_messages_enabled = val;
 
+    logging_debug_mask = logging_debug_messages_enabled ? logging_debug_subsystems : 0;
     return logging_debug_messages_enabled;
 }
 
+void log_set_debug_mask(logsubsystem_t mask)
+{
+    logging_debug_subsystems = mask;
+    logging_debug_mask = logging_debug_messages_enabled ? logging_debug_subsystems : 0;
+}
+
 void log_enable_stdout(uint8_t val)
 {
     logging_stdout_messages_enabled = val;
@@ -1,3 +1,6 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_LOADER
+
+#include <baranium/backend/bfunccache.h>
 #include <baranium/backend/bfuncmgr.h>
 #include <baranium/cpu/bcpu_opcodes.h>
 #include <baranium/backend/bvarmgr.h>
@@ -28,8 +31,8 @@ baranium_runtime* baranium_init_runtime(void)
     memset(runtimeHandle, 0, sizeof(baranium_runtime));
 
     runtimeHandle->cpu = bcpu_init(runtimeHandle);
-    runtimeHandle->function_stack = bstack_init();
     runtimeHandle->function_manager = baranium_function_manager_init();
+    runtimeHandle->function_cache = baranium_function_cache_init();
     runtimeHandle->callbacks = baranium_callback_list_init();
     runtimeHandle->varmgr = bvarmgr_init();
     return runtimeHandle;
@@ -69,6 +72,29 @@ void baranium_runtime_set_library_path(const char* library_path)
     *current_active_runtime->library_dir_contents = baranium_file_util_get_directory_contents(current_active_runtime->library_path, BARANIUM_FILE_UTIL_FILTER_MASK_ALL_FILES);
 }
 
+void baranium_runtime_set_code_budget(size_t budget)
+{
+    if (current_active_runtime == NULL)
+        return;
+
+    baranium_function_cache_set_budget(current_active_runtime->function_cache, budget);
+}
+
+baranium_code_cache_stats baranium_runtime_get_code_cache_stats(void)
+{
+    baranium_code_cache_stats stats = {.hits=0,.misses=0,.evictions=0,.size=0,.budget=0};
+    if (current_active_runtime == NULL || current_active_runtime->function_cache == NULL)
+        return stats;
+
+    baranium_function_cache* cache = current_active_runtime->function_cache;
+    stats.hits = cache->hits;
+    stats.misses = cache->misses;
+    stats.evictions = cache->evictions;
+    stats.size = cache->code_size;
+    stats.budget = cache->budget;
+    return stats;
+}
+
 void baranium_runtime_load_dependency(const char* dependency)
 {
     if (current_active_runtime == NULL)
@@ -145,7 +171,7 @@ void baranium_dispose_runtime(baranium_runtime* runtime)
     }
 
     bcpu_dispose(runtime->cpu);
-    bstack_dispose(runtime->function_stack);
+    baranium_function_cache_dispose(runtime->function_cache);
     baranium_callback_list_dispose(runtime->callbacks);
     baranium_function_manager_dispose(runtime->function_manager);
     bvarmgr_dispose(runtime->varmgr);
@@ -1,11 +1,18 @@
+#define LOG_SUBSYSTEM LOGSUBSYSTEM_LOADER
+
 #include <baranium/defines.h>
 #include <baranium/version.h>
 #if BARANIUM_PLATFORM == BARANIUM_PLATFORM_WINDOWS
 #   pragma warning(disable: 4996)
 #endif
 
+#include <baranium/backend/bfunccache.h>
+#include <baranium/backend/bfilemap.h>
+#include <baranium/backend/bindex.h>
 #include <baranium/backend/bfuncmgr.h>
+#include <baranium/cpu/bcode.h>
 #include <baranium/backend/bvarmgr.h>
+#include <baranium/backend/bstring.h>
 #include <baranium/variable.h>
 #include <baranium/runtime.h>
 #include <baranium/defines.h>
@@ -40,26 +47,32 @@ void baranium_script_dynadd_var_or_field(baranium_script_section* section)
         return;
     }
 
-    baranium_value_t val = {0};
-    void* dataPtr = NULL;
-    if (isField)
-        val = entry->field->value;
-    else
-        val = entry->variable->value;
-
+    // initial strings are stored with their terminating zero, the runtime string only keeps the characters
     if (type == BARANIUM_VARIABLE_TYPE_STRING)
-        dataPtr = val.ptr;
-    else
-        dataPtr = &val.num64;
+    {
+        char* str = bstring_create(data, strnlen(data, size));
+        if (str != NULL)
+        {
+            baranium_value_t* value = isField ? &entry->field->value : &entry->variable->value;
+            bstring_release(value->ptr);
+            value->ptr = str;
+            if (isField)
+                entry->field->size = bstring_length(str);
+            else
+                entry->variable->size = bstring_length(str);
+            return;
+        }
+    }
 
-    if (!dataPtr)
+    baranium_value_t* value = isField ? &entry->field->value : &entry->variable->value;
+    if (type == BARANIUM_VARIABLE_TYPE_STRING || size > sizeof(baranium_value_t))
     {
         LOGERROR("Could not allocate memory for %s with id %ld", isField ? "field" : "variable", id);
         bvarmgr_dealloc(varmgr, id);
         return;
     }
 
-    memcpy(dataPtr, data, size);
+    memcpy(&value->num64, data, size);
 }
 
 void baranium_script_assign_section(baranium_script* script, baranium_script_section* section)
@@ -99,6 +112,38 @@ void baranium_script_append_name_table_entry(baranium_script* script, baranium_s
     script->nametable.name_count++;
 }
 
+// loads every function of the script into the function cache, so that each one is decoded and linked once
+// and callees or globals that don't exist are reported now instead of when they are reached
+void baranium_script_link(baranium_script* script)
+{
+    baranium_runtime* runtime = baranium_get_runtime();
+    if (runtime == NULL)
+        return;
+
+    // with a code budget functions are only loaded once they are called
+    if (runtime->function_cache->budget != 0)
+        return;
+
+    size_t unresolved = 0;
+    for (uint64_t i = 0; i < script->section_count; i++)
+    {
+        baranium_script_section* section = &script->sections[i];
+        if (section->type != BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS || section->data_size == 0)
+            continue;
+
+        // reporting resolves further slots, so only the function is kept
+        baranium_function_cache_entry* entry = baranium_function_cache_get(runtime->function_cache, section->id);
+        baranium_function* function = entry ? entry->function : NULL;
+        if (function == NULL || function->script != script)
+            continue;
+
+        unresolved += bcode_report_unresolved(function->code, section->id);
+    }
+
+    if (unresolved != 0)
+        LOGWARNING("Script has %ld unresolved symbols", unresolved);
+}
+
 ////////////////////////////////
 ///                          ///
 /// public visible functions ///
@@ -113,8 +158,6 @@ baranium_script* baranium_open_script(baranium_handle* handle)
     if (handle->file == NULL)
         return NULL;
 
-    FILE* file = handle->file;
-
     baranium_script* script = malloc(sizeof(baranium_script));
     if (!script)
         return NULL;
@@ -125,10 +168,20 @@ baranium_script* baranium_open_script(baranium_handle* handle)
     script->section_count = 0;
     script->sections = NULL;
 
-    fread(&script->header, 1, sizeof(baranium_script_header), file);
+    // the script is parsed straight out of the image, section data and function code keep pointing into it
+    if (!bfilemap_open(&script->image, handle->file))
+    {
+        free(script);
+        LOGERROR("Could not read script");
+        return NULL;
+    }
 
-    if (memcmp(script->header.magic, BARANIUM_SCRIPT_HEADER_MAGIC, 4*sizeof(uint8_t)) != 0)
+    const bfilemap* image = &script->image;
+    size_t offset = 0;
+    if (!bfilemap_read(image, &offset, &script->header, sizeof(baranium_script_header)) ||
+        memcmp(script->header.magic, BARANIUM_SCRIPT_HEADER_MAGIC, 4*sizeof(uint8_t)) != 0)
     {
+        bfilemap_close(&script->image);
         free(script);
         LOGERROR("Invalid file detected, input was not a valid baranium binary");
         return NULL;
@@ -137,84 +190,111 @@ baranium_script* baranium_open_script(baranium_handle* handle)
     if (script->header.version != BARANIUM_VERSION_CURRENT)
         LOGWARNING("Warning, script may be out of date, be sure to update your compiler and recompile the script");
 
+    // every section takes at least its type, id and size, so a larger count can only come from a broken file
+    if (script->header.section_count > image->size / (sizeof(uint8_t) + sizeof(index_t) + sizeof(uint64_t)))
+    {
+        bfilemap_close(&script->image);
+        free(script);
+        LOGERROR("Script is truncated");
+        return NULL;
+    }
+
+    // indexed binaries locate their sections and dependencies through the index, older ones are one stream of records
+    uint8_t indexed = script->header.version >= BARANIUM_VERSION_INDEXED_FORMAT;
+    if (indexed && (!bfilemap_read(image, &offset, &script->index, sizeof(baranium_binary_index)) ||
+                    !bindex_validate(image, &script->index, script->header.section_count)))
+    {
+        bfilemap_close(&script->image);
+        free(script);
+        LOGERROR("Script has a broken section directory");
+        return NULL;
+    }
+
     baranium_script_section section;
     script->section_count = 0;
     script->section_buffer_size = script->header.section_count;
-    script->sections = malloc(sizeof(baranium_script_section)*script->header.section_count);
+    script->sections = calloc(script->header.section_count, sizeof(baranium_script_section));
     for (uint64_t i = 0; i < script->header.section_count; i++)
     {
-        section = (baranium_script_section){.type=0,.id=0,.data_size=0,.data_location=0,.data=NULL};
+        if (!bindex_read_section(image, indexed ? &script->index : NULL, i, &offset, &section))
+        {
+            LOGERROR("Script is truncated, only %ld of %ld sections were loaded", i, script->header.section_count);
+            break;
+        }
 
-        fread(&section.type, sizeof(uint8_t), 1, file);
-        fread(&section.id, sizeof(index_t), 1, file);
-        fread(&section.data_size, sizeof(uint64_t), 1, file);
         if (section.data_size == 0)
         {
             LOGDEBUG("found a section with a size of 0 (id[0x%x/%lld] type[0x%x/%lld])",section.id,section.id,section.type);
-            script->section_count++;
+            script->sections[script->section_count++] = section;
             continue;
         }
-        if (section.type != BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS)
-        {
-            section.data = malloc(section.data_size);
-            if (!section.data)
-            {
-                fseek(file, section.data_size, SEEK_CUR);
-            }
-            else
-            {
-                memset(section.data, 0, section.data_size);
-                fread(section.data, sizeof(uint8_t), section.data_size, file);
-            }
-        }
-        else
-        {
-            section.data_location = ftell(file);
-            fseek(file, section.data_size, SEEK_CUR);
-        }
 
         baranium_script_assign_section(script, &section);
     }
     script->section_count = script->header.section_count;
 
+    // sections are looked up by a binary search over their ids
+    if (!indexed)
+        bindex_sort_sections(script->sections, script->section_count);
+    else
+        offset = script->index.dependency_offset;
+
     if (script->header.version < BARANIUM_VERSION_THIRD_RELEASE)
     {
-        fread(&script->nametable.name_count, sizeof(uint64_t), 1, file);
+        script->nametable.name_count = 0;
         script->nametable.buffer_size = 0;
         script->nametable.entries = NULL;
+        uint64_t name_count = 0;
+        bfilemap_read(image, &offset, &name_count, sizeof(uint64_t));
         baranium_script_name_table_entry entry;
-        for (uint64_t i = 0; i < script->nametable.name_count; i++)
+        for (uint64_t i = 0; i < name_count; i++)
         {
             entry = (baranium_script_name_table_entry){.length=0,.name=NULL,.id=BARANIUM_INVALID_INDEX};
 
-            fread(&entry.length, sizeof(uint8_t), 1, file);
-            entry.name = malloc(entry.length);
+            if (!bfilemap_read(image, &offset, &entry.length, sizeof(uint8_t)))
+                break;
+
+            const uint8_t* name = bfilemap_view(image, &offset, entry.length);
+            if (name == NULL)
+                break;
+
+            // names are compared as strings, so they get the terminating zero the file doesn't store
+            entry.name = malloc(entry.length + 1);
             if (!entry.name)
                 continue;
 
-            memset(entry.name, 0, entry.length);
-            fread(entry.name, sizeof(uint8_t), entry.length, file);
-            fread(&entry.id, sizeof(index_t), 1, file);
+            memcpy(entry.name, name, entry.length);
+            entry.name[entry.length] = 0;
+            bfilemap_read(image, &offset, &entry.id, sizeof(index_t));
 
             baranium_script_append_name_table_entry(script, &entry);
         }
+        baranium_script_link(script);
         return script;
     }
 
     size_t dependency_count = 0;
-    fread(&dependency_count, sizeof(size_t), 1, file);
+    bfilemap_read(image, &offset, &dependency_count, sizeof(size_t));
     for (size_t i = 0; i < dependency_count; i++)
     {
-        size_t dependencylen = BARANIUM_INVALID_INDEX;
-        char* dependency = NULL;
-        fread(&dependencylen, sizeof(size_t), 1, file);
-        dependency = malloc(dependencylen+1);
-        fread(dependency, sizeof(char), dependencylen, file);
+        size_t dependencylen = 0;
+        if (!bfilemap_read(image, &offset, &dependencylen, sizeof(size_t)))
+            break;
+
+        const char* name = (const char*)bfilemap_view(image, &offset, dependencylen);
+        char* dependency = name ? malloc(dependencylen+1) : NULL;
+        if (dependency == NULL)
+            break;
+
+        memcpy(dependency, name, dependencylen);
         dependency[dependencylen] = 0;
         baranium_runtime_load_dependency(dependency);
         free(dependency);
     }
 
+    // dependencies are loaded now, so every symbol the script uses should be known
+    baranium_script_link(script);
+
     return script;
 }
 
@@ -244,9 +324,10 @@ void baranium_close_script(baranium_script* script)
         {
             baranium_script_section current = script->sections[i];
             if (current.type == BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS)
+            {
                 baranium_function_manager_remove(baranium_get_runtime()->function_manager, current.id);
-
-            free(current.data);
+                baranium_function_cache_remove(baranium_get_runtime()->function_cache, current.id);
+            }
         }
 
         free(script->sections);
@@ -257,6 +338,7 @@ void baranium_close_script(baranium_script* script)
         script->sections = NULL;
     }
 
+    bfilemap_close(&script->image);
     free(script);
 }
 
@@ -264,14 +346,8 @@ baranium_script_section* baranium_script_get_section_by_id_and_type(baranium_scr
 {
     if (script == NULL || type == BARANIUM_SCRIPT_SECTION_TYPE_INVALID || id == BARANIUM_INVALID_INDEX)
         return NULL;
-    
-    for (uint64_t i = 0; i < script->header.section_count; i++)
-    {
-        baranium_script_section current = script->sections[i];
-        if (current.id == id && current.type == type)
-            return script->sections + i;
-    }
-    return NULL;
+
+    return bindex_find_section(script->sections, script->header.section_count, id, type);
 }
 
 index_t baranium_script_get_id_of(baranium_script* script, const char* name)
@@ -286,12 +362,12 @@ index_t baranium_script_get_id_of(baranium_script* script, const char* name)
             return current.id;
     }
 
+    if (script->header.version >= BARANIUM_VERSION_INDEXED_FORMAT)
+        return bindex_find_name(&script->image, &script->index, name);
+
     index_t id = baranium_get_id_of_name(name);
-    for (uint64_t i = 0; i < script->section_count; i++)
-    {
-        if (script->sections[i].id == id)
-            return id;
-    }
+    if (bindex_find_section(script->sections, script->section_count, id, BARANIUM_SCRIPT_SECTION_TYPE_INVALID) != NULL)
+        return id;
 
     return BARANIUM_INVALID_INDEX;
 }
@@ -308,6 +384,9 @@ char* baranium_script_get_name_of(baranium_script* script, index_t id)
             return (char*)current.name;
     }
 
+    if (script->header.version >= BARANIUM_VERSION_INDEXED_FORMAT)
+        return (char*)bindex_name_of(&script->image, &script->index, id);
+
     return NULL;
 }
 
@@ -341,7 +420,12 @@ baranium_variable* baranium_script_get_variable_by_id(baranium_script* script, i
     result->type = *foundSection->data;
     result->size = foundSection->data_size-1;
     if (result->type == BARANIUM_VARIABLE_TYPE_STRING)
-        result->value.ptr = (void*)(((uint8_t*)foundSection->data) + 1);
+    {
+        // the variable is disposed by the caller, so it gets its own runtime string instead of pointing into the section
+        const char* data = (const char*)foundSection->data + 1;
+        result->value.ptr = bstring_create(data, strnlen(data, result->size));
+        result->size = bstring_length(result->value.ptr);
+    }
     else
         memcpy(&result->value.num64, (void*)(((uint8_t*)foundSection->data) + 1), result->size);
 
@@ -390,21 +474,27 @@ baranium_function* baranium_script_get_function_by_id(baranium_script* script, i
 
     baranium_function* result = NULL;
     baranium_script_section* foundSection = baranium_script_get_section_by_id_and_type(script, functionID, BARANIUM_SCRIPT_SECTION_TYPE_FUNCTIONS);
-    if (foundSection == NULL)
+    if (foundSection == NULL || foundSection->data_size < 2)
         return NULL;
 
     result = malloc(sizeof(baranium_function));
     if (!result)
         return NULL;
 
+    // parameter count and return type come before the code, the code itself is decoded right out of the image
+    const uint8_t* data = script->image.data + foundSection->data_location;
     memset(result, 0, sizeof(baranium_function));
     result->data_size = foundSection->data_size-2;
-    result->data = malloc(foundSection->data_size);
-    memset(result->data, 0, result->data_size);
-    fseek(script->handle->file, foundSection->data_location, SEEK_SET);
-    fread(&result->parameter_count, sizeof(uint8_t), 1, script->handle->file);
-    fread(&result->return_data.type, sizeof(uint8_t), 1, script->handle->file);
-    fread(result->data, 1, result->data_size, script->handle->file);
+    result->parameter_count = data[0];
+    result->return_data.type = data[1];
+    result->data = (void*)(data + 2);
+    result->code = bcode_decode(result->data, result->data_size, (script->index.flags & BARANIUM_BINARY_FLAG_REGISTER_CODE) != 0);
+    if (result->code != NULL && !bcode_link(result->code))
+    {
+        LOGERROR("Could not link function with id %ld, out of memory", functionID);
+        bcode_dispose(result->code);
+        result->code = NULL;
+    }
     result->id = functionID;
     result->script = script;
 
@@ -1,4 +1,5 @@
 #include "baranium/defines.h"
+#include <baranium/backend/bstring.h>
 #include <baranium/variable.h>
 #include <baranium/logging.h>
 #include <stdlib.h>
@@ -43,8 +44,8 @@ void baranium_variable_dispose(baranium_variable* variable)
     if (variable == NULL)
         return;
 
-    if (variable->type == BARANIUM_VARIABLE_TYPE_STRING && variable->value.ptr != NULL)
-        free(variable->value.ptr);
+    if (variable->type == BARANIUM_VARIABLE_TYPE_STRING)
+        bstring_release(variable->value.ptr);
 
     free(variable);
 }
@@ -73,79 +73,69 @@ size_t getline(char **buffer, size_t *buffersz, FILE *stream)
 }
 #endif
 
-BARANIUM_CALLBACK_DEFINE(fopen)
+BARANIUM_STACK_CALLBACK_DEFINE(fopen)
 {
-    BARANIUM_CALLBACK_INIT(2, 2);
-    BARANIUM_CALLBACK_GET_VARIABLE_VALUE(char*, filename, NULL, BARANIUM_VARIABLE_TYPE_STRING, 0);
-    BARANIUM_CALLBACK_GET_VARIABLE_VALUE(char*, filemode, NULL, BARANIUM_VARIABLE_TYPE_STRING, 1);
+    const char* filename = BARANIUM_STACK_CALLBACK_ARG(0).str;
+    const char* filemode = BARANIUM_STACK_CALLBACK_ARG(1).str;
 
     FILE* file = NULL;
     if (filename != NULL && filemode != NULL)
         file = fopen(filename, filemode);
 
-    baranium_compiled_variable result = {BARANIUM_VARIABLE_TYPE_OBJECT, {.ptr = file}, baranium_variable_get_size_of_type(BARANIUM_VARIABLE_TYPE_OBJECT)};
-    BARANIUM_CALLBACK_RETURN_VARIABLE(result);
+    *result = (baranium_compiled_variable){BARANIUM_VARIABLE_TYPE_OBJECT, {.ptr = file}, baranium_variable_get_size_of_type(BARANIUM_VARIABLE_TYPE_OBJECT)};
 }
 
-BARANIUM_CALLBACK_DEFINE(fclose)
+BARANIUM_STACK_CALLBACK_DEFINE(fclose)
 {
-    BARANIUM_CALLBACK_INIT(1, 1);
-    BARANIUM_CALLBACK_GET_VARIABLE_VALUE(FILE*, file, NULL, BARANIUM_VARIABLE_TYPE_OBJECT, 0);
+    (void)result;
+    FILE* file = BARANIUM_STACK_CALLBACK_ARG(0).ptr;
 
     if (file)
         fclose(file);
 }
 
-BARANIUM_CALLBACK_DEFINE(fseek)
+BARANIUM_STACK_CALLBACK_DEFINE(fseek)
 {
-    BARANIUM_CALLBACK_INIT(3, 3);
-    BARANIUM_CALLBACK_GET_VARIABLE_VALUE(FILE*, file, NULL, BARANIUM_VARIABLE_TYPE_OBJECT, 0);
-    BARANIUM_CALLBACK_GET_VARIABLE_VALUE(int, off, 0, BARANIUM_VARIABLE_TYPE_INT32, 1);
-    BARANIUM_CALLBACK_GET_VARIABLE_VALUE(int, whence, 0, BARANIUM_VARIABLE_TYPE_INT32, 2);
+    (void)result;
+    FILE* file = BARANIUM_STACK_CALLBACK_ARG(0).ptr;
+    int off = BARANIUM_STACK_CALLBACK_ARG(1).snum32;
+    int whence = BARANIUM_STACK_CALLBACK_ARG(2).snum32;
 
     if (file != NULL)
         fseek(file, off, whence);
 }
 
 
-BARANIUM_CALLBACK_DEFINE(print)
+BARANIUM_STACK_CALLBACK_DEFINE(print)
 {
-    BARANIUM_CALLBACK_INIT(1, 1);
-    BARANIUM_CALLBACK_GET_VARIABLE_VALUE(char*, string, NULL, BARANIUM_VARIABLE_TYPE_STRING, 0);
+    (void)result;
+    const char* string = BARANIUM_STACK_CALLBACK_ARG(0).str;
 
-    printf("%s", string);
+    fwrite(string, 1, bstring_length(string), stdout);
 }
 
-BARANIUM_CALLBACK_DEFINE(log_info)
+BARANIUM_STACK_CALLBACK_DEFINE(log_info)
 {
-    BARANIUM_CALLBACK_INIT(1, 1);
-    BARANIUM_CALLBACK_GET_VARIABLE_VALUE(char*, string, NULL, BARANIUM_VARIABLE_TYPE_STRING, 0);
-
-    LOGINFO(string);
+    (void)result;
+    LOGINFO(BARANIUM_STACK_CALLBACK_ARG(0).str);
 }
 
-BARANIUM_CALLBACK_DEFINE(log_debug)
+BARANIUM_STACK_CALLBACK_DEFINE(log_debug)
 {
-    BARANIUM_CALLBACK_INIT(1, 1);
-    BARANIUM_CALLBACK_GET_VARIABLE_VALUE(char*, string, NULL, BARANIUM_VARIABLE_TYPE_STRING, 0);
-
-    LOGDEBUG(string);
+    (void)result;
+    LOGDEBUG(BARANIUM_STACK_CALLBACK_ARG(0).str);
 }
 
-BARANIUM_CALLBACK_DEFINE(log_error)
+BARANIUM_STACK_CALLBACK_DEFINE(log_error)
 {
-    BARANIUM_CALLBACK_INIT(1, 1);
-    BARANIUM_CALLBACK_GET_VARIABLE_VALUE(char*, string, NULL, BARANIUM_VARIABLE_TYPE_STRING, 0);
-
-    LOGERROR(string);
+    (void)result;
+    LOGERROR(BARANIUM_STACK_CALLBACK_ARG(0).str);
 }
 
-BARANIUM_CALLBACK_DEFINE(log_warning)
+BARANIUM_STACK_CALLBACK_DEFINE(log_warning)
 {
-    BARANIUM_CALLBACK_INIT(1, 1);
-    BARANIUM_CALLBACK_GET_VARIABLE_VALUE(char*, string, NULL, BARANIUM_VARIABLE_TYPE_STRING, 0);
-
-    LOGWARNING(string);
+    (void)result;
+    LOGWARNING(BARANIUM_STACK_CALLBACK_ARG(0).str);
 }
 
 BARANIUM_CALLBACK_DEFINE(input)
@@ -173,63 +163,58 @@ BARANIUM_CALLBACK_DEFINE(input)
     free(buffer);
 }
 
-BARANIUM_CALLBACK_DEFINE(system)
+BARANIUM_STACK_CALLBACK_DEFINE(system)
 {
-    BARANIUM_CALLBACK_INIT(1, 1);
-    BARANIUM_CALLBACK_GET_VARIABLE_VALUE(char*, command, NULL, BARANIUM_VARIABLE_TYPE_STRING, 0);
-
-    system(command);
+    (void)result;
+    system(BARANIUM_STACK_CALLBACK_ARG(0).str);
 }
 
-BARANIUM_CALLBACK_DEFINE(exit)
+BARANIUM_STACK_CALLBACK_DEFINE(exit)
 {
-    BARANIUM_CALLBACK_INIT(0, 0);
+    (void)args;
+    (void)result;
 
     baranium_get_runtime()->cpu->flags.FORCED_KILL = 1;
     baranium_get_runtime()->cpu->kill_triggered = 1;
 }
 
-void baranium_callback_math_function(baranium_callback_data_list_t* data, float(*funcptr)(float))
+static void baranium_callback_math_function(const baranium_callback_stack_view_t* args, baranium_compiled_variable* result, float(*funcptr)(float))
 {
-    BARANIUM_CALLBACK_INIT(1, 1);
-    if (funcptr == NULL)
-        return;
-
-    BARANIUM_CALLBACK_GET_VARIABLE(number, BARANIUM_VARIABLE_TYPE_FLOAT, 0);
-
-    number.value.numfloat = funcptr(number.value.numfloat);
-
-    BARANIUM_CALLBACK_RETURN_VARIABLE(number);
+    float number = BARANIUM_STACK_CALLBACK_ARG(0).numfloat;
+    *result = (baranium_compiled_variable){BARANIUM_VARIABLE_TYPE_FLOAT, {.numfloat = funcptr(number)}, sizeof(float)};
 }
 
-BARANIUM_CALLBACK_DEFINE(sin) { baranium_callback_math_function(data, sinf); }
-BARANIUM_CALLBACK_DEFINE(cos) { baranium_callback_math_function(data, cosf); }
-BARANIUM_CALLBACK_DEFINE(tan) { baranium_callback_math_function(data, tanf); }
-BARANIUM_CALLBACK_DEFINE(asin) { baranium_callback_math_function(data, asinf); }
-BARANIUM_CALLBACK_DEFINE(acos) { baranium_callback_math_function(data, acosf); }
-BARANIUM_CALLBACK_DEFINE(atan) { baranium_callback_math_function(data, atanf); }
-BARANIUM_CALLBACK_DEFINE(log) { baranium_callback_math_function(data, logf); }
-BARANIUM_CALLBACK_DEFINE(log10) { baranium_callback_math_function(data, log10f); }
+BARANIUM_STACK_CALLBACK_DEFINE(sin) { baranium_callback_math_function(args, result, sinf); }
+BARANIUM_STACK_CALLBACK_DEFINE(cos) { baranium_callback_math_function(args, result, cosf); }
+BARANIUM_STACK_CALLBACK_DEFINE(tan) { baranium_callback_math_function(args, result, tanf); }
+BARANIUM_STACK_CALLBACK_DEFINE(asin) { baranium_callback_math_function(args, result, asinf); }
+BARANIUM_STACK_CALLBACK_DEFINE(acos) { baranium_callback_math_function(args, result, acosf); }
+BARANIUM_STACK_CALLBACK_DEFINE(atan) { baranium_callback_math_function(args, result, atanf); }
+BARANIUM_STACK_CALLBACK_DEFINE(log) { baranium_callback_math_function(args, result, logf); }
+BARANIUM_STACK_CALLBACK_DEFINE(log10) { baranium_callback_math_function(args, result, log10f); }
 
 void setup_callbacks(void)
 {
-    BARANIUM_CALLBACK_ADD(fopen, 2);
-    BARANIUM_CALLBACK_ADD(fseek, 3);
-    BARANIUM_CALLBACK_ADD(fclose, 1);
-    BARANIUM_CALLBACK_ADD(log_info, 1);
-    BARANIUM_CALLBACK_ADD(log_debug, 1);
-    BARANIUM_CALLBACK_ADD(log_error, 1);
-    BARANIUM_CALLBACK_ADD(log_warning, 1);
-    BARANIUM_CALLBACK_ADD(print, 1);
+    const baranium_variable_type_t* string = BARANIUM_CALLBACK_SIGNATURE(BARANIUM_VARIABLE_TYPE_STRING);
+    const baranium_variable_type_t* number = BARANIUM_CALLBACK_SIGNATURE(BARANIUM_VARIABLE_TYPE_FLOAT);
+
+    BARANIUM_STACK_CALLBACK_ADD(fopen, 2, BARANIUM_CALLBACK_SIGNATURE(BARANIUM_VARIABLE_TYPE_STRING, BARANIUM_VARIABLE_TYPE_STRING));
+    BARANIUM_STACK_CALLBACK_ADD(fseek, 3, BARANIUM_CALLBACK_SIGNATURE(BARANIUM_VARIABLE_TYPE_OBJECT, BARANIUM_VARIABLE_TYPE_INT32, BARANIUM_VARIABLE_TYPE_INT32));
+    BARANIUM_STACK_CALLBACK_ADD(fclose, 1, BARANIUM_CALLBACK_SIGNATURE(BARANIUM_VARIABLE_TYPE_OBJECT));
+    BARANIUM_STACK_CALLBACK_ADD(log_info, 1, string);
+    BARANIUM_STACK_CALLBACK_ADD(log_debug, 1, string);
+    BARANIUM_STACK_CALLBACK_ADD(log_error, 1, string);
+    BARANIUM_STACK_CALLBACK_ADD(log_warning, 1, string);
+    BARANIUM_STACK_CALLBACK_ADD(print, 1, string);
     BARANIUM_CALLBACK_ADD(input, 0);
-    BARANIUM_CALLBACK_ADD(system, 1);
-    BARANIUM_CALLBACK_ADD(exit, 1);
-    BARANIUM_CALLBACK_ADD(sin, 1);
-    BARANIUM_CALLBACK_ADD(cos, 1);
-    BARANIUM_CALLBACK_ADD(tan, 1);
-    BARANIUM_CALLBACK_ADD(asin, 1);
-    BARANIUM_CALLBACK_ADD(acos, 1);
-    BARANIUM_CALLBACK_ADD(atan, 1);
-    BARANIUM_CALLBACK_ADD(log, 1);
-    BARANIUM_CALLBACK_ADD(log10, 1);
+    BARANIUM_STACK_CALLBACK_ADD(system, 1, string);
+    BARANIUM_STACK_CALLBACK_ADD(exit, 0, NULL);
+    BARANIUM_STACK_CALLBACK_ADD(sin, 1, number);
+    BARANIUM_STACK_CALLBACK_ADD(cos, 1, number);
+    BARANIUM_STACK_CALLBACK_ADD(tan, 1, number);
+    BARANIUM_STACK_CALLBACK_ADD(asin, 1, number);
+    BARANIUM_STACK_CALLBACK_ADD(acos, 1, number);
+    BARANIUM_STACK_CALLBACK_ADD(atan, 1, number);
+    BARANIUM_STACK_CALLBACK_ADD(log, 1, number);
+    BARANIUM_STACK_CALLBACK_ADD(log10, 1, number);
 }
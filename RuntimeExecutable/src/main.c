@@ -8,6 +8,7 @@
 #include <baranium/script.h>
 #include <argument_parser.h>
 #include <string.h>
+#include <stdlib.h>
 #include <stdio.h>
 
 #if BARANIUM_PLATFORM == BARANIUM_PLATFORM_APPLE
@@ -41,6 +42,42 @@ void print_help_message(void)
     printf("\t-v/--version:\t\t\tShow the version of the runtime\n");
     printf("\t-stdout/--enable-stdout:\tShow the version of the runtime\n");
     printf("\t-d/--debug:\t\t\tEnable debug messages\n");
+    printf("\t-ds/--debug-subsystems <list>:\tOnly show debug messages of the comma separated subsystems (general, cpu, varmgr, loader, compiler)\n");
+    printf("\t-cb/--code-budget <bytes>:\tLoad functions on their first call and keep at most this many bytes of decoded code\n");
+}
+
+logsubsystem_t parse_debug_subsystems(const char* list)
+{
+    static const struct { const char* name; logsubsystem_t subsystem; } subsystems[] = {
+        {"general", LOGSUBSYSTEM_GENERAL},
+        {"cpu", LOGSUBSYSTEM_CPU},
+        {"varmgr", LOGSUBSYSTEM_VARMGR},
+        {"loader", LOGSUBSYSTEM_LOADER},
+        {"compiler", LOGSUBSYSTEM_COMPILER},
+    };
+
+    logsubsystem_t mask = 0;
+    while (*list)
+    {
+        size_t length = strcspn(list, ",");
+        size_t i = 0;
+        for (; i < sizeof(subsystems) / sizeof(subsystems[0]); i++)
+        {
+            if (strlen(subsystems[i].name) == length && strncmp(subsystems[i].name, list, length) == 0)
+            {
+                mask |= subsystems[i].subsystem;
+                break;
+            }
+        }
+        if (i == sizeof(subsystems) / sizeof(subsystems[0]))
+            LOGWARNING("Unknown debug subsystem '%.*s'", (int)length, list);
+
+        list += length;
+        if (*list == ',')
+            list++;
+    }
+
+    return mask;
 }
 
 char* get_executable_working_directory(void)
@@ -81,6 +118,8 @@ int main(int argc, const char** argv)
     argument_parser_init(&parser);
     argument_parser_add(&parser, ARGUMENT_TYPE_FLAG, "-h", "--help");
     argument_parser_add(&parser, ARGUMENT_TYPE_FLAG, "-d", "--debug");
+    argument_parser_add(&parser, ARGUMENT_TYPE_VALUE, "-ds", "--debug-subsystems");
+    argument_parser_add(&parser, ARGUMENT_TYPE_VALUE, "-cb", "--code-budget");
     argument_parser_add(&parser, ARGUMENT_TYPE_FLAG, "-stdout", "--enable-stdout");
     argument_parser_add(&parser, ARGUMENT_TYPE_FLAG, "-v", "--version");
     argument_parser_parse(&parser, argc, argv);
@@ -110,6 +149,10 @@ int main(int argc, const char** argv)
     if (debug_mode_enabled)
         LOGINFO("Debug messages enabled");
 
+    argument_t* debugSubsystems = argument_parser_get(&parser, "-ds");
+    if (debugSubsystems != NULL && debugSubsystems->value_count > 0)
+        log_set_debug_mask(parse_debug_subsystems(debugSubsystems->values[0]));
+
     if (parser.unparsed.size != 1)
     {
         print_help_message();
@@ -121,10 +164,14 @@ int main(int argc, const char** argv)
     }
 
     const char* filePath = parser.unparsed.data[0].values[0];
+    argument_t* codeBudget = argument_parser_get(&parser, "-cb");
+    size_t budget = (codeBudget != NULL && codeBudget->value_count > 0) ? strtoull(codeBudget->values[0], NULL, 10) : 0;
     argument_parser_dispose(&parser);
 
     baranium_runtime* runtime = baranium_init_runtime();
     baranium_set_runtime(runtime);
+    if (budget != 0)
+        baranium_runtime_set_code_budget(budget);
 
     char* executableFilePath = get_executable_working_directory();
     size_t executableFilePathLastSeperatorIndex = strlen(executableFilePath)-1;
@@ -163,6 +210,13 @@ int main(int argc, const char** argv)
     baranium_function_dispose(main);
 
 end:
+    if (debug_mode_enabled)
+    {
+        baranium_code_cache_stats stats = baranium_runtime_get_code_cache_stats();
+        LOGINFO("Code cache: %llu hits, %llu misses, %llu evictions, %zu of %zu bytes",
+                (unsigned long long)stats.hits, (unsigned long long)stats.misses, (unsigned long long)stats.evictions, stats.size, stats.budget);
+    }
+
     baranium_close_script(script);
     baranium_close_handle(handle);
 